@@ -2,23 +2,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
 #include <pthread.h>
-#include <wiringPi.h>
-
-static const int BCD_VALUES[10][4] = {
-    {0, 0, 0, 0},  // 0
-    {1, 0, 0, 0},  // 1
-    {0, 1, 0, 0},  // 2
-    {1, 1, 0, 0},  // 3
-    {0, 0, 1, 0},  // 4
-    {1, 0, 1, 0},  // 5
-    {0, 1, 1, 0},  // 6
-    {1, 1, 1, 0},  // 7
-    {0, 0, 0, 1},  // 8
-    {1, 0, 0, 1},  // 9
-};
-
-static pthread_t counting_thread;
+#include <sched.h>
+#include <time.h>
+#include "gpio_hal.h"
+#include "scheduler.h"
+
+#define FRAME_COLON         (1ULL << 32)
+#define REFRESH_PRIORITY    10          // SCHED_FIFO 우선순위 (권한이 없으면 일반 스레드로 동작)
+
 static bool is_counting = false;
 static bool is_initialized = false;
 static pthread_mutex_t counting_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -28,161 +23,553 @@ static int PIN_A = -1;
 static int PIN_B = -1;
 static int PIN_C = -1;
 static int PIN_D = -1;
+static int DIGIT_PINS[SEG7_MAX_DIGITS];
+static int COLON_PIN = -1;
+static int digit_count = 1;
+static int refresh_hz = SEG7_DEFAULT_REFRESH_HZ;
+static bool bulk_output = true;             // false면 핀마다 따로 쓴다
+
+// BCD 값(0-15)별 BCD 핀 set / clear 마스크 (핀 번호 비트). 값의 비트 0~3이 A~D 핀이다
+// (7447: 0-9는 숫자, 15는 꺼짐). seg7_init_multi에서 핀 번호로 미리 계산한다
+static uint64_t bcd_set_mask[16];
+static uint64_t bcd_clear_mask[16];
+static uint64_t all_pins_mask = 0;
+
+// 모든 핀(BCD, 자리 선택, 콜론)을 한 요청으로 잡아 gpio_write_mask 한 번에 함께 바꾼다
+static GpioLines* gpio_lines = NULL;
+
+// 프레임 버퍼: 자리 i의 BCD 값이 비트 4i부터 4비트씩, 콜론이 FRAME_COLON.
+// 한 번의 store로 바꾸므로 refresh 스레드는 이전 프레임이나 새 프레임 중 하나만 본다.
+static _Atomic uint64_t frame = 0;
+static pthread_t refresh_thread;
+static atomic_bool refresh_running = false;
+static _Atomic(Seg7RefreshHook) refresh_hook = NULL;
+
+// 카운트다운 상태 (counting_mutex로 보호). 1초 틱은 스케줄러 스레드의 타이머 콜백에서 처리한다
+static int count_value = 0;
+static CountdownCallback count_callback = NULL;
+static SchedTimerId tick_timer = 0;
+static uintptr_t count_generation = 0;  // 이전 카운트다운의 늦은 콜백을 구분
+static Seg7Format count_format = SEG7_FORMAT_AUTO;
+static Seg7Format count_display = SEG7_FORMAT_NUMBER;  // 진행 중인 카운트다운에 실제로 쓰는 형식
+
+static uint64_t pin_bit(int pin) {
+    return 1ULL << pin;
+}
 
-// 카운팅 스레드 파라미터 구조체
-typedef struct {
-    int start_seconds;
-    CountdownCallback callback;
-} CountingParams;
+// ---------------------------------------------------------------------------
+// GPIO 출력
+// ---------------------------------------------------------------------------
+// GPIO 쓰기 한 번 (set / clear는 핀 번호 비트마스크)
+static void write_mask(uint64_t set, uint64_t clear) {
+    gpio_write_mask(gpio_lines, set, clear);
+}
+
+// 핀 상태 바꾸기: bulk면 한 번, 아니면 핀마다 한 번씩
+static void write_pins(uint64_t set, uint64_t clear) {
+    if (bulk_output) {
+        write_mask(set, clear);
+        return;
+    }
+
+    for (uint64_t bits = set | clear; bits; bits &= bits - 1) {
+        uint64_t bit = bits & -bits;
+        write_mask(set & bit, clear & bit);
+    }
+}
 
 static void output_bcd(int num) {
-    if (num < 0 || num > 9) {
-        fprintf(stderr, "Invalid number: %d (must be 0-9)\n", num);
+    if (num < 0 || num > 15) {
+        fprintf(stderr, "Invalid number: %d (must be 0-15)\n", num);
         return;
     }
 
-    digitalWrite(PIN_A, BCD_VALUES[num][0]);
-    digitalWrite(PIN_B, BCD_VALUES[num][1]);
-    digitalWrite(PIN_C, BCD_VALUES[num][2]);
-    digitalWrite(PIN_D, BCD_VALUES[num][3]);
+    write_pins(bcd_set_mask[num], bcd_clear_mask[num]);
 }
 
-static void* counting_thread_func(void* arg) {
-    CountingParams* params = (CountingParams*)arg;
-    int current = params->start_seconds;
-    CountdownCallback callback = params->callback;
+// 다자리: 이전 자리를 끄고 BCD를 바꾼 뒤 새 자리를 켠다
+static void output_digit(int previous, int digit, int num) {
+    uint64_t set = bcd_set_mask[num] | pin_bit(DIGIT_PINS[digit]);
+    uint64_t clear = bcd_clear_mask[num] | pin_bit(DIGIT_PINS[previous]);
+
+    if (bulk_output) {
+        write_mask(set, clear);
+    } else {
+        // 핀마다 쓸 때는 순서가 중요하다: 이전 자리를 먼저 꺼야 다른 자리에 숫자가 비치지 않는다
+        write_pins(0, pin_bit(DIGIT_PINS[previous]));
+        write_pins(bcd_set_mask[num], bcd_clear_mask[num]);
+        write_pins(pin_bit(DIGIT_PINS[digit]), 0);
+    }
+}
 
-    free(params);
+static void output_all_low(void) {
+    write_pins(0, all_pins_mask);
+}
 
-    for (int i = current; i >= 0; i--) {
-        pthread_mutex_lock(&counting_mutex);
-        if (!is_counting) {
-            pthread_mutex_unlock(&counting_mutex);
-            return NULL;
+static void release_pins(void) {
+    gpio_release(gpio_lines);
+    gpio_lines = NULL;
+}
+
+static int frame_digit(uint64_t value, int digit) {
+    return (int)((value >> (4 * digit)) & 0xF);
+}
+
+// ---------------------------------------------------------------------------
+// 프레임 만들기 (오른쪽 정렬, 앞자리 0은 꺼짐)
+// ---------------------------------------------------------------------------
+static int max_number(void) {
+    int max = 1;
+    for (int i = 0; i < digit_count; i++) {
+        max *= 10;
+    }
+    return max - 1;
+}
+
+// mm:ss에서 분에 쓸 수 있는 가장 큰 값 (3자리 미만이면 -1)
+static int max_minutes(void) {
+    if (digit_count < 3) {
+        return -1;
+    }
+    int max = 1;
+    for (int i = 0; i < digit_count - 2; i++) {
+        max *= 10;
+    }
+    return max - 1;
+}
+
+static int max_count(Seg7Format format) {
+    int clock = max_minutes() < 0 ? 0 : max_minutes() * 60 + 59;
+
+    switch (format) {
+        case SEG7_FORMAT_NUMBER:
+            return max_number();
+        case SEG7_FORMAT_CLOCK:
+            return clock;
+        default:
+            return clock > max_number() ? clock : max_number();
+    }
+}
+
+// first ~ last 자리에 value를 오른쪽 정렬로 채운다
+static uint64_t render_digits(int value, int first, int last) {
+    uint64_t result = 0;
+
+    for (int digit = last; digit >= first; digit--) {
+        uint64_t nibble = (value > 0 || digit == last) ? (uint64_t)(value % 10) : SEG7_BLANK;
+        result |= nibble << (4 * digit);
+        value /= 10;
+    }
+    return result;
+}
+
+static uint64_t render_number(int value) {
+    return render_digits(value, 0, digit_count - 1);
+}
+
+static uint64_t render_clock(int minutes, int seconds) {
+    uint64_t result = FRAME_COLON | render_digits(minutes, 0, digit_count - 3);
+
+    result |= (uint64_t)(seconds / 10) << (4 * (digit_count - 2));
+    result |= (uint64_t)(seconds % 10) << (4 * (digit_count - 1));
+    return result;
+}
+
+// 프레임 교체. 한 자리면 refresh 스레드 없이 바로 출력한다
+static void present(uint64_t value) {
+    atomic_store(&frame, value);
+    if (digit_count == 1) {
+        output_bcd(frame_digit(value, 0));
+    }
+}
+
+static uint64_t render_count(int seconds) {
+    if (count_display == SEG7_FORMAT_CLOCK) {
+        return render_clock(seconds / 60, seconds % 60);
+    }
+    return render_number(seconds);
+}
+
+// ---------------------------------------------------------------------------
+// refresh 스레드 (2자리 이상): 자리마다 같은 시간만 켜지도록 절대 시각으로 잔다
+// ---------------------------------------------------------------------------
+static void* refresh_loop(void* arg) {
+    (void)arg;
+    uint64_t slot_ns = 1000000000ULL / (uint64_t)(refresh_hz * digit_count);
+    uint64_t deadline = scheduler_now_ns();
+    uint64_t current = 0;
+    int colon = -1;
+    int digit = 0;
+
+    while (atomic_load(&refresh_running)) {
+        struct timespec ts = {
+            .tv_sec = (time_t)(deadline / 1000000000ULL),
+            .tv_nsec = (long)(deadline % 1000000000ULL)
+        };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
         }
-        pthread_mutex_unlock(&counting_mutex);
 
-        output_bcd(i);
+        // 프레임은 한 바퀴를 시작할 때만 읽어 한 바퀴 안에 두 프레임이 섞이지 않는다
+        if (digit == 0) {
+            current = atomic_load(&frame);
+            int colon_on = (current & FRAME_COLON) != 0;
+            if (COLON_PIN >= 0 && colon_on != colon) {
+                write_pins(colon_on ? pin_bit(COLON_PIN) : 0, colon_on ? 0 : pin_bit(COLON_PIN));
+                colon = colon_on;
+            }
+        }
 
-        if (i > 0) {
-            sleep(1);
+        int value = frame_digit(current, digit);
+        output_digit((digit + digit_count - 1) % digit_count, digit, value);
+
+        Seg7RefreshHook hook = atomic_load(&refresh_hook);
+        if (hook) {
+            Seg7RefreshEvent event = {
+                .digit = digit,
+                .value = value,
+                .deadline_ns = deadline,
+                .timestamp_ns = scheduler_now_ns()
+            };
+            hook(&event);
+        }
+
+        digit = (digit + 1) % digit_count;
+        deadline += slot_ns;
+
+        // 한 슬롯 넘게 밀렸으면 몰아서 그리지 않고 지금부터 다시 맞춘다
+        uint64_t now = scheduler_now_ns();
+        if (now > deadline + slot_ns) {
+            deadline = now;
         }
     }
 
+    uint64_t digits = 0;
+    for (int i = 0; i < digit_count; i++) {
+        digits |= pin_bit(DIGIT_PINS[i]);
+    }
+    write_pins(0, digits);
+    return NULL;
+}
+
+static int start_refresh(void) {
+    pthread_attr_t attr;
+    struct sched_param param = { .sched_priority = REFRESH_PRIORITY };
+
+    atomic_store(&refresh_running, true);
+
+    // 실시간 우선순위로 먼저 시도하고, 권한이 없으면 일반 스레드로 만든다
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+    int result = pthread_create(&refresh_thread, &attr, refresh_loop, NULL);
+    pthread_attr_destroy(&attr);
+
+    if (result != 0) {
+        result = pthread_create(&refresh_thread, NULL, refresh_loop, NULL);
+    }
+    if (result != 0) {
+        atomic_store(&refresh_running, false);
+        fprintf(stderr, "Failed to create 7-segment refresh thread\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void stop_refresh(void) {
+    if (atomic_exchange(&refresh_running, false)) {
+        pthread_join(refresh_thread, NULL);
+    }
+}
+
+// 현재 숫자를 표시하고 1초 뒤 틱을 예약 (스케줄러 스레드)
+// 다음 틱은 이번 틱의 예약 시각 + 1초로 잡아 오차가 누적되지 않는다
+static void countdown_tick(void* arg, uint64_t deadline_ns) {
     pthread_mutex_lock(&counting_mutex);
+
+    if (!is_counting || (uintptr_t)arg != count_generation) {
+        pthread_mutex_unlock(&counting_mutex);
+        return;
+    }
+
+    present(render_count(count_value));
+
+    if (count_value > 0) {
+        count_value--;
+        tick_timer = scheduler_add(deadline_ns + 1000000000ULL, countdown_tick, arg);
+        if (tick_timer != 0) {
+            pthread_mutex_unlock(&counting_mutex);
+            return;
+        }
+        fprintf(stderr, "Failed to schedule countdown tick\n");
+    }
+
     is_counting = false;
+    CountdownCallback callback = count_callback;
     pthread_mutex_unlock(&counting_mutex);
 
     if (callback != NULL) {
         callback();
     }
-
-    return NULL;
 }
 
 int seg7_init(const Seg7Pins* pins) {
+    if (pins == NULL) {
+        fprintf(stderr, "Pins configuration is NULL\n");
+        return -1;
+    }
+
+    Seg7Config config = {
+        .bcd = *pins,
+        .digit_count = 1,
+        .colon_pin = -1
+    };
+    return seg7_init_multi(&config);
+}
+
+int seg7_init_multi(const Seg7Config* config) {
     if (is_initialized) {
         fprintf(stderr, "7-Segment already initialized\n");
         return 0;
     }
 
-    if (pins == NULL) {
+    if (config == NULL) {
         fprintf(stderr, "Pins configuration is NULL\n");
         return -1;
     }
 
+    if (config->digit_count < 1 || config->digit_count > SEG7_MAX_DIGITS) {
+        fprintf(stderr, "Invalid digit count: %d (must be 1-%d)\n",
+                config->digit_count, SEG7_MAX_DIGITS);
+        return -1;
+    }
+
+    if (config->refresh_hz < 0 || config->refresh_hz > SEG7_MAX_REFRESH_HZ) {
+        fprintf(stderr, "Invalid refresh rate: %d (must be 0-%d)\n",
+                config->refresh_hz, SEG7_MAX_REFRESH_HZ);
+        return -1;
+    }
+
+    // 핀은 64비트 마스크로 다루므로 0-63. 같은 핀을 두 번 쓰면 한 마스크에서 set과 clear가 겹치므로
+    // 지금까지 본 핀을 used에 모아 중복을 거부한다
+    uint64_t used = 0;
+    int bcd_pins[4] = { config->bcd.pin_a, config->bcd.pin_b, config->bcd.pin_c, config->bcd.pin_d };
+    for (int i = 0; i < 4; i++) {
+        if (bcd_pins[i] < 0 || bcd_pins[i] > 63) {
+            fprintf(stderr, "Invalid BCD pin %c: %d\n", 'A' + i, bcd_pins[i]);
+            return -1;
+        }
+        if (used & pin_bit(bcd_pins[i])) {
+            fprintf(stderr, "Duplicate BCD pin %c: %d\n", 'A' + i, bcd_pins[i]);
+            return -1;
+        }
+        used |= pin_bit(bcd_pins[i]);
+    }
+
+    for (int i = 0; config->digit_count > 1 && i < config->digit_count; i++) {
+        if (config->digit_pins[i] < 0 || config->digit_pins[i] > 63) {
+            fprintf(stderr, "Invalid digit pin %d: %d\n", i, config->digit_pins[i]);
+            return -1;
+        }
+        if (used & pin_bit(config->digit_pins[i])) {
+            fprintf(stderr, "Duplicate digit pin %d: %d\n", i, config->digit_pins[i]);
+            return -1;
+        }
+        used |= pin_bit(config->digit_pins[i]);
+    }
+
+    if (config->digit_count > 1 && config->colon_pin > 63) {
+        fprintf(stderr, "Invalid colon pin: %d\n", config->colon_pin);
+        return -1;
+    }
+    if (config->digit_count > 1 && config->colon_pin >= 0 && (used & pin_bit(config->colon_pin))) {
+        fprintf(stderr, "Duplicate colon pin: %d\n", config->colon_pin);
+        return -1;
+    }
+
     // GPIO 핀 번호 저장
-    PIN_A = pins->pin_a;
-    PIN_B = pins->pin_b;
-    PIN_C = pins->pin_c;
-    PIN_D = pins->pin_d;
+    PIN_A = config->bcd.pin_a;
+    PIN_B = config->bcd.pin_b;
+    PIN_C = config->bcd.pin_c;
+    PIN_D = config->bcd.pin_d;
+    digit_count = config->digit_count;
+    for (int i = 0; i < digit_count; i++) {
+        DIGIT_PINS[i] = digit_count > 1 ? config->digit_pins[i] : -1;
+    }
+    COLON_PIN = digit_count > 1 ? config->colon_pin : -1;
+    refresh_hz = config->refresh_hz > 0 ? config->refresh_hz : SEG7_DEFAULT_REFRESH_HZ;
+    bulk_output = (config->output == SEG7_OUTPUT_BULK);
+
+    // BCD 값별 마스크
+    for (int value = 0; value < 16; value++) {
+        bcd_set_mask[value] = 0;
+        bcd_clear_mask[value] = 0;
+        for (int i = 0; i < 4; i++) {
+            if (value & (1 << i)) {
+                bcd_set_mask[value] |= pin_bit(bcd_pins[i]);
+            } else {
+                bcd_clear_mask[value] |= pin_bit(bcd_pins[i]);
+            }
+        }
+    }
+    all_pins_mask = bcd_set_mask[15];
+    for (int i = 0; digit_count > 1 && i < digit_count; i++) {
+        all_pins_mask |= pin_bit(DIGIT_PINS[i]);
+    }
+    if (COLON_PIN >= 0) {
+        all_pins_mask |= pin_bit(COLON_PIN);
+    }
 
-    // wiringPi가 이미 초기화되었다고 가정
-    // 사용자가 main에서 wiringPiSetup()을 호출했어야 함
+    // gpio_init()이 이미 호출되었다고 가정 (핀 번호는 BCM)
 
     // GPIO 핀 설정
-    pinMode(PIN_A, OUTPUT);
-    pinMode(PIN_B, OUTPUT);
-    pinMode(PIN_C, OUTPUT);
-    pinMode(PIN_D, OUTPUT);
+    int pins[GPIO_MAX_LINES];
+    int count = 0;
+    for (uint64_t bits = all_pins_mask; bits; bits &= bits - 1) {
+        pins[count++] = __builtin_ctzll(bits);
+    }
 
-    // 모든 핀 LOW로 초기화
-    digitalWrite(PIN_A, LOW);
-    digitalWrite(PIN_B, LOW);
-    digitalWrite(PIN_C, LOW);
-    digitalWrite(PIN_D, LOW);
+    gpio_lines = gpio_request_output(pins, count);
+    if (gpio_lines == NULL) {
+        return -1;
+    }
+
+    // 모든 핀 LOW로 초기화 (한 자리는 0 표시)
+    output_all_low();
+    atomic_store(&frame, render_number(0));
+
+    if (scheduler_start() != 0) {
+        release_pins();
+        return -1;
+    }
+
+    if (digit_count > 1 && start_refresh() != 0) {
+        scheduler_stop();
+        release_pins();
+        return -1;
+    }
 
     is_initialized = true;
 
-    printf("7-Segment initialized (GPIO: A=%d, B=%d, C=%d, D=%d)\n",
-           PIN_A, PIN_B, PIN_C, PIN_D);
+    printf("7-Segment initialized (GPIO: A=%d, B=%d, C=%d, D=%d, digits=%d, refresh=%dHz, output=%s, backend=%s)\n",
+           PIN_A, PIN_B, PIN_C, PIN_D, digit_count, refresh_hz,
+           bulk_output ? "bulk" : "per-pin", gpio_backend());
 
     return 0;
 }
 
 int seg7_setnum(int num) {
+    return seg7_show_number(num);
+}
+
+int seg7_show_number(int value) {
     if (!is_initialized) {
         fprintf(stderr, "7-Segment not initialized. Call seg7_init() first.\n");
         return -1;
     }
 
-    if (num < 0 || num > 9) {
-        fprintf(stderr, "Invalid number: %d (must be 0-9)\n", num);
+    if (value < 0 || value > max_number()) {
+        fprintf(stderr, "Invalid number: %d (must be 0-%d)\n", value, max_number());
         return -1;
     }
 
-    output_bcd(num);
+    present(render_number(value));
     return 0;
 }
 
-int seg7_counting(int start_seconds, CountdownCallback callback) {
+int seg7_show_time(int minutes, int seconds) {
     if (!is_initialized) {
         fprintf(stderr, "7-Segment not initialized. Call seg7_init() first.\n");
         return -1;
     }
 
-    if (start_seconds < 0 || start_seconds > 9) {
-        fprintf(stderr, "Invalid start time: %d (must be 0-9)\n", start_seconds);
+    if (max_minutes() < 0) {
+        fprintf(stderr, "mm:ss needs at least 3 digits (have %d)\n", digit_count);
         return -1;
     }
 
-    pthread_mutex_lock(&counting_mutex);
+    if (minutes < 0 || minutes > max_minutes() || seconds < 0 || seconds > 59) {
+        fprintf(stderr, "Invalid time: %d:%02d (must be 0:00-%d:59)\n",
+                minutes, seconds, max_minutes());
+        return -1;
+    }
+
+    present(render_clock(minutes, seconds));
+    return 0;
+}
 
+int seg7_set_format(Seg7Format format) {
+    if (format < SEG7_FORMAT_AUTO || format > SEG7_FORMAT_CLOCK) {
+        fprintf(stderr, "Invalid countdown format: %d\n", (int)format);
+        return -1;
+    }
+
+    pthread_mutex_lock(&counting_mutex);
     if (is_counting) {
-        fprintf(stderr, "Counting already in progress\n");
         pthread_mutex_unlock(&counting_mutex);
+        fprintf(stderr, "Cannot change format while counting\n");
         return -1;
     }
+    count_format = format;
+    pthread_mutex_unlock(&counting_mutex);
 
-    is_counting = true;
+    return 0;
+}
+
+int seg7_max_count(void) {
+    pthread_mutex_lock(&counting_mutex);
+    int max = max_count(count_format);
     pthread_mutex_unlock(&counting_mutex);
 
-    CountingParams* params = (CountingParams*)malloc(sizeof(CountingParams));
-    if (params == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
-        pthread_mutex_lock(&counting_mutex);
-        is_counting = false;
+    return max;
+}
+
+int seg7_counting(int start_seconds, CountdownCallback callback) {
+    if (!is_initialized) {
+        fprintf(stderr, "7-Segment not initialized. Call seg7_init() first.\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&counting_mutex);
+
+    int max = max_count(count_format);
+    if (start_seconds < 0 || start_seconds > max) {
+        pthread_mutex_unlock(&counting_mutex);
+        fprintf(stderr, "Invalid start time: %d (must be 0-%d)\n", start_seconds, max);
+        return -1;
+    }
+
+    if (is_counting) {
+        fprintf(stderr, "Counting already in progress\n");
         pthread_mutex_unlock(&counting_mutex);
         return -1;
     }
 
-    params->start_seconds = start_seconds;
-    params->callback = callback;
+    // AUTO: 1분 이상이고 mm:ss로 들어가면 mm:ss
+    count_display = count_format;
+    if (count_format == SEG7_FORMAT_AUTO) {
+        bool clock = start_seconds >= 60 && start_seconds <= max_count(SEG7_FORMAT_CLOCK);
+        count_display = clock ? SEG7_FORMAT_CLOCK : SEG7_FORMAT_NUMBER;
+    }
 
-    if (pthread_create(&counting_thread, NULL, counting_thread_func, params) != 0) {
-        fprintf(stderr, "Failed to create counting thread\n");
-        free(params);
-        pthread_mutex_lock(&counting_mutex);
+    is_counting = true;
+    count_value = start_seconds;
+    count_callback = callback;
+    count_generation++;
+
+    // 첫 숫자를 바로 표시하도록 예약 (스레드를 만들지 않음)
+    tick_timer = scheduler_add(scheduler_now_ns(), countdown_tick, (void*)count_generation);
+    if (tick_timer == 0) {
+        fprintf(stderr, "Failed to schedule countdown\n");
         is_counting = false;
         pthread_mutex_unlock(&counting_mutex);
         return -1;
     }
 
-    pthread_detach(counting_thread);
+    pthread_mutex_unlock(&counting_mutex);
 
     return 0;
 }
-
 bool seg7_is_counting(void) {
     bool result;
     pthread_mutex_lock(&counting_mutex);
@@ -199,11 +586,12 @@ int seg7_stop_counting(void) {
         return 0;
     }
 
+    // 틱 콜백도 counting_mutex 안에서 확인하므로 반환 후에는 표시가 바뀌지 않는다
     is_counting = false;
+    scheduler_cancel(tick_timer);
+    tick_timer = 0;
     pthread_mutex_unlock(&counting_mutex);
 
-    usleep(100000);
-
     return 0;
 }
 
@@ -214,17 +602,21 @@ int seg7_wait_counting(void) {
     return 0;
 }
 
+void seg7_set_refresh_hook(Seg7RefreshHook hook) {
+    atomic_store(&refresh_hook, hook);
+}
+
 void seg7_cleanup(void) {
     if (!is_initialized) {
         return;
     }
 
     seg7_stop_counting();
+    stop_refresh();
+    scheduler_stop();
 
-    digitalWrite(PIN_A, LOW);
-    digitalWrite(PIN_B, LOW);
-    digitalWrite(PIN_C, LOW);
-    digitalWrite(PIN_D, LOW);
+    output_all_low();
+    release_pins();
 
     is_initialized = false;
 
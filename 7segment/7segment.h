@@ -2,6 +2,12 @@
 #define SEVEN_SEGMENT_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#define SEG7_MAX_DIGITS             8
+#define SEG7_DEFAULT_REFRESH_HZ     200     // 모든 자리를 한 번씩 그리는 횟수 (초당)
+#define SEG7_MAX_REFRESH_HZ         2000
+#define SEG7_BLANK                  15      // 7447에 BCD 15를 주면 모든 세그먼트가 꺼진다
 
 typedef void (*CountdownCallback)(void);
 
@@ -13,9 +19,59 @@ typedef struct {
     int pin_d;
 } Seg7Pins;
 
+// 핀 출력 방식
+typedef enum {
+    SEG7_OUTPUT_BULK,       // 바뀌는 핀을 set / clear 마스크로 한 번에 쓴다 (gpio_write_mask)
+    SEG7_OUTPUT_PER_PIN     // 핀마다 따로 쓴다 (기존 방식, 비교용)
+} Seg7Output;
+
+// 다자리 디스플레이: BCD 선(A-D)은 모든 자리가 공유하고 자리 선택 핀으로 한 번에 한 자리만 켠다.
+// 전용 refresh 스레드가 refresh_hz x digit_count 주기로 자리를 돌아가며 그린다.
+typedef struct {
+    Seg7Pins bcd;
+    int digit_count;                        // 1 ~ SEG7_MAX_DIGITS (1이면 자리 선택 없이 바로 출력)
+    int digit_pins[SEG7_MAX_DIGITS];        // 자리 선택 핀, 왼쪽 자리부터 (HIGH = 켜짐)
+    int colon_pin;                          // mm:ss 콜론 (-1 = 없음)
+    int refresh_hz;                         // 0 = SEG7_DEFAULT_REFRESH_HZ
+    Seg7Output output;
+} Seg7Config;
+
+// 카운트다운 표시 형식
+typedef enum {
+    SEG7_FORMAT_AUTO,       // 3자리 이상이고 60초 이상이면 mm:ss, 아니면 정수
+    SEG7_FORMAT_NUMBER,     // 남은 초를 정수로
+    SEG7_FORMAT_CLOCK       // 남은 시간을 mm:ss로 (3자리 이상)
+} Seg7Format;
+
+// refresh 스레드가 자리 하나를 그릴 때마다 기록되는 이벤트 (시각은 CLOCK_MONOTONIC ns)
+typedef struct {
+    int digit;                  // 0 = 왼쪽 자리
+    int value;                  // BCD 값 (SEG7_BLANK = 꺼짐)
+    uint64_t deadline_ns;       // 이 자리를 그리기로 예정된 시각
+    uint64_t timestamp_ns;      // 실제로 그린 시각
+} Seg7RefreshEvent;
+
+// refresh 스레드에서 호출 (오래 걸리면 다음 자리가 늦어진다)
+typedef void (*Seg7RefreshHook)(const Seg7RefreshEvent* event);
+
+// 단일 자리 (seg7_init_multi에 digit_count = 1을 준 것과 같음)
 int seg7_init(const Seg7Pins* pins);
 
+// gpio_init()을 먼저 호출해야 한다. 하드웨어 없이 확인하려면 gpio_init("sim") (쓰기 기록은 gpio_sim_set_hook)
+int seg7_init_multi(const Seg7Config* config);
+
+// 0 ~ 10^digit_count - 1 (앞자리 0은 꺼짐)
 int seg7_setnum(int num);
+int seg7_show_number(int value);
+
+// mm:ss (3자리 이상, seconds 0-59, minutes는 남은 자리에 들어가는 만큼)
+int seg7_show_time(int minutes, int seconds);
+
+// 카운트다운 표시 형식 (카운트다운 중이 아닐 때만)
+int seg7_set_format(Seg7Format format);
+
+// 현재 디스플레이와 형식으로 시작할 수 있는 가장 긴 카운트다운 (초)
+int seg7_max_count(void);
 
 int seg7_counting(int start_seconds, CountdownCallback callback);
 
@@ -25,6 +81,8 @@ int seg7_stop_counting(void);
 
 int seg7_wait_counting(void);
 
+void seg7_set_refresh_hook(Seg7RefreshHook hook);
+
 void seg7_cleanup(void);
 
 #endif // SEVEN_SEGMENT_H
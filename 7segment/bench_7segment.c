@@ -0,0 +1,239 @@
+// 다자리 7세그먼트 refresh 타이밍 벤치마크 (gpio_init("sim")으로 GPIO 없이 실행)
+// refresh 스레드가 자리 하나를 그릴 때마다 예정 시각 대비 늦은 정도와,
+// 연속한 두 자리 사이 간격이 슬롯 길이(1 / (refresh_hz x 자리 수))에서 벗어난 정도(jitter)를 잰다.
+// 측정하는 동안 카운트다운도 함께 돌려 프레임 교체가 refresh를 방해하지 않는지 확인한다.
+// 출력 방식(bulk = 마스크 한 번, per_pin = 핀마다)별로 1자리 숫자 갱신 속도와
+// 갱신 하나에 드는 GPIO 쓰기 수, 갱신 도중 잘못된 숫자가 보인 횟수(glitches)도 센다.
+// 쓰기 수와 glitches는 gpio_sim 훅으로 받은 쓰기 기록에서 핀 상태를 따라가며 센다.
+//
+// 출력 형식 (한 줄 = 한 측정):
+//   seg7_update output=<bulk|per_pin> updates=<n> updates_per_sec=<n> ops_per_update=<n> glitches=<n>
+//   seg7_refresh output=<bulk|per_pin> digits=<n> refresh_hz=<n> slots=<n> expected=<n> late_p50_us=<n> late_p99_us=<n> late_max_us=<n> jitter_p50_us=<n> jitter_p99_us=<n> ops_per_slot=<n> glitches=<n>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "7segment.h"
+#include "gpio_hal.h"
+#include "gpio_sim.h"
+#include "scheduler.h"
+
+#define DIGITS          4
+#define RUN_MS          2000
+#define MAX_EVENTS      32768
+#define UPDATES         1000000
+#define COLON_PIN       26
+#define DARK            (-1)    // 켜진 자리가 없음
+#define GHOST           (-2)    // 두 자리 이상이 함께 켜짐
+#define MAX_SHOWN       16
+
+static const int RATES[] = { 100, 200, 500, 1000 };
+static const int BCD_PINS[4] = { 14, 15, 18, 23 };
+static const int DIGIT_PINS[DIGITS] = { 5, 6, 13, 19 };
+
+// gpio_sim 훅이 따라가는 핀 상태와 갱신 하나(숫자 표시 한 번 또는 refresh 슬롯 하나) 동안 보인 값
+static pthread_mutex_t sim_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int sim_digits = 1;
+static uint64_t sim_levels;
+static int sim_from;                    // 진행 중인 갱신 전에 보이던 값
+static int sim_shown[MAX_SHOWN];        // 갱신 도중 쓰기마다 보인 값
+static int sim_shown_count;
+static uint64_t sim_updates;
+static uint64_t sim_operations;         // GPIO 쓰기 횟수 (마스크로 여러 핀을 함께 바꾸면 1회)
+static uint64_t sim_glitches;           // 갱신 도중 이전 값도 새 값도 아닌 숫자가 보인 횟수
+
+static uint64_t timestamps[MAX_EVENTS];
+static uint64_t late[MAX_EVENTS];
+static atomic_int event_count;
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// 지금 핀 상태로 보이는 값 (한 자리: BCD 값, 여러 자리: 자리 << 4 | BCD 값)
+static int visible(uint64_t levels) {
+    int value = 0;
+
+    for (int i = 0; i < 4; i++) {
+        if (levels & (1ULL << BCD_PINS[i])) {
+            value |= 1 << i;
+        }
+    }
+    if (sim_digits == 1) {
+        return value;
+    }
+
+    int shown = DARK;
+    for (int digit = 0; digit < sim_digits; digit++) {
+        if (levels & (1ULL << DIGIT_PINS[digit])) {
+            if (shown != DARK) {
+                return GHOST;
+            }
+            shown = (digit << 4) | value;
+        }
+    }
+    return shown;
+}
+
+// gpio_sim 훅 (쓰는 스레드에서 기록 순서대로 불림)
+static void gpio_hook(const GpioSimRecord* record, void* user_data) {
+    (void)user_data;
+    if (record->op != GPIO_SIM_OP_WRITE) {
+        return;
+    }
+
+    pthread_mutex_lock(&sim_mutex);
+    sim_levels = (sim_levels & ~record->clear) | record->set;
+    sim_operations++;
+    if (sim_shown_count < MAX_SHOWN) {
+        sim_shown[sim_shown_count++] = visible(sim_levels);
+    }
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+// 갱신 하나가 끝남: 도중에 보인 값 중 이전 값도 새 값도 아니고 꺼진 것도 아닌 것을 센다
+static void end_update(void) {
+    pthread_mutex_lock(&sim_mutex);
+    int to = visible(sim_levels);
+    for (int i = 0; i < sim_shown_count; i++) {
+        if (sim_shown[i] != sim_from && sim_shown[i] != to && sim_shown[i] != DARK) {
+            sim_glitches++;
+        }
+    }
+    sim_from = to;
+    sim_shown_count = 0;
+    sim_updates++;
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+static void reset_counts(int digits) {
+    pthread_mutex_lock(&sim_mutex);
+    sim_digits = digits;
+    sim_from = visible(sim_levels);
+    sim_shown_count = 0;
+    sim_updates = 0;
+    sim_operations = 0;
+    sim_glitches = 0;
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+static void refresh_hook(const Seg7RefreshEvent* event) {
+    end_update();
+
+    int i = atomic_load(&event_count);
+    if (i < MAX_EVENTS) {
+        timestamps[i] = event->timestamp_ns;
+        late[i] = event->timestamp_ns - event->deadline_ns;
+        atomic_store(&event_count, i + 1);
+    }
+}
+
+static const char* output_name(Seg7Output output) {
+    return output == SEG7_OUTPUT_BULK ? "bulk" : "per_pin";
+}
+
+// 1자리: 0-9를 돌아가며 표시
+static void bench_update(Seg7Output output) {
+    Seg7Config config = {
+        .bcd = { .pin_a = BCD_PINS[0], .pin_b = BCD_PINS[1], .pin_c = BCD_PINS[2], .pin_d = BCD_PINS[3] },
+        .digit_count = 1,
+        .colon_pin = -1,
+        .output = output
+    };
+
+    if (seg7_init_multi(&config) != 0) {
+        exit(EXIT_FAILURE);
+    }
+    reset_counts(1);
+
+    uint64_t start = scheduler_now_ns();
+    for (int i = 0; i < UPDATES; i++) {
+        seg7_show_number(i % 10);
+        end_update();
+    }
+    uint64_t elapsed = scheduler_now_ns() - start;
+
+    pthread_mutex_lock(&sim_mutex);
+    uint64_t updates = sim_updates;
+    uint64_t operations = sim_operations;
+    uint64_t glitches = sim_glitches;
+    pthread_mutex_unlock(&sim_mutex);
+    seg7_cleanup();
+
+    printf("seg7_update output=%s updates=%llu updates_per_sec=%.0f ops_per_update=%.2f glitches=%llu\n",
+           output_name(output), (unsigned long long)updates, UPDATES * 1e9 / elapsed,
+           (double)operations / updates, (unsigned long long)glitches);
+}
+
+static void bench_rate(Seg7Output output, int rate) {
+    Seg7Config config = {
+        .bcd = { .pin_a = BCD_PINS[0], .pin_b = BCD_PINS[1], .pin_c = BCD_PINS[2], .pin_d = BCD_PINS[3] },
+        .digit_count = DIGITS,
+        .digit_pins = { DIGIT_PINS[0], DIGIT_PINS[1], DIGIT_PINS[2], DIGIT_PINS[3] },
+        .colon_pin = COLON_PIN,
+        .refresh_hz = rate,
+        .output = output
+    };
+
+    atomic_store(&event_count, 0);
+    reset_counts(DIGITS);           // refresh 스레드가 시작하기 전에
+    seg7_set_refresh_hook(refresh_hook);
+    if (seg7_init_multi(&config) != 0) {
+        exit(EXIT_FAILURE);
+    }
+    seg7_counting(125, NULL);       // 2:05부터 mm:ss로 카운트다운
+
+    usleep(RUN_MS * 1000);
+
+    seg7_set_refresh_hook(NULL);
+    pthread_mutex_lock(&sim_mutex);
+    uint64_t operations = sim_operations;
+    uint64_t glitches = sim_glitches;
+    pthread_mutex_unlock(&sim_mutex);
+    seg7_cleanup();
+
+    // 첫 슬롯은 스레드 시작 시각이라 빼고 계산
+    int count = atomic_load(&event_count);
+    uint64_t slot_ns = 1000000000ULL / (uint64_t)(rate * DIGITS);
+    int n = count - 1;
+    uint64_t* jitter = malloc(sizeof(uint64_t) * (size_t)n);
+
+    for (int i = 0; i < n; i++) {
+        uint64_t interval = timestamps[i + 1] - timestamps[i];
+        jitter[i] = interval > slot_ns ? interval - slot_ns : slot_ns - interval;
+    }
+    qsort(late + 1, (size_t)n, sizeof(uint64_t), compare_u64);
+    qsort(jitter, (size_t)n, sizeof(uint64_t), compare_u64);
+
+    // 슬롯이 아닌 갱신(초기화, 콜론, 정리)은 몇 번뿐이라 슬롯 수로 나눈다
+    printf("seg7_refresh output=%s digits=%d refresh_hz=%d slots=%d expected=%d late_p50_us=%.1f late_p99_us=%.1f "
+           "late_max_us=%.1f jitter_p50_us=%.1f jitter_p99_us=%.1f ops_per_slot=%.2f glitches=%llu\n",
+           output_name(output), DIGITS, rate, count, rate * DIGITS * RUN_MS / 1000,
+           late[1 + n / 2] / 1000.0, late[1 + (int)(n * 0.99)] / 1000.0, late[n] / 1000.0,
+           jitter[n / 2] / 1000.0, jitter[(int)(n * 0.99)] / 1000.0,
+           (double)operations / count, (unsigned long long)glitches);
+    free(jitter);
+}
+
+int main(void) {
+    if (gpio_init("sim") != 0) {
+        return EXIT_FAILURE;
+    }
+    gpio_sim_set_hook(gpio_hook, NULL);
+
+    bench_update(SEG7_OUTPUT_PER_PIN);
+    bench_update(SEG7_OUTPUT_BULK);
+
+    for (size_t i = 0; i < sizeof(RATES) / sizeof(RATES[0]); i++) {
+        bench_rate(SEG7_OUTPUT_BULK, RATES[i]);
+    }
+    bench_rate(SEG7_OUTPUT_PER_PIN, RATES[sizeof(RATES) / sizeof(RATES[0]) - 1]);
+
+    gpio_sim_set_hook(NULL, NULL);
+    gpio_cleanup();
+    return 0;
+}
@@ -0,0 +1,376 @@
+// 부저 음표 시퀀서 벤치마크 (gpio_init("sim") 위의 softtone으로 GPIO 없이 실행)
+// 부저 출력 시각은 gpio_sim 훅으로 받은 톤 기록에서 잰다.
+// 1) 멜로디 타이밍: 한 곡을 끝까지 재생하며 음표마다 예정 시각 대비 늦은 정도와 곡 전체의 누적 오차(drift)
+// 2) 정지 지연: 재생 중 stop_music()을 호출한 시각부터 부저가 실제로 꺼진 시각까지
+//
+// 각 항목을 기존 방식(음표마다 delay()를 50ms 단위로 나눠 자며 should_stop 확인)을 흉내 낸
+// legacy 모드와 라이브러리(scheduler 모드)로 측정한다.
+//
+// 3) CPU 사용량: 음 출력 백엔드마다 대기 중 / 재생 중 프로세스 CPU 사용률 (한 코어 = 100%)
+//    인자가 없으면 sim GPIO 위의 softtone만 측정한다 (비교 기준).
+//    인자로 백엔드 이름을 주면 실제 GPIO로 다시 초기화해 그 백엔드를 측정한다 (GPIO가 필요하다).
+//    legacy는 기존 music_init처럼 wiringPi softTone 스레드(소리가 없어도 1ms마다 깨어남)를 계속 띄워 둔 상태를 흉내 낸다.
+//    GPIO 백엔드는 환경 변수 GPIO_BACKEND (기본 wiringpi).
+//      sudo ./bench_buzzer softtone pwm legacy
+//
+// 출력 형식 (한 줄 = 한 측정):
+//   buzzer_melody mode=<legacy|scheduler> notes=<n> tempo_ms=<n> late_p50_us=<n> late_p99_us=<n> drift_us=<n>
+//   buzzer_stop mode=<legacy|scheduler> trials=<n> stop_p50_us=<n> stop_p99_us=<n> stop_max_us=<n>
+//   buzzer_cpu backend=<name> gpio=<name> pin=<n> window_ms=<n> idle_cpu_pct=<n> play_cpu_pct=<n>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "buzzer.h"
+#include "gpio_hal.h"
+#include "gpio_sim.h"
+#include "scheduler.h"
+
+#define MELODY          MUSIC_SCHOOL_BELL
+#define MELODY_NOTES    32
+#define MELODY_TEMPO_MS 280
+#define STOP_TRIALS     20
+#define LEGACY_STEP_MS  50
+#define MAX_EVENTS      256
+#define BUZZER_PIN      21
+#define PWM_PIN         18              // pwm 백엔드는 하드웨어 PWM 핀만 가능
+#define CPU_WINDOW_MS   2000
+#define CPU_TONE_HZ     392
+
+static MusicToneEvent events[MAX_EVENTS];     // 부저 출력이 바뀐 시각 (deadline_ns는 쓰지 않음)
+static atomic_int event_count;
+static atomic_int playing;
+static uint64_t requested_ns;           // 재생을 요청한 시각 = 첫 음표의 예정 시각
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void record(int frequency, uint64_t timestamp_ns) {
+    int i = atomic_load(&event_count);
+    if (i < MAX_EVENTS) {
+        events[i].frequency = frequency;
+        events[i].timestamp_ns = timestamp_ns;
+        atomic_store(&event_count, i + 1);
+    }
+}
+
+// gpio_sim 훅 (톤을 쓴 스레드에서 불림)
+static void gpio_hook(const GpioSimRecord* r, void* user_data) {
+    (void)user_data;
+    if (r->op == GPIO_SIM_OP_TONE && r->pin == BUZZER_PIN) {
+        record(r->frequency_hz, scheduler_now_ns());
+    }
+}
+
+static void finish_callback(int music_number, int completed) {
+    (void)music_number;
+    (void)completed;
+    atomic_store(&playing, 0);
+}
+
+static void wait_finished(void) {
+    while (atomic_load(&playing)) {
+        usleep(1000);
+    }
+}
+
+// i번째 음표의 예정 시각 = 재생 요청 시각 + i x 템포
+static void report_melody(const char* mode) {
+    uint64_t late[MELODY_NOTES];
+    uint64_t start = requested_ns;
+    uint64_t tempo_ns = (uint64_t)MELODY_TEMPO_MS * 1000000ULL;
+
+    for (int i = 0; i < MELODY_NOTES; i++) {
+        late[i] = events[i].timestamp_ns - (start + (uint64_t)i * tempo_ns);
+    }
+
+    // 곡 끝(부저가 꺼진 시각)이 예정보다 얼마나 밀렸는지
+    long long drift = (long long)(events[MELODY_NOTES].timestamp_ns - start) -
+                      (long long)(MELODY_NOTES * tempo_ns);
+    qsort(late, MELODY_NOTES, sizeof(uint64_t), compare_u64);
+
+    printf("buzzer_melody mode=%s notes=%d tempo_ms=%d late_p50_us=%.1f late_p99_us=%.1f drift_us=%lld\n",
+           mode, MELODY_NOTES, MELODY_TEMPO_MS, late[MELODY_NOTES / 2] / 1000.0,
+           late[MELODY_NOTES - 1] / 1000.0, drift / 1000);
+}
+
+static void report_stop(const char* mode, uint64_t* latency) {
+    qsort(latency, STOP_TRIALS, sizeof(uint64_t), compare_u64);
+    printf("buzzer_stop mode=%s trials=%d stop_p50_us=%.1f stop_p99_us=%.1f stop_max_us=%.1f\n",
+           mode, STOP_TRIALS, latency[STOP_TRIALS / 2] / 1000.0,
+           latency[(int)(STOP_TRIALS * 0.99)] / 1000.0, latency[STOP_TRIALS - 1] / 1000.0);
+}
+
+// stop_ns 이후 처음 부저가 꺼진 시각까지 (softtone은 정지할 때 gpio_tone_stop으로 0을 한 번 더 쓴다)
+static uint64_t stop_latency(uint64_t stop_ns) {
+    int count = atomic_load(&event_count);
+
+    for (int i = 0; i < count; i++) {
+        if (events[i].frequency == 0 && events[i].timestamp_ns >= stop_ns) {
+            return events[i].timestamp_ns - stop_ns;
+        }
+    }
+    return 0;
+}
+
+// 시도마다 음표 안의 다른 위치에서 정지
+static unsigned int stop_delay_us(int trial) {
+    return 100000 + (unsigned int)(trial * 13000) % (MELODY_TEMPO_MS * 1000);
+}
+
+// ---------------------------------------------------------------------------
+// legacy: 기존 play_notes_interruptible과 같은 방식
+// ---------------------------------------------------------------------------
+static pthread_mutex_t legacy_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int legacy_stop = 0;
+
+static int legacy_check_stop(void) {
+    pthread_mutex_lock(&legacy_mutex);
+    int stop = legacy_stop;
+    pthread_mutex_unlock(&legacy_mutex);
+
+    if (stop) {
+        record(0, scheduler_now_ns());
+    }
+    return stop;
+}
+
+static void* legacy_thread(void* arg) {
+    (void)arg;
+    static const int notes[MELODY_NOTES] = {
+        392, 392, 440, 440, 392, 392, 329, 329, 392, 392, 329, 329, 293, 293, 293, 0,
+        392, 392, 440, 440, 392, 392, 329, 329, 392, 329, 293, 329, 261, 261, 261, 0
+    };
+
+    for (int i = 0; i < MELODY_NOTES; i++) {
+        if (legacy_check_stop()) {
+            goto done;
+        }
+        record(notes[i], scheduler_now_ns());
+
+        int remaining = MELODY_TEMPO_MS;
+        while (remaining > 0) {
+            int sleep_time = remaining > LEGACY_STEP_MS ? LEGACY_STEP_MS : remaining;
+            usleep((unsigned int)sleep_time * 1000);
+            remaining -= sleep_time;
+            if (legacy_check_stop()) {
+                goto done;
+            }
+        }
+    }
+    record(0, scheduler_now_ns());
+
+done:
+    atomic_store(&playing, 0);
+    return NULL;
+}
+
+static void legacy_start(void) {
+    pthread_t thread;
+
+    legacy_stop = 0;
+    atomic_store(&event_count, 0);
+    atomic_store(&playing, 1);
+    requested_ns = scheduler_now_ns();
+    pthread_create(&thread, NULL, legacy_thread, NULL);
+    pthread_detach(thread);
+}
+
+static void bench_legacy(void) {
+    uint64_t latency[STOP_TRIALS];
+
+    legacy_start();
+    wait_finished();
+    report_melody("legacy");
+
+    for (int i = 0; i < STOP_TRIALS; i++) {
+        legacy_start();
+        usleep(stop_delay_us(i));
+
+        uint64_t stop_ns = scheduler_now_ns();
+        pthread_mutex_lock(&legacy_mutex);
+        legacy_stop = 1;
+        pthread_mutex_unlock(&legacy_mutex);
+        wait_finished();
+
+        latency[i] = stop_latency(stop_ns);
+    }
+    report_stop("legacy", latency);
+}
+
+// ---------------------------------------------------------------------------
+// scheduler: buzzer 라이브러리
+// ---------------------------------------------------------------------------
+static void library_start(void) {
+    atomic_store(&event_count, 0);
+    atomic_store(&playing, 1);
+    requested_ns = scheduler_now_ns();
+    if (play_music_async(MELODY) != 0) {
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void bench_library(void) {
+    uint64_t latency[STOP_TRIALS];
+
+    library_start();
+    wait_finished();
+    report_melody("scheduler");
+
+    for (int i = 0; i < STOP_TRIALS; i++) {
+        library_start();
+        usleep(stop_delay_us(i));
+
+        uint64_t stop_ns = scheduler_now_ns();
+        stop_music();
+        wait_finished();
+
+        latency[i] = stop_latency(stop_ns);
+    }
+    report_stop("scheduler", latency);
+}
+
+// ---------------------------------------------------------------------------
+// cpu: 백엔드별 대기 / 재생 중 CPU 사용률
+// ---------------------------------------------------------------------------
+static uint64_t process_cpu_ns(void) {
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+           (uint64_t)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
+// CPU_WINDOW_MS 동안 잠들어 있는 사이 다른 스레드가 쓴 CPU (%)
+static double measure_cpu_pct(void) {
+    uint64_t wall_start = scheduler_now_ns();
+    uint64_t cpu_start = process_cpu_ns();
+
+    usleep(CPU_WINDOW_MS * 1000);
+
+    uint64_t cpu = process_cpu_ns() - cpu_start;
+    uint64_t wall = scheduler_now_ns() - wall_start;
+    return cpu * 100.0 / wall;
+}
+
+static void report_cpu(const char* backend, int pin, double idle, double play) {
+    printf("buzzer_cpu backend=%s gpio=%s pin=%d window_ms=%d idle_cpu_pct=%.2f play_cpu_pct=%.2f\n",
+           backend, gpio_backend(), pin, CPU_WINDOW_MS, idle, play);
+}
+
+// 기존 music_init: 시작할 때 wiringPi softTone 스레드를 만들고 종료할 때까지 유지.
+// softTone은 소리가 없어도 1ms마다 깨어나 주파수를 확인하므로 그 루프를 그대로 흉내 낸다
+static atomic_int legacy_tone_hz;
+static atomic_int legacy_tone_running;
+
+static void* legacy_tone_loop(void* arg) {
+    GpioLines* lines = arg;
+    uint64_t bit = 1ULL << BUZZER_PIN;
+
+    while (atomic_load(&legacy_tone_running)) {
+        int hz = atomic_load(&legacy_tone_hz);
+        if (hz == 0) {
+            usleep(1000);
+            continue;
+        }
+        unsigned int half_us = 500000u / (unsigned int)hz;
+        gpio_write_mask(lines, bit, 0);
+        usleep(half_us);
+        gpio_write_mask(lines, 0, bit);
+        usleep(half_us);
+    }
+    return NULL;
+}
+
+static void bench_cpu_legacy(void) {
+    int pin = BUZZER_PIN;
+    pthread_t thread;
+    GpioLines* lines = gpio_request_output(&pin, 1);
+    if (lines == NULL) {
+        return;
+    }
+
+    atomic_store(&legacy_tone_hz, 0);
+    atomic_store(&legacy_tone_running, 1);
+    if (pthread_create(&thread, NULL, legacy_tone_loop, lines) != 0) {
+        gpio_release(lines);
+        return;
+    }
+
+    double idle = measure_cpu_pct();
+    atomic_store(&legacy_tone_hz, CPU_TONE_HZ);
+    double play = measure_cpu_pct();
+    atomic_store(&legacy_tone_running, 0);
+    pthread_join(thread, NULL);
+    gpio_release(lines);
+
+    report_cpu("legacy", BUZZER_PIN, idle, play);
+}
+
+static void bench_cpu(const char* backend) {
+    int pin = strcmp(backend, "pwm") == 0 ? PWM_PIN : BUZZER_PIN;
+
+    if (music_set_backend(backend) != 0 || music_init(pin) != 0) {
+        return;
+    }
+    music_set_finish_callback(finish_callback);
+
+    double idle = measure_cpu_pct();
+
+    atomic_store(&playing, 1);
+    if (play_music_async(MELODY) != 0) {
+        music_cleanup();
+        return;
+    }
+    double play = measure_cpu_pct();
+    stop_music();
+    wait_finished();
+
+    music_cleanup();
+    report_cpu(backend, pin, idle, play);
+}
+
+int main(int argc, char* argv[]) {
+    static char* default_backends[] = { "softtone" };
+    char** backends = argc > 1 ? &argv[1] : default_backends;
+    int backend_count = argc > 1 ? argc - 1 : 1;
+
+    // 멜로디 / 정지 측정은 항상 sim GPIO 위에서
+    if (gpio_init("sim") != 0 || music_set_backend("softtone") != 0 || music_init(BUZZER_PIN) != 0) {
+        return EXIT_FAILURE;
+    }
+    gpio_sim_set_hook(gpio_hook, NULL);
+    music_set_finish_callback(finish_callback);
+
+    bench_legacy();
+    bench_library();
+
+    gpio_sim_set_hook(NULL, NULL);
+    music_cleanup();
+
+    // 백엔드를 지정했으면 실제 GPIO로 다시 초기화
+    if (argc > 1) {
+        gpio_cleanup();
+        if (gpio_init(NULL) != 0) {
+            fprintf(stderr, "GPIO initialization failed (run as root on a Pi)\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (int i = 0; i < backend_count; i++) {
+        if (strcmp(backends[i], "legacy") == 0) {
+            bench_cpu_legacy();
+        } else {
+            bench_cpu(backends[i]);
+        }
+    }
+    gpio_cleanup();
+    return 0;
+}
@@ -1,127 +1,502 @@
 #include "buzzer.h"
-#include <wiringPi.h>
-#include <softTone.h>
+#include "tone_backend.h"
 #include <stdio.h>
 #include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "scheduler.h"
 
-// 음계 정의
-#define DO      261.63
-#define RE      293.66
-#define MI      329.63
-#define FA      349.23
-#define SOL     391.00
-#define LA      440.00
-#define SI      493.88
-#define DO_H    523.25
+// 음계 정의 (0.1Hz 단위)
+#define DO      2616
+#define RE      2937
+#define MI      3296
+#define FA      3492
+#define SOL     3910
+#define LA      4400
+#define SI      4939
+#define DO_H    5233
 #define REST    0
 
-static int school_bell[] = {
-    SOL, SOL, LA, LA, SOL, SOL, MI, MI,
-    SOL, SOL, MI, MI, RE, RE, RE, REST,
-    SOL, SOL, LA, LA, SOL, SOL, MI, MI,
-    SOL, MI, RE, MI, DO, DO, DO, REST
+#define BACKEND_ENV "BUZZER_BACKEND"
+
+#define ARRAY_SIZE(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+_Static_assert(sizeof(MelodyFileHeader) == 32, "MelodyFileHeader must be 32 bytes");
+_Static_assert(sizeof(MelodyNote) == 4, "MelodyNote must be 4 bytes");
+
+// 내장 곡 (멜로디 파일이 없어도 재생 가능)
+#define N(f) { f, 280 }
+static const MelodyNote school_bell[] = {
+    N(SOL), N(SOL), N(LA), N(LA), N(SOL), N(SOL), N(MI), N(MI),
+    N(SOL), N(SOL), N(MI), N(MI), N(RE), N(RE), N(RE), N(REST),
+    N(SOL), N(SOL), N(LA), N(LA), N(SOL), N(SOL), N(MI), N(MI),
+    N(SOL), N(MI), N(RE), N(MI), N(DO), N(DO), N(DO), N(REST)
 };
-static int school_bell_length = 32;
-
-static int twinkle_star[] = {
-    DO, DO, SOL, SOL, LA, LA, SOL, REST,
-    FA, FA, MI, MI, RE, RE, DO, REST,
-    SOL, SOL, FA, FA, MI, MI, RE, REST,
-    SOL, SOL, FA, FA, MI, MI, RE, REST,
-    DO, DO, SOL, SOL, LA, LA, SOL, REST,
-    FA, FA, MI, MI, RE, RE, DO, REST
+
+static const MelodyNote twinkle_star[] = {
+    N(DO), N(DO), N(SOL), N(SOL), N(LA), N(LA), N(SOL), N(REST),
+    N(FA), N(FA), N(MI), N(MI), N(RE), N(RE), N(DO), N(REST),
+    N(SOL), N(SOL), N(FA), N(FA), N(MI), N(MI), N(RE), N(REST),
+    N(SOL), N(SOL), N(FA), N(FA), N(MI), N(MI), N(RE), N(REST),
+    N(DO), N(DO), N(SOL), N(SOL), N(LA), N(LA), N(SOL), N(REST),
+    N(FA), N(FA), N(MI), N(MI), N(RE), N(RE), N(DO), N(REST)
 };
-static int twinkle_star_length = 48;
 
-static int happy_birthday[] = {
-    SOL, SOL, LA, SOL, DO_H, SI, REST,
-    SOL, SOL, LA, SOL, RE, DO_H, REST,
-    SOL, SOL, SOL, MI, DO_H, SI, LA, REST,
-    FA, FA, MI, DO_H, RE, DO_H, REST
+static const MelodyNote butterfly[] = {
+    N(DO), N(RE), N(MI), N(FA), N(MI), N(RE), N(DO), N(REST),
+    N(MI), N(FA), N(SOL), N(SOL), N(MI), N(FA), N(SOL), N(SOL),
+    N(DO_H), N(SOL), N(MI), N(SOL), N(FA), N(MI), N(RE), N(DO),
+    N(DO), N(RE), N(MI), N(FA), N(MI), N(RE), N(DO), N(REST)
 };
-static int happy_birthday_length = 28;
+#undef N
+
+#define N(f) { f, 350 }
+static const MelodyNote happy_birthday[] = {
+    N(SOL), N(SOL), N(LA), N(SOL), N(DO_H), N(SI), N(REST),
+    N(SOL), N(SOL), N(LA), N(SOL), N(RE), N(DO_H), N(REST),
+    N(SOL), N(SOL), N(SOL), N(MI), N(DO_H), N(SI), N(LA), N(REST),
+    N(FA), N(FA), N(MI), N(DO_H), N(RE), N(DO_H), N(REST)
+};
+#undef N
+
+// 카탈로그 항목. 파일에서 읽은 곡의 notes는 mmap한 영역을 그대로 가리킨다
+typedef struct {
+    int id;
+    char name[MUSIC_NAME_SIZE];
+    const MelodyNote* notes;
+    int note_count;
+    int builtin;
+    void* map;                  // 내장 곡은 NULL
+    size_t map_size;
+} Melody;
 
-static int butterfly[] = {
-    DO, RE, MI, FA, MI, RE, DO, REST,
-    MI, FA, SOL, SOL, MI, FA, SOL, SOL,
-    DO_H, SOL, MI, SOL, FA, MI, RE, DO,
-    DO, RE, MI, FA, MI, RE, DO, REST
+static const Melody builtin_melodies[] = {
+    { MUSIC_SCHOOL_BELL, "school_bell", school_bell, ARRAY_SIZE(school_bell), 1, NULL, 0 },
+    { MUSIC_TWINKLE_STAR, "twinkle_star", twinkle_star, ARRAY_SIZE(twinkle_star), 1, NULL, 0 },
+    { MUSIC_HAPPY_BIRTHDAY, "happy_birthday", happy_birthday, ARRAY_SIZE(happy_birthday), 1, NULL, 0 },
+    { MUSIC_BUTTERFLY, "butterfly", butterfly, ARRAY_SIZE(butterfly), 1, NULL, 0 }
 };
-static int butterfly_length = 32;
 
 static int initialized = 0;
 static int SPKR = -1;
+static const ToneBackend* backend = NULL;
+static const ToneBackend* requested_backend = NULL;    // music_set_backend로 지정 (NULL = 자동)
 
-static pthread_t music_thread;
 static pthread_mutex_t music_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t music_done = PTHREAD_COND_INITIALIZER;
 static int is_playing = 0;
 static int should_stop = 0;
+static MusicFinishCallback finish_callback = NULL;
+static MusicToneHook tone_hook = NULL;
 
-typedef struct {
-    int* notes;
-    int length;
-    int tempo;
-} MusicData;
+// 카탈로그 (music_mutex로 보호). id_slot[곡 번호] = catalog 인덱스 + 1 (0 = 없음)
+static Melody catalog[MUSIC_MAX_MELODIES];
+static int catalog_count = 0;
+static unsigned char id_slot[MUSIC_MAX_ID + 1];
+static int catalog_ready = 0;
 
+// 재생 상태 (music_mutex로 보호). 음표 전환은 스케줄러 스레드의 타이머 콜백에서 처리한다
+static int current_number = 0;
+static const MelodyNote* current_notes = NULL;
+static int current_count = 0;
+static int note_index = 0;
+static uint64_t play_start_ns = 0;
+static uint64_t play_offset_ns = 0;     // 재생 시작부터 다음 음표까지
+static SchedTimerId note_timer = 0;
+static uintptr_t play_generation = 0;   // 이전 재생의 늦은 콜백을 구분
 
-static int play_notes_interruptible(int* notes, int length, int tempo)
+// 부저 출력 (music_mutex를 잡은 상태로 호출, 주파수는 0.1Hz 단위)
+static void tone_write(int frequency_dhz, uint64_t deadline_ns)
 {
-    for (int i = 0; i < length; i++) {
-        pthread_mutex_lock(&music_mutex);
-        if (should_stop) {
-            softToneWrite(SPKR, 0);
-            pthread_mutex_unlock(&music_mutex);
-            return -1; // 중단됨
-        }
-        pthread_mutex_unlock(&music_mutex);
+    backend->write(frequency_dhz);
 
-        softToneWrite(SPKR, notes[i]);
-        
-        int delay_step = 50; // 50ms 단위로 체크
-        int remaining = tempo;
-        
-        while (remaining > 0) {
-            int sleep_time = (remaining > delay_step) ? delay_step : remaining;
-            delay(sleep_time);
-            remaining -= sleep_time;
-            
-            pthread_mutex_lock(&music_mutex);
-            if (should_stop) {
-                softToneWrite(SPKR, 0);
-                pthread_mutex_unlock(&music_mutex);
-                return -1; // 중단됨
-            }
-            pthread_mutex_unlock(&music_mutex);
-        }
+    if (tone_hook) {
+        MusicToneEvent event = {
+            .frequency = (frequency_dhz + 5) / 10,
+            .deadline_ns = deadline_ns,
+            .timestamp_ns = scheduler_now_ns()
+        };
+        tone_hook(&event);
     }
-    
-    softToneWrite(SPKR, 0);
-    return 0; // 정상 완료
 }
 
-static void* music_playback_thread(void* arg)
+// 재생 종료 처리 (music_mutex를 잡은 상태로 호출, 반환 시 잠금 해제)
+static void finish_playback(int completed)
 {
-    MusicData* data = (MusicData*)arg;
-
-    printf("[Buzzer] Music playback started\n");
-    int result = play_notes_interruptible(data->notes, data->length, data->tempo);
-
-    pthread_mutex_lock(&music_mutex);
+    tone_write(0, 0);
+    backend->stop();
     is_playing = 0;
     should_stop = 0;
+    note_timer = 0;
+    int music_number = current_number;
+    MusicFinishCallback callback = finish_callback;
+    pthread_cond_broadcast(&music_done);
     pthread_mutex_unlock(&music_mutex);
 
-    if (result == 0) {
+    if (completed) {
         printf("[Buzzer] Music playback completed normally\n");
     } else {
         printf("[Buzzer] Music playback stopped\n");
     }
 
-    free(data);
+    // 재생 상태를 정리한 뒤 호출 (콜백에서 바로 다음 곡을 재생할 수 있음)
+    if (callback) {
+        callback(music_number, completed);
+    }
+}
+
+// 음표 하나를 내고 다음 음표를 예약 (스케줄러 스레드)
+// 다음 음표 시각은 재생 시작 시각 + 지금까지의 음표 길이 합으로 계산해 오차가 누적되지 않는다
+static void note_tick(void* arg, uint64_t deadline_ns)
+{
+    pthread_mutex_lock(&music_mutex);
+
+    if (!is_playing || (uintptr_t)arg != play_generation) {
+        pthread_mutex_unlock(&music_mutex);
+        return;
+    }
+
+    if (should_stop) {
+        finish_playback(0);
+        return;
+    }
+
+    if (note_index == current_count) {
+        finish_playback(1);
+        return;
+    }
+
+    if (note_index == 0) {
+        printf("[Buzzer] Music playback started\n");
+    }
+
+    const MelodyNote* note = &current_notes[note_index];
+    tone_write(note->frequency_dhz, deadline_ns);
+    play_offset_ns += (uint64_t)note->duration_ms * 1000000ULL;
+    note_index++;
+
+    note_timer = scheduler_add(play_start_ns + play_offset_ns, note_tick, arg);
+    if (note_timer == 0) {
+        finish_playback(0);
+        return;
+    }
+
+    pthread_mutex_unlock(&music_mutex);
+}
+
+// ---------------------------------------------------------------------------
+// 카탈로그 (music_mutex를 잡은 상태에서만 호출)
+// ---------------------------------------------------------------------------
+static void catalog_reset(void)
+{
+    for (int i = 0; i < catalog_count; i++) {
+        if (catalog[i].map) {
+            munmap(catalog[i].map, catalog[i].map_size);
+        }
+    }
+
+    memset(id_slot, 0, sizeof(id_slot));
+    catalog_count = 0;
+    for (int i = 0; i < ARRAY_SIZE(builtin_melodies); i++) {
+        catalog[catalog_count] = builtin_melodies[i];
+        id_slot[catalog[catalog_count].id] = (unsigned char)(catalog_count + 1);
+        catalog_count++;
+    }
+    catalog_ready = 1;
+}
+
+static const Melody* catalog_get(int music_number)
+{
+    if (!catalog_ready) {
+        catalog_reset();
+    }
+    if (music_number < 1 || music_number > MUSIC_MAX_ID || id_slot[music_number] == 0) {
+        return NULL;
+    }
+    return &catalog[id_slot[music_number] - 1];
+}
+
+static int catalog_find(const char* name)
+{
+    if (!catalog_ready) {
+        catalog_reset();
+    }
+    for (int i = 0; i < catalog_count; i++) {
+        if (strcasecmp(catalog[i].name, name) == 0) {
+            return catalog[i].id;
+        }
+    }
+    return -1;
+}
+
+// 이름은 프로토콜에서 토큰으로 쓰므로 영문자, 숫자, '_', '-'만 허용
+static int valid_name(const char* name, size_t size)
+{
+    size_t len = strnlen(name, size);
+
+    if (len == 0 || len == size) {
+        return 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '_' && name[i] != '-') {
+            return 0;
+        }
+    }
+    return !isdigit((unsigned char)name[0]);
+}
+
+static const char* validate_melody(const void* data, size_t size)
+{
+    const MelodyFileHeader* header = (const MelodyFileHeader*)data;
+
+    if (size < sizeof(MelodyFileHeader) || memcmp(header->magic, MELODY_MAGIC, 4) != 0) {
+        return "not a melody file";
+    }
+    if (header->id < 1 || header->id > MUSIC_MAX_ID) {
+        return "invalid id";
+    }
+    if (!valid_name(header->name, sizeof(header->name))) {
+        return "invalid name";
+    }
+    if (header->note_count == 0 ||
+        size != sizeof(MelodyFileHeader) + (size_t)header->note_count * sizeof(MelodyNote)) {
+        return "size does not match note count";
+    }
+
+    const MelodyNote* notes = (const MelodyNote*)(header + 1);
+    for (int i = 0; i < header->note_count; i++) {
+        if (notes[i].duration_ms == 0) {
+            return "zero-length note";
+        }
+    }
     return NULL;
 }
 
+// 파일 하나를 mmap해 카탈로그에 추가. 성공 시 0
+static int catalog_load_file(const char* path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "[Buzzer] Cannot open melody %s\n", path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    if (size < sizeof(MelodyFileHeader)) {
+        close(fd);
+        fprintf(stderr, "[Buzzer] Skipping %s: not a melody file\n", path);
+        return -1;
+    }
+
+    // 재생 중 페이지 폴트가 나지 않도록 미리 읽어 둔다
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[Buzzer] Cannot map melody %s\n", path);
+        return -1;
+    }
+
+    const MelodyFileHeader* header = (const MelodyFileHeader*)map;
+    const char* error = validate_melody(map, size);
+    int existing = error ? 0 : id_slot[header->id];
+    int same_name = error ? -1 : catalog_find(header->name);
+
+    if (!error && existing && !catalog[existing - 1].builtin) {
+        error = "duplicate id";
+    } else if (!error && same_name > 0 && same_name != header->id) {
+        error = "duplicate name";
+    } else if (!error && !existing && catalog_count == MUSIC_MAX_MELODIES) {
+        error = "catalog full";
+    }
+
+    if (error) {
+        fprintf(stderr, "[Buzzer] Skipping %s: %s\n", path, error);
+        munmap(map, size);
+        return -1;
+    }
+
+    // 같은 번호의 내장 곡은 파일로 대체
+    int index = existing ? existing - 1 : catalog_count++;
+    Melody* melody = &catalog[index];
+    melody->id = header->id;
+    memcpy(melody->name, header->name, sizeof(melody->name));
+    melody->notes = (const MelodyNote*)(header + 1);
+    melody->note_count = header->note_count;
+    melody->builtin = 0;
+    melody->map = map;
+    melody->map_size = size;
+    id_slot[melody->id] = (unsigned char)(index + 1);
+
+    printf("[Buzzer] Loaded melody %d '%s' (%d notes) from %s\n",
+           melody->id, melody->name, melody->note_count, path);
+    return 0;
+}
+
+static int is_melody_file(const struct dirent* entry)
+{
+    size_t len = strlen(entry->d_name);
+    size_t ext = strlen(MELODY_FILE_EXT);
+
+    return len > ext && strcmp(entry->d_name + len - ext, MELODY_FILE_EXT) == 0;
+}
+
+static void fill_info(const Melody* melody, MusicInfo* info)
+{
+    unsigned int duration = 0;
+
+    for (int i = 0; i < melody->note_count; i++) {
+        duration += melody->notes[i].duration_ms;
+    }
+
+    info->id = melody->id;
+    info->name = melody->name;
+    info->note_count = melody->note_count;
+    info->duration_ms = duration;
+    info->builtin = melody->builtin;
+}
+
+int music_load_dir(const char* path)
+{
+    struct dirent** entries;
+    int count = scandir(path, &entries, is_melody_file, alphasort);
+
+    if (count < 0) {
+        fprintf(stderr, "[Buzzer] Cannot open melody directory %s\n", path);
+        return -1;
+    }
+
+    pthread_mutex_lock(&music_mutex);
+
+    int loaded = -1;
+    if (is_playing) {
+        fprintf(stderr, "[Buzzer] Cannot load melodies while music is playing\n");
+    } else {
+        if (!catalog_ready) {
+            catalog_reset();
+        }
+
+        loaded = 0;
+        for (int i = 0; i < count; i++) {
+            char file[PATH_MAX];
+            snprintf(file, sizeof(file), "%s/%s", path, entries[i]->d_name);
+            if (catalog_load_file(file) == 0) {
+                loaded++;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&music_mutex);
+
+    for (int i = 0; i < count; i++) {
+        free(entries[i]);
+    }
+    free(entries);
+    return loaded;
+}
+
+int music_find(const char* name)
+{
+    if (name == NULL) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&music_mutex);
+    int id = catalog_find(name);
+    pthread_mutex_unlock(&music_mutex);
+
+    return id;
+}
+
+int music_get_info(int music_number, MusicInfo* info)
+{
+    pthread_mutex_lock(&music_mutex);
+    const Melody* melody = catalog_get(music_number);
+    if (melody && info) {
+        fill_info(melody, info);
+    }
+    pthread_mutex_unlock(&music_mutex);
+
+    return melody ? 0 : -1;
+}
+
+int music_list(MusicInfo* infos, int max)
+{
+    int count = 0;
+
+    pthread_mutex_lock(&music_mutex);
+    if (!catalog_ready) {
+        catalog_reset();
+    }
+    for (int id = 1; id <= MUSIC_MAX_ID; id++) {
+        if (id_slot[id] == 0) {
+            continue;
+        }
+        if (infos && count < max) {
+            fill_info(&catalog[id_slot[id] - 1], &infos[count]);
+        }
+        count++;
+    }
+    pthread_mutex_unlock(&music_mutex);
+
+    return count;
+}
+
+int music_set_backend(const char* name)
+{
+    const ToneBackend* found = NULL;
+
+    if (initialized) {
+        fprintf(stderr, "Cannot change buzzer backend after music_init()\n");
+        return -1;
+    }
+
+    if (name != NULL) {
+        found = tone_backend_find(name);
+        if (found == NULL) {
+            fprintf(stderr, "Unknown buzzer backend: %s\n", name);
+            return -1;
+        }
+    }
+
+    requested_backend = found;
+    return 0;
+}
+
+const char* music_get_backend(void)
+{
+    return backend ? backend->name : NULL;
+}
+
+// 백엔드 선택: music_set_backend > BUZZER_BACKEND > softtone
+static const ToneBackend* select_backend(void)
+{
+    const char* name = getenv(BACKEND_ENV);
+
+    if (requested_backend) {
+        return requested_backend;
+    }
+    if (name != NULL && *name != '\0') {
+        const ToneBackend* found = tone_backend_find(name);
+        if (found == NULL) {
+            fprintf(stderr, "Unknown buzzer backend: %s\n", name);
+        }
+        return found;
+    }
+    return &tone_backend_softtone;
+}
+
 int music_init(int speaker_pin)
 {
     if (initialized) {
@@ -133,15 +508,28 @@ int music_init(int speaker_pin)
         return -1;
     }
 
+    const ToneBackend* selected = select_backend();
+    if (selected == NULL) {
+        return -1;
+    }
+    if (!selected->supports_pin(speaker_pin)) {
+        fprintf(stderr, "Buzzer backend %s cannot drive GPIO %d\n", selected->name, speaker_pin);
+        return -1;
+    }
+
     SPKR = speaker_pin;
+    if (selected->init(SPKR) != 0) {
+        return -1;
+    }
 
-    if (softToneCreate(SPKR) != 0) {
-        fprintf(stderr, "softTone 초기화 실패\n");
+    if (scheduler_start() != 0) {
+        selected->cleanup();
         return -1;
     }
 
+    backend = selected;
     initialized = 1;
-    printf("Buzzer initialized (GPIO pin: %d)\n", SPKR);
+    printf("Buzzer initialized (GPIO pin: %d, backend: %s)\n", SPKR, backend->name);
     return 0;
 }
 
@@ -150,16 +538,23 @@ void music_cleanup(void)
     if (initialized) {
         stop_music(); 
         
+        // 재생 중이었으면 종료 처리가 끝날 때까지 대기
         pthread_mutex_lock(&music_mutex);
-        int playing = is_playing;
+        while (is_playing) {
+            pthread_cond_wait(&music_done, &music_mutex);
+        }
         pthread_mutex_unlock(&music_mutex);
         
-        if (playing) {
-            pthread_join(music_thread, NULL);
-        }
+        scheduler_stop();
+        backend->cleanup();
+        
+        // 파일에서 읽은 곡을 내리고 내장 곡만 남긴다
+        pthread_mutex_lock(&music_mutex);
+        catalog_reset();
+        pthread_mutex_unlock(&music_mutex);
         
-        softToneWrite(SPKR, 0);
         initialized = 0;
+        backend = NULL;
         printf("Buzzer cleaned up\n");
     }
 }
@@ -180,59 +575,57 @@ int play_music_async(int music_number)
         return -1;
     }
     
-    MusicData* data = (MusicData*)malloc(sizeof(MusicData));
-    if (!data) {
+    const Melody* melody = catalog_get(music_number);
+    if (melody == NULL) {
         pthread_mutex_unlock(&music_mutex);
+        fprintf(stderr, "잘못된 음악 번호: %d\n", music_number);
         return -1;
     }
     
-    // 음악 데이터 설정
-    switch(music_number) {
-        case MUSIC_SCHOOL_BELL:
-            data->notes = school_bell;
-            data->length = school_bell_length;
-            data->tempo = 280;
-            break;
-        case MUSIC_TWINKLE_STAR:
-            data->notes = twinkle_star;
-            data->length = twinkle_star_length;
-            data->tempo = 280;
-            break;
-        case MUSIC_HAPPY_BIRTHDAY:
-            data->notes = happy_birthday;
-            data->length = happy_birthday_length;
-            data->tempo = 350;
-            break;
-        case MUSIC_BUTTERFLY:
-            data->notes = butterfly;
-            data->length = butterfly_length;
-            data->tempo = 280;
-            break;
-        default:
-            free(data);
-            pthread_mutex_unlock(&music_mutex);
-            fprintf(stderr, "잘못된 음악 번호: %d\n", music_number);
-            return -1;
-    }
-    
+    // 재생 중에는 카탈로그(mmap 영역)를 바꾸지 않으므로 포인터만 잡아 둔다 (할당 없음)
+    current_number = melody->id;
+    current_notes = melody->notes;
+    current_count = melody->note_count;
     is_playing = 1;
     should_stop = 0;
+    note_index = 0;
+    play_offset_ns = 0;
+    play_generation++;
+    
+    // 재생 준비 (스레드는 만들지 않음: softtone의 톤 스레드는 music_init에서 이미 만들어 둠)
+    if (backend->start() != 0) {
+        is_playing = 0;
+        pthread_mutex_unlock(&music_mutex);
+        return -1;
+    }
+    play_start_ns = scheduler_now_ns();
     
-    // 스레드 생성
-    if (pthread_create(&music_thread, NULL, music_playback_thread, data) != 0) {
+    // 첫 음표를 바로 예약 (스레드를 만들지 않음)
+    note_timer = scheduler_add(play_start_ns, note_tick, (void*)play_generation);
+    if (note_timer == 0) {
         is_playing = 0;
-        free(data);
+        backend->stop();
         pthread_mutex_unlock(&music_mutex);
-        fprintf(stderr, "Failed to create music thread\n");
+        fprintf(stderr, "Failed to schedule music playback\n");
         return -1;
     }
     
-    pthread_detach(music_thread); // 자동 정리
     pthread_mutex_unlock(&music_mutex);
     
     return 0;
 }
 
+int play_music_by_name(const char* name)
+{
+    int music_number = music_find(name);
+
+    if (music_number < 0) {
+        fprintf(stderr, "Unknown melody: %s\n", name ? name : "(null)");
+        return -1;
+    }
+    return play_music_async(music_number);
+}
+
 int stop_music(void)
 {
     pthread_mutex_lock(&music_mutex);
@@ -243,6 +636,17 @@ int stop_music(void)
     }
     
     should_stop = 1;
+    
+    // 다음 음표를 기다리는 중이면 바로 종료 처리하도록 타이머를 당긴다
+    // (취소에 실패했으면 스케줄러 스레드가 note_tick을 실행 중이므로 거기서 should_stop을 본다)
+    if (scheduler_cancel(note_timer) == 0) {
+        note_timer = scheduler_add(0, note_tick, (void*)play_generation);
+        if (note_timer == 0) {
+            // 예약하지 못하면 note_tick이 다시 불리지 않으므로 여기서 바로 종료 처리 (잠금도 해제됨)
+            finish_playback(0);
+            return 0;
+        }
+    }
     pthread_mutex_unlock(&music_mutex);
     
     return 0;
@@ -256,3 +660,17 @@ int is_music_playing(void)
     
     return playing;
 }
+
+void music_set_finish_callback(MusicFinishCallback callback)
+{
+    pthread_mutex_lock(&music_mutex);
+    finish_callback = callback;
+    pthread_mutex_unlock(&music_mutex);
+}
+
+void music_set_tone_hook(MusicToneHook hook)
+{
+    pthread_mutex_lock(&music_mutex);
+    tone_hook = hook;
+    pthread_mutex_unlock(&music_mutex);
+}
@@ -1,15 +1,84 @@
 #ifndef BUZZER_H
 #define BUZZER_H
 
+#include <stdint.h>
+
 #define MUSIC_SCHOOL_BELL       1
 #define MUSIC_TWINKLE_STAR      2
 #define MUSIC_HAPPY_BIRTHDAY    3
 #define MUSIC_BUTTERFLY         4
 
+#define MUSIC_MAX_MELODIES      64      // 카탈로그 크기 (내장 곡 포함)
+#define MUSIC_MAX_ID            255
+#define MUSIC_NAME_SIZE         24      // NUL 포함
+
+// 멜로디 파일 (.mel, little-endian). 헤더 뒤에 MelodyNote가 note_count개 이어진다.
+// 파일 크기는 정확히 sizeof(MelodyFileHeader) + note_count * sizeof(MelodyNote)여야 한다.
+#define MELODY_MAGIC            "MEL1"
+#define MELODY_FILE_EXT         ".mel"
+
+typedef struct {
+    char magic[4];                      // MELODY_MAGIC
+    uint16_t id;                        // 1 ~ MUSIC_MAX_ID (내장 곡과 같으면 내장 곡을 대체)
+    uint16_t note_count;
+    char name[MUSIC_NAME_SIZE];         // NUL 종료, 남는 바이트는 0
+} MelodyFileHeader;
+
+typedef struct {
+    uint16_t frequency_dhz;             // 0.1Hz 단위 (0 = 쉼표)
+    uint16_t duration_ms;
+} MelodyNote;
+
+// 카탈로그 항목 정보 (name은 music_cleanup 전까지 유효)
+typedef struct {
+    int id;
+    const char* name;
+    int note_count;
+    unsigned int duration_ms;           // 곡 전체 길이
+    int builtin;                        // 1 = 라이브러리 내장 곡
+} MusicInfo;
+
+// 재생이 끝나면 스케줄러 스레드에서 호출 (completed: 1 = 끝까지 재생, 0 = stop_music으로 중단)
+typedef void (*MusicFinishCallback)(int music_number, int completed);
+
+// 부저 출력이 바뀔 때마다 기록되는 이벤트 (시각은 CLOCK_MONOTONIC ns)
+typedef struct {
+    int frequency;              // 0 = 소리 끔
+    uint64_t deadline_ns;       // 이 출력이 예정되어 있던 시각 (정지 / 종료 처리는 0)
+    uint64_t timestamp_ns;      // 실제로 출력한 시각
+} MusicToneEvent;
+
+// 스케줄러 스레드에서 호출 (music_mutex를 잡은 상태이므로 다른 buzzer 함수를 부르면 안 됨)
+typedef void (*MusicToneHook)(const MusicToneEvent* event);
+
+// 음 출력 백엔드 ("softtone", "pwm"). music_init 전에만 바꿀 수 있다 (NULL = 자동 선택)
+// 자동 선택: 환경 변수 BUZZER_BACKEND > "softtone"
+// - softtone: 초기화할 때 톤 스레드를 한 번 만들고 소리가 없으면 잠재운다 (gpio_tone_*, 대기 중 CPU 사용 없음)
+// - pwm: 하드웨어 PWM (BCM 12, 13, 18, 19만 가능, 재생 중에도 CPU 사용 없음)
+// GPIO 없이 타이밍을 확인하려면 gpio_init("sim") 뒤에 softtone으로 초기화한다 (gpio_sim_set_hook으로 톤 변경 확인)
+int music_set_backend(const char* name);
+const char* music_get_backend(void);    // 초기화 전이면 NULL
+
 int music_init(int speaker_pin);
 void music_cleanup(void);
 int play_music_async(int music_number);
+int play_music_by_name(const char* name);
 int stop_music(void);
 int is_music_playing(void);
+void music_set_finish_callback(MusicFinishCallback callback);
+void music_set_tone_hook(MusicToneHook hook);
+
+// 디렉토리의 *.mel 파일을 읽기 전용으로 mmap해 카탈로그에 추가한다 (재생 중이 아닐 때만).
+// 읽은 파일 수를 반환, 디렉토리를 열 수 없으면 -1. 잘못된 파일은 경고만 출력하고 건너뛴다
+int music_load_dir(const char* path);
+
+// 이름으로 곡 번호 찾기 (대소문자 무시). 없으면 -1
+int music_find(const char* name);
+
+// 곡 번호로 정보 조회. 없으면 -1
+int music_get_info(int music_number, MusicInfo* info);
+
+// 카탈로그를 곡 번호 순으로 최대 max개 복사하고 전체 곡 수를 반환
+int music_list(MusicInfo* infos, int max);
 
 #endif
@@ -0,0 +1,184 @@
+// 멜로디 컴파일러: 텍스트 악보를 .mel 파일로 변환
+//
+// 사용법: melc <input.txt> <output.mel>
+//
+// 악보 형식 ('#' 뒤는 주석, 공백/줄바꿈으로 구분):
+//   id 5                   곡 번호 (1-255, 내장 곡 번호와 같으면 내장 곡을 대체)
+//   name ode_to_joy        곡 이름 (영문자, 숫자, '_', '-', 23자 이하)
+//   tempo 300              길이를 생략한 음표의 기본 길이 (ms, 기본 280)
+//   MI MI FA SOL           음이름: DO RE MI FA SOL LA SI DO_H RE_H MI_H, 쉼표는 REST
+//   RE:150 440.0:500       ':' 뒤는 음표 길이 (ms), 음이름 대신 주파수(Hz)도 가능
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include "buzzer.h"
+
+#define MAX_NOTES       4096
+#define DEFAULT_TEMPO   280
+
+typedef struct {
+    const char* name;
+    double frequency;
+} NoteName;
+
+static const NoteName NOTE_NAMES[] = {
+    { "DO", 261.63 },
+    { "RE", 293.66 },
+    { "MI", 329.63 },
+    { "FA", 349.23 },
+    { "SOL", 391.00 },
+    { "LA", 440.00 },
+    { "SI", 493.88 },
+    { "DO_H", 523.25 },
+    { "RE_H", 587.33 },
+    { "MI_H", 659.26 },
+    { "REST", 0.0 }
+};
+
+static MelodyNote notes[MAX_NOTES];
+
+static const char* input_path;
+static int line_number;
+
+static void fail(const char* message, const char* token) {
+    fprintf(stderr, "%s:%d: %s: %s\n", input_path, line_number, message, token);
+    exit(EXIT_FAILURE);
+}
+
+static int parse_number(const char* token, long min, long max) {
+    char* end;
+    long value = strtol(token, &end, 10);
+
+    if (*token == '\0' || *end != '\0' || value < min || value > max) {
+        fail("invalid number", token);
+    }
+    return (int)value;
+}
+
+// "SOL", "SOL:150", "440.0:500"
+static MelodyNote parse_note(char* token, int tempo) {
+    MelodyNote note;
+    char* colon = strchr(token, ':');
+    double frequency = -1.0;
+
+    note.duration_ms = (uint16_t)tempo;
+    if (colon) {
+        *colon = '\0';
+        note.duration_ms = (uint16_t)parse_number(colon + 1, 1, 65535);
+    }
+
+    for (size_t i = 0; i < sizeof(NOTE_NAMES) / sizeof(NOTE_NAMES[0]); i++) {
+        if (strcasecmp(token, NOTE_NAMES[i].name) == 0) {
+            frequency = NOTE_NAMES[i].frequency;
+            break;
+        }
+    }
+
+    if (frequency < 0.0) {
+        char* end;
+        frequency = strtod(token, &end);
+        if (*token == '\0' || *end != '\0' || frequency < 0.0 || frequency > 6553.5) {
+            fail("unknown note", token);
+        }
+    }
+
+    note.frequency_dhz = (uint16_t)(frequency * 10.0 + 0.5);
+    return note;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input.txt> <output.mel>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    input_path = argv[1];
+    FILE* in = fopen(input_path, "r");
+    if (!in) {
+        perror(input_path);
+        return EXIT_FAILURE;
+    }
+
+    MelodyFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MELODY_MAGIC, 4);
+
+    int tempo = DEFAULT_TEMPO;
+    int count = 0;
+    char line[1024];
+
+    while (fgets(line, sizeof(line), in)) {
+        line_number++;
+
+        char* comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+
+        char* token = strtok(line, " \t\r\n");
+        while (token) {
+            if (strcmp(token, "id") == 0 || strcmp(token, "name") == 0 ||
+                strcmp(token, "tempo") == 0) {
+                char* value = strtok(NULL, " \t\r\n");
+                if (!value) {
+                    fail("missing value", token);
+                }
+
+                if (strcmp(token, "id") == 0) {
+                    header.id = (uint16_t)parse_number(value, 1, MUSIC_MAX_ID);
+                } else if (strcmp(token, "tempo") == 0) {
+                    tempo = parse_number(value, 1, 65535);
+                } else {
+                    size_t len = strlen(value);
+                    if (len >= sizeof(header.name) || isdigit((unsigned char)value[0])) {
+                        fail("invalid name", value);
+                    }
+                    for (size_t i = 0; i < len; i++) {
+                        if (!isalnum((unsigned char)value[i]) && value[i] != '_' && value[i] != '-') {
+                            fail("invalid name", value);
+                        }
+                    }
+                    memcpy(header.name, value, len);
+                }
+            } else {
+                if (count == MAX_NOTES) {
+                    fail("too many notes", token);
+                }
+                notes[count++] = parse_note(token, tempo);
+            }
+
+            token = strtok(NULL, " \t\r\n");
+        }
+    }
+    fclose(in);
+
+    if (header.id == 0 || header.name[0] == '\0' || count == 0) {
+        fprintf(stderr, "%s: id, name and at least one note are required\n", input_path);
+        return EXIT_FAILURE;
+    }
+    header.note_count = (uint16_t)count;
+
+    FILE* out = fopen(argv[2], "wb");
+    if (!out) {
+        perror(argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    if (fwrite(&header, sizeof(header), 1, out) != 1 ||
+        fwrite(notes, sizeof(MelodyNote), (size_t)count, out) != (size_t)count ||
+        fclose(out) != 0) {
+        perror(argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    unsigned long duration = 0;
+    for (int i = 0; i < count; i++) {
+        duration += notes[i].duration_ms;
+    }
+    printf("%s: id %d '%s', %d notes, %lu ms, %zu bytes\n", argv[2], header.id, header.name,
+           count, duration, sizeof(header) + (size_t)count * sizeof(MelodyNote));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include "tone_backend.h"
+#include "gpio_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+// 부저 음 출력 백엔드 (GPIO는 gpio_hal로)
+// - softtone: HAL의 소프트웨어 톤 스레드. init에서 한 번만 만들고 재생 시작 / 정지는 주파수만 바꾼다
+//   (주파수가 0이면 스레드가 조건 변수에서 잠들어 대기 중에는 CPU를 쓰지 않는다).
+// - pwm: BCM 12, 13, 18, 19의 하드웨어 PWM으로 파형을 만든다 (재생 중에도 CPU 사용 없음).
+//   주기를 음 높이에 맞추고 duty 50%로 출력한다. wiringpi 백엔드에서는 PWM 범위가 두 채널에
+//   함께 적용되므로 다른 하드웨어 PWM 사용자(예: LED)와 동시에 쓸 수 없다.
+// 하드웨어 없이 확인할 때는 gpio_init("sim") 위에서 softtone을 쓴다 (톤 변경이 gpio_sim에 기록됨).
+
+static int tone_pin = -1;
+
+// ---------------------------------------------------------------------------
+// softtone
+// ---------------------------------------------------------------------------
+static int softtone_supports_pin(int pin) {
+    return pin >= 0;
+}
+
+static int softtone_init(int pin) {
+    if (gpio_tone_start(pin) != 0) {
+        fprintf(stderr, "softTone 초기화 실패\n");
+        return -1;
+    }
+    tone_pin = pin;
+    return 0;
+}
+
+static int softtone_start(void) {
+    return 0;
+}
+
+static void softtone_write(int frequency_dhz) {
+    gpio_tone_write(tone_pin, (frequency_dhz + 5) / 10);
+}
+
+static void softtone_stop(void) {
+    gpio_tone_write(tone_pin, 0);
+}
+
+static void softtone_cleanup(void) {
+    gpio_tone_stop(tone_pin);
+}
+
+const ToneBackend tone_backend_softtone = {
+    .name = "softtone",
+    .supports_pin = softtone_supports_pin,
+    .init = softtone_init,
+    .start = softtone_start,
+    .write = softtone_write,
+    .stop = softtone_stop,
+    .cleanup = softtone_cleanup
+};
+
+// ---------------------------------------------------------------------------
+// pwm
+// ---------------------------------------------------------------------------
+static int pwm_supports_pin(int pin) {
+    return gpio_pwm_supported(pin);
+}
+
+static int pwm_init(int pin) {
+    if (!pwm_supports_pin(pin)) {
+        fprintf(stderr, "GPIO %d has no hardware PWM (use 12, 13, 18 or 19)\n", pin);
+        return -1;
+    }
+    if (gpio_pwm_setup(pin) != 0) {
+        return -1;
+    }
+
+    tone_pin = pin;
+    gpio_pwm_set(tone_pin, 0, 0);
+    return 0;
+}
+
+static int pwm_start(void) {
+    return 0;
+}
+
+static void pwm_write(int frequency_dhz) {
+    if (frequency_dhz <= 0) {
+        gpio_pwm_set(tone_pin, 0, 0);
+        return;
+    }
+
+    // 주기 (ns) = 10^10 / (0.1Hz 단위 주파수)
+    uint32_t period_ns = (uint32_t)((10000000000ULL + (uint64_t)frequency_dhz / 2) / (uint64_t)frequency_dhz);
+    gpio_pwm_set(tone_pin, period_ns, period_ns / 2);
+}
+
+static void pwm_stop(void) {
+    gpio_pwm_set(tone_pin, 0, 0);
+}
+
+static void pwm_cleanup(void) {
+    gpio_pwm_release(tone_pin);
+}
+
+const ToneBackend tone_backend_pwm = {
+    .name = "pwm",
+    .supports_pin = pwm_supports_pin,
+    .init = pwm_init,
+    .start = pwm_start,
+    .write = pwm_write,
+    .stop = pwm_stop,
+    .cleanup = pwm_cleanup
+};
+
+static const ToneBackend* const BACKENDS[] = {
+    &tone_backend_softtone,
+    &tone_backend_pwm
+};
+
+const ToneBackend* tone_backend_find(const char* name) {
+    for (size_t i = 0; i < sizeof(BACKENDS) / sizeof(BACKENDS[0]); i++) {
+        if (strcmp(BACKENDS[i]->name, name) == 0) {
+            return BACKENDS[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,23 @@
+#ifndef TONE_BACKEND_H
+#define TONE_BACKEND_H
+
+// 부저 음 출력 백엔드 (buzzer 라이브러리 내부용)
+// 주파수는 0.1Hz 단위 (0 = 소리 끔).
+// init / cleanup은 music_init / music_cleanup에서, 나머지는 music_mutex를 잡은 상태에서 호출된다.
+typedef struct {
+    const char* name;
+    int (*supports_pin)(int pin);       // 이 핀에서 쓸 수 있으면 1
+    int (*init)(int pin);               // 성공 시 0
+    int (*start)(void);                 // 재생을 시작하기 전 (성공 시 0)
+    void (*write)(int frequency_dhz);
+    void (*stop)(void);                 // 재생이 끝난 뒤 (소리는 이미 꺼진 상태)
+    void (*cleanup)(void);
+} ToneBackend;
+
+extern const ToneBackend tone_backend_softtone;    // gpio_tone_* 소프트웨어 톤 (스레드는 init에서 한 번, 대기 중에는 잠듦)
+extern const ToneBackend tone_backend_pwm;         // 하드웨어 PWM (CPU 사용 없음, PWM 핀만)
+
+// 이름으로 백엔드 찾기 (없으면 NULL)
+const ToneBackend* tone_backend_find(const char* name);
+
+#endif
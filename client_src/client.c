@@ -92,6 +92,10 @@ static void print_menu(void) {
     printf("7. SENSOR OFF (감시 종료)\n");
     printf("8. SEGMENT DISPLAY (숫자 표시 후 카운트다운)\n");
     printf("9. SEGMENT STOP (카운트다운 중단)\n");
+    printf("10. SUBSCRIBE EVENTS (1:LED 2:Buzzer 4:Segment 8:Sensor 합, 0:해제)\n");
+    printf("11. STATUS (디바이스 상태 조회)\n");
+    printf("12. SENSOR HISTORY (최근 N초 조도 통계)\n");
+    printf("13. MUSIC LIST (재생할 수 있는 곡 목록)\n");
     printf("0. Exit\n");
     printf("Select: ");
     fflush(stdout);
@@ -143,7 +147,27 @@ void client_run(ClientState* client) {
                     } else if (choice == 8) {
                         // Segment Display - 파라미터 필요 없음 (서버에서 요청)
                         client_send_command(client, choice, 0, 0);
-                    } else if (choice >= 1 && choice <= 9) {
+                    } else if (choice == 10) {
+                        // 이벤트 구독 - 서버가 묻지 않으므로 여기서 마스크 입력
+                        printf("Enter event mask (0-15): ");
+                        fflush(stdout);
+                        if (scanf("%d", &param1) != 1) {
+                            while (getchar() != '\n');
+                            printf("Invalid input\n");
+                            continue;
+                        }
+                        client_send_command(client, choice, param1, 0);
+                    } else if (choice == 12) {
+                        // 센서 기록 조회 - 조회할 구간 길이 입력
+                        printf("Enter window seconds (1-604800): ");
+                        fflush(stdout);
+                        if (scanf("%d", &param1) != 1) {
+                            while (getchar() != '\n');
+                            printf("Invalid input\n");
+                            continue;
+                        }
+                        client_send_command(client, choice, param1, 0);
+                    } else if ((choice >= 1 && choice <= 9) || choice == 11 || choice == 13) {
                         // 다른 명령들
                         client_send_command(client, choice, param1, param2);
                     } else {
@@ -151,15 +175,15 @@ void client_run(ClientState* client) {
                     }
 
                 } else if (strstr(buffer, "Enter") != NULL) {
-                    // 추가 입력 요청 (brightness, music number, countdown seconds)
-                    int param;
-                    if (scanf("%d", &param) != 1) {
+                    // 추가 입력 요청 (brightness, music number or name, countdown seconds)
+                    char param[64];
+                    if (scanf("%63s", param) != 1) {
                         while (getchar() != '\n');
                         printf("Invalid input\n");
                         continue;
                     }
 
-                    snprintf(buffer, sizeof(buffer), "%d\n", param);
+                    snprintf(buffer, sizeof(buffer), "%s\n", param);
                     send(client->socket_fd, buffer, strlen(buffer), 0);
                 }
 
@@ -0,0 +1,884 @@
+// 다중 연결 부하 생성기 / 지연 벤치마크
+// 서버를 바꿀 때마다 같은 조건으로 처리량과 명령 종류별 왕복 지연을 재기 위한 도구.
+// - 연결 N개를 워커 스레드들이 나눠 각자의 epoll로 돌린다.
+// - 명령 구성(mix)을 가중치대로 섞어 보낸다. 연결마다 시드에서 나온 난수열을 쓰므로 같은 시드면 같은 순서다.
+// - closed-loop (기본): 연결마다 depth개의 명령을 유지하고, 응답이 오면 바로 다음 명령을 보낸다.
+//   open-loop (-r): 전체 목표 rate를 워커의 연결 수 비율로 나눠 고정 간격으로 보낸다. 지연은 예정 시각부터 재므로
+//   서버가 밀려 보내지 못한 시간도 지연에 들어간다 (coordinated omission 보정).
+// - 요청 ID(텍스트 "@id", 바이너리 request_id)로 응답을 짝짓는다. 서버는 요청 ID % MAX_INFLIGHT 슬롯에
+//   완료를 기다리므로 슬롯이 빈 ID만 쓴다.
+// - 워밍업 뒤 측정 구간에 보낸 명령만 센다 (구간이 끝난 뒤 도착한 응답도 포함).
+//
+// 사용법: loadgen [options] [host]   (loadgen --help)
+// 출력 형식:
+//   loadgen mode=<closed|open> protocol=<text|binary> conns=<n> threads=<n> depth=<n> rate=<n> warmup_s=<n> duration_s=<n>
+//           cmds=<n> errors=<n> unanswered=<n> cmds_per_sec=<n>
+//   loadgen_cmd type=<mix 항목> cmds=<n> errors=<n> p50_us=<n> p99_us=<n> p999_us=<n> max_us=<n>   (항목마다, 마지막은 type=all)
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "client.h"
+
+#define MAX_INFLIGHT                64          // 서버의 연결당 완료 슬롯 수
+#define MAX_MIX                     16
+#define MIX_LABEL_SIZE              32
+#define RECV_BUFFER_SIZE            16384
+#define SEND_BUFFER_SIZE            4096
+#define MAX_EVENTS                  256
+#define HANDSHAKE_TIMEOUT_NS        5000000000ULL
+#define DRAIN_TIMEOUT_NS            2000000000ULL
+
+// 서버 프로토콜 (server_src/server.h와 같은 값)
+#define BINARY_MAGIC                "RSVPBIN1"
+#define BINARY_MAGIC_LEN            8
+#define BINARY_COMMAND_FRAME_SIZE   16
+#define BINARY_RESPONSE_FRAME_SIZE  12
+#define BINARY_EVENT_FRAME_SIZE     20
+#define BINARY_EVENT_ID             0xFFFFFFFFu
+
+#define DEFAULT_CONNECTIONS         8
+#define DEFAULT_DURATION_S          10
+#define DEFAULT_WARMUP_S            1
+#define DEFAULT_MIX                 "status:40,led_on:20,led_off:20,brightness:10,music_list:10"
+
+// 보낼 수 있는 명령 (프롬프트가 뜨지 않도록 파라미터가 필요한 명령은 기본값을 준다)
+typedef struct {
+    const char* name;
+    int type;
+    int param1;
+} CommandSpec;
+
+static const CommandSpec COMMANDS[] = {
+    { "led_on", 1, 0 },
+    { "led_off", 2, 0 },
+    { "brightness", 3, 2 },
+    { "buzzer_on", 4, 1 },
+    { "buzzer_off", 5, 0 },
+    { "sensor_on", 6, 0 },
+    { "sensor_off", 7, 0 },
+    { "segment", 8, 10 },
+    { "segment_stop", 9, 0 },
+    { "subscribe", 10, 15 },
+    { "status", 11, 0 },
+    { "history", 12, 10 },
+    { "music_list", 13, 0 }
+};
+
+typedef struct {
+    char label[MIX_LABEL_SIZE];
+    int type;
+    int param1;
+    unsigned int weight;
+} MixEntry;
+
+typedef struct {
+    uint64_t* samples;          // 왕복 지연 (ns)
+    size_t count;
+    size_t capacity;
+    uint64_t errors;
+} MixStats;
+
+typedef struct {
+    bool busy;
+    uint32_t request_id;
+    int mix;
+    uint64_t start_ns;          // open-loop는 예정 시각
+} InflightSlot;
+
+typedef struct {
+    int fd;
+    bool connected;             // connect 완료 후 핸드셰이크 전송
+    bool ready;                 // 메뉴 / 바이너리 ack 수신
+    bool closed;
+    unsigned int seed;
+    uint32_t next_id;
+    int outstanding;
+    InflightSlot slots[MAX_INFLIGHT];
+    uint8_t in[RECV_BUFFER_SIZE];
+    size_t in_len;
+    uint8_t out[SEND_BUFFER_SIZE];
+    size_t out_len;
+    bool want_write;
+} LoadConn;
+
+typedef struct {
+    pthread_t thread;
+    LoadConn* conns;
+    int conn_count;
+    int epfd;
+    int timerfd;
+    uint64_t measure_start;
+    uint64_t measure_end;
+    bool stopping;
+    MixStats stats[MAX_MIX];
+    uint64_t unanswered;
+    int failed;
+} Worker;
+
+static struct {
+    struct sockaddr_in addr;
+    int connections;
+    int threads;
+    int depth;
+    double rate;                // 0 = closed-loop
+    int duration_s;
+    int warmup_s;
+    bool binary;
+    unsigned int seed;
+    MixEntry mix[MAX_MIX];
+    int mix_count;
+    unsigned int mix_total;
+} cfg;
+
+static pthread_barrier_t start_barrier;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void write_u32le(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t read_u32le(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// ---------------------------------------------------------------------------
+// 명령 구성: "name[=param1]:weight,..."
+// ---------------------------------------------------------------------------
+static int parse_mix(const char* text) {
+    char buffer[512];
+    char* saveptr;
+
+    strncpy(buffer, text, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    cfg.mix_count = 0;
+    cfg.mix_total = 0;
+
+    for (char* item = strtok_r(buffer, ",", &saveptr); item; item = strtok_r(NULL, ",", &saveptr)) {
+        char* colon = strchr(item, ':');
+        char* equals = strchr(item, '=');
+        unsigned int weight = 1;
+
+        if (cfg.mix_count == MAX_MIX) {
+            fprintf(stderr, "Too many mix entries (max %d)\n", MAX_MIX);
+            return -1;
+        }
+        if (colon) {
+            *colon = '\0';
+            weight = (unsigned int)strtoul(colon + 1, NULL, 10);
+        }
+        if (equals && (!colon || equals < colon)) {
+            *equals = '\0';
+        } else {
+            equals = NULL;
+        }
+
+        const CommandSpec* spec = NULL;
+        for (size_t i = 0; i < sizeof(COMMANDS) / sizeof(COMMANDS[0]); i++) {
+            if (strcmp(item, COMMANDS[i].name) == 0) {
+                spec = &COMMANDS[i];
+                break;
+            }
+        }
+        if (spec == NULL || weight == 0) {
+            fprintf(stderr, "Invalid mix entry: %s\n", item);
+            return -1;
+        }
+
+        MixEntry* entry = &cfg.mix[cfg.mix_count++];
+        entry->type = spec->type;
+        entry->param1 = equals ? atoi(equals + 1) : spec->param1;
+        entry->weight = weight;
+        if (equals) {
+            snprintf(entry->label, sizeof(entry->label), "%s=%d", spec->name, entry->param1);
+        } else {
+            snprintf(entry->label, sizeof(entry->label), "%s", spec->name);
+        }
+        cfg.mix_total += weight;
+    }
+
+    return cfg.mix_count > 0 ? 0 : -1;
+}
+
+static int pick_mix(LoadConn* c) {
+    unsigned int r = (unsigned int)rand_r(&c->seed) % cfg.mix_total;
+
+    for (int i = 0; i < cfg.mix_count; i++) {
+        if (r < cfg.mix[i].weight) {
+            return i;
+        }
+        r -= cfg.mix[i].weight;
+    }
+    return cfg.mix_count - 1;
+}
+
+// ---------------------------------------------------------------------------
+// 송신
+// ---------------------------------------------------------------------------
+static void update_interest(Worker* w, LoadConn* c, bool want_write) {
+    if (c->want_write == want_write || c->closed) {
+        return;
+    }
+    struct epoll_event ev = {
+        .events = EPOLLIN | (want_write ? EPOLLOUT : 0),
+        .data.ptr = c
+    };
+    epoll_ctl(w->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->want_write = want_write;
+}
+
+static void flush_conn(Worker* w, LoadConn* c) {
+    size_t offset = 0;
+
+    while (offset < c->out_len) {
+        ssize_t sent = send(c->fd, c->out + offset, c->out_len - offset, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            c->closed = true;
+            return;
+        }
+        offset += (size_t)sent;
+    }
+
+    c->out_len -= offset;
+    memmove(c->out, c->out + offset, c->out_len);
+    update_interest(w, c, c->out_len > 0);
+}
+
+static bool queue_command(LoadConn* c, uint64_t start_ns) {
+    if (c->outstanding == MAX_INFLIGHT || c->out_len + 64 > sizeof(c->out)) {
+        return false;
+    }
+
+    // 서버 완료 슬롯(request_id % MAX_INFLIGHT)이 빈 ID를 고른다 (0과 이벤트 ID는 쓰지 않음)
+    uint32_t id;
+    do {
+        id = c->next_id++;
+    } while (id == 0 || id == BINARY_EVENT_ID || c->slots[id % MAX_INFLIGHT].busy);
+
+    int mix = pick_mix(c);
+    const MixEntry* entry = &cfg.mix[mix];
+
+    if (cfg.binary) {
+        uint8_t* frame = c->out + c->out_len;
+        write_u32le(frame, id);
+        frame[4] = (uint8_t)entry->type;
+        frame[5] = frame[6] = frame[7] = 0;
+        write_u32le(frame + 8, (uint32_t)entry->param1);
+        write_u32le(frame + 12, 0);
+        c->out_len += BINARY_COMMAND_FRAME_SIZE;
+    } else {
+        c->out_len += (size_t)snprintf((char*)c->out + c->out_len, sizeof(c->out) - c->out_len,
+                                       "@%u %d %d 0\n", id, entry->type, entry->param1);
+    }
+
+    InflightSlot* slot = &c->slots[id % MAX_INFLIGHT];
+    slot->busy = true;
+    slot->request_id = id;
+    slot->mix = mix;
+    slot->start_ns = start_ns;
+    c->outstanding++;
+    return true;
+}
+
+static void top_up(LoadConn* c, uint64_t now) {
+    while (c->outstanding < cfg.depth && queue_command(c, now)) {
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 수신
+// ---------------------------------------------------------------------------
+static void record_sample(MixStats* stats, uint64_t latency_ns) {
+    if (stats->count == stats->capacity) {
+        size_t capacity = stats->capacity ? stats->capacity * 2 : 4096;
+        uint64_t* samples = realloc(stats->samples, capacity * sizeof(uint64_t));
+        if (samples == NULL) {
+            return;
+        }
+        stats->samples = samples;
+        stats->capacity = capacity;
+    }
+    stats->samples[stats->count++] = latency_ns;
+}
+
+static void complete(Worker* w, LoadConn* c, uint32_t request_id, bool error, uint64_t now) {
+    InflightSlot* slot = &c->slots[request_id % MAX_INFLIGHT];
+    if (!slot->busy || slot->request_id != request_id) {
+        return;
+    }
+
+    // 측정 구간에 보낸 명령만 센다
+    if (slot->start_ns >= w->measure_start && slot->start_ns < w->measure_end) {
+        MixStats* stats = &w->stats[slot->mix];
+        record_sample(stats, now - slot->start_ns);
+        if (error) {
+            stats->errors++;
+        }
+    }
+
+    slot->busy = false;
+    c->outstanding--;
+
+    if (cfg.rate == 0 && !w->stopping) {
+        top_up(c, now);
+    }
+}
+
+// 텍스트: 응답 줄 "[#id] [SUCCESS|ERROR] ...". 응답 뒤에 다시 오는 메뉴의 "Select: "가 줄 앞에 붙을 수 있다
+static void parse_text(Worker* w, LoadConn* c, uint64_t now) {
+    char* start = (char*)c->in;
+    char* end = start + c->in_len;
+    char* nl;
+
+    if (!c->ready) {
+        if (memmem(start, c->in_len, "Select: ", 8) == NULL) {
+            if (c->in_len == sizeof(c->in)) {
+                c->in_len = 0;
+            }
+            return;
+        }
+        c->ready = true;
+        c->in_len = 0;
+        return;
+    }
+
+    while ((nl = memchr(start, '\n', (size_t)(end - start))) != NULL) {
+        char* line = start;
+        while (nl - line >= 8 && memcmp(line, "Select: ", 8) == 0) {
+            line += 8;
+        }
+        if (nl - line >= 3 && line[0] == '[' && line[1] == '#') {
+            uint32_t id = (uint32_t)strtoul(line + 2, NULL, 10);
+            bool error = memmem(line, (size_t)(nl - line), "[ERROR]", 7) != NULL;
+            complete(w, c, id, error, now);
+        }
+        start = nl + 1;
+    }
+
+    c->in_len = (size_t)(end - start);
+    memmove(c->in, start, c->in_len);
+    if (c->in_len == sizeof(c->in)) {
+        c->in_len = 0;
+    }
+}
+
+// 바이너리: 응답 프레임 12 bytes, 이벤트 프레임 20 bytes (request_id가 BINARY_EVENT_ID)
+static void parse_binary(Worker* w, LoadConn* c, uint64_t now) {
+    size_t offset = 0;
+
+    while (c->in_len - offset >= BINARY_RESPONSE_FRAME_SIZE) {
+        const uint8_t* frame = c->in + offset;
+        uint32_t id = read_u32le(frame);
+
+        if (id == BINARY_EVENT_ID) {
+            if (c->in_len - offset < BINARY_EVENT_FRAME_SIZE) {
+                break;
+            }
+            offset += BINARY_EVENT_FRAME_SIZE;
+            continue;
+        }
+
+        offset += BINARY_RESPONSE_FRAME_SIZE;
+        if (!c->ready) {
+            c->ready = id == 0;         // 핸드셰이크 ack (value = 프로토콜 버전)
+            continue;
+        }
+        complete(w, c, id, (int32_t)read_u32le(frame + 4) != 0, now);
+    }
+
+    c->in_len -= offset;
+    memmove(c->in, c->in + offset, c->in_len);
+}
+
+static void handle_input(Worker* w, LoadConn* c) {
+    ssize_t r = recv(c->fd, c->in + c->in_len, sizeof(c->in) - c->in_len, 0);
+
+    if (r <= 0) {
+        if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            c->closed = true;
+            epoll_ctl(w->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+        }
+        return;
+    }
+    c->in_len += (size_t)r;
+
+    uint64_t now = now_ns();
+    if (cfg.binary) {
+        parse_binary(w, c, now);
+    } else {
+        parse_text(w, c, now);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 워커
+// ---------------------------------------------------------------------------
+static void handle_events(Worker* w, struct epoll_event* events, int n) {
+    for (int i = 0; i < n; i++) {
+        LoadConn* c = events[i].data.ptr;
+        if (c == NULL) {
+            uint64_t expirations;
+            ssize_t ret = read(w->timerfd, &expirations, sizeof(expirations));
+            (void)ret;
+            continue;
+        }
+        if (c->closed) {
+            continue;
+        }
+
+        // connect 완료: 텍스트는 빈 줄로 바이너리 핸드셰이크 대기를 건너뛰고, 바이너리는 magic을 보낸다
+        if (!c->connected && (events[i].events & EPOLLOUT)) {
+            c->connected = true;
+            if (cfg.binary) {
+                memcpy(c->out, BINARY_MAGIC, BINARY_MAGIC_LEN);
+                c->out_len = BINARY_MAGIC_LEN;
+            } else {
+                c->out[0] = '\n';
+                c->out_len = 1;
+            }
+        }
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            handle_input(w, c);
+        }
+        if (!c->closed && c->out_len > 0) {
+            flush_conn(w, c);
+        }
+    }
+}
+
+static int worker_connect(Worker* w) {
+    for (int i = 0; i < w->conn_count; i++) {
+        LoadConn* c = &w->conns[i];
+        c->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (c->fd < 0) {
+            perror("socket");
+            return -1;
+        }
+
+        int one = 1;
+        setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (connect(c->fd, (const struct sockaddr*)&cfg.addr, sizeof(cfg.addr)) < 0 &&
+            errno != EINPROGRESS) {
+            perror("connect");
+            return -1;
+        }
+
+        struct epoll_event ev = { .events = EPOLLIN | EPOLLOUT, .data.ptr = c };
+        epoll_ctl(w->epfd, EPOLL_CTL_ADD, c->fd, &ev);
+        c->want_write = true;
+    }
+
+    struct epoll_event events[MAX_EVENTS];
+    uint64_t deadline = now_ns() + HANDSHAKE_TIMEOUT_NS;
+    int ready = 0;
+
+    while (ready < w->conn_count) {
+        if (now_ns() > deadline) {
+            fprintf(stderr, "loadgen: %d/%d connections ready before timeout\n", ready, w->conn_count);
+            return -1;
+        }
+        int n = epoll_wait(w->epfd, events, MAX_EVENTS, 100);
+        if (n < 0 && errno != EINTR) {
+            return -1;
+        }
+        handle_events(w, events, n > 0 ? n : 0);
+
+        ready = 0;
+        for (int i = 0; i < w->conn_count; i++) {
+            if (w->conns[i].closed) {
+                fprintf(stderr, "loadgen: connection closed during handshake\n");
+                return -1;
+            }
+            ready += w->conns[i].ready;
+        }
+    }
+    return 0;
+}
+
+static void arm_timer(Worker* w, uint64_t due) {
+    struct itimerspec its = {
+        .it_value = {
+            .tv_sec = (time_t)(due / 1000000000ULL),
+            .tv_nsec = (long)(due % 1000000000ULL)
+        }
+    };
+    timerfd_settime(w->timerfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void* worker_main(void* arg) {
+    Worker* w = arg;
+    struct epoll_event events[MAX_EVENTS];
+
+    if (worker_connect(w) != 0) {
+        w->failed = 1;
+    }
+    pthread_barrier_wait(&start_barrier);
+    if (w->failed) {
+        return NULL;
+    }
+
+    uint64_t start = now_ns();
+    w->measure_start = start + (uint64_t)cfg.warmup_s * 1000000000ULL;
+    w->measure_end = w->measure_start + (uint64_t)cfg.duration_s * 1000000000ULL;
+
+    // open-loop: 이 워커가 맡은 연결 수만큼의 rate를 고정 간격으로
+    uint64_t interval = 0;
+    uint64_t next_due = start;
+    int next_conn = 0;
+    if (cfg.rate > 0) {
+        interval = (uint64_t)(1e9 * cfg.connections / (cfg.rate * w->conn_count));
+        if (interval == 0) {
+            interval = 1;
+        }
+    } else {
+        for (int i = 0; i < w->conn_count; i++) {
+            top_up(&w->conns[i], start);
+            flush_conn(w, &w->conns[i]);
+        }
+    }
+
+    for (;;) {
+        uint64_t now = now_ns();
+        if (now >= w->measure_end) {
+            break;
+        }
+
+        if (cfg.rate > 0) {
+            // 밀린 예정 시각을 차례로 보낸다. 모든 연결이 가득 차 있으면 응답이 올 때까지 미룬다
+            while (next_due <= now) {
+                LoadConn* c = NULL;
+                for (int tries = 0; tries < w->conn_count; tries++) {
+                    LoadConn* candidate = &w->conns[next_conn];
+                    next_conn = (next_conn + 1) % w->conn_count;
+                    if (!candidate->closed && candidate->outstanding < MAX_INFLIGHT) {
+                        c = candidate;
+                        break;
+                    }
+                }
+                if (c == NULL || !queue_command(c, next_due)) {
+                    break;
+                }
+                flush_conn(w, c);
+                next_due += interval;
+            }
+            if (next_due > now) {
+                arm_timer(w, next_due < w->measure_end ? next_due : w->measure_end);
+            }
+        }
+
+        int n = epoll_wait(w->epfd, events, MAX_EVENTS, 100);
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        handle_events(w, events, n > 0 ? n : 0);
+    }
+
+    // 남은 응답을 기다린다 (구간 안에서 보낸 명령의 지연도 끝까지 잰다)
+    w->stopping = true;
+    uint64_t deadline = now_ns() + DRAIN_TIMEOUT_NS;
+    for (;;) {
+        int outstanding = 0;
+        for (int i = 0; i < w->conn_count; i++) {
+            if (!w->conns[i].closed) {
+                outstanding += w->conns[i].outstanding;
+            }
+        }
+        if (outstanding == 0 || now_ns() > deadline) {
+            break;
+        }
+        int n = epoll_wait(w->epfd, events, MAX_EVENTS, 10);
+        handle_events(w, events, n > 0 ? n : 0);
+    }
+
+    for (int i = 0; i < w->conn_count; i++) {
+        w->unanswered += (uint64_t)w->conns[i].outstanding;
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// 결과
+// ---------------------------------------------------------------------------
+static double percentile_us(const uint64_t* sorted, size_t count, double q) {
+    if (count == 0) {
+        return 0;
+    }
+    size_t index = (size_t)(count * q);
+    if (index >= count) {
+        index = count - 1;
+    }
+    return sorted[index] / 1000.0;
+}
+
+static void report_mix(const char* label, uint64_t* samples, size_t count, uint64_t errors) {
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+    printf("loadgen_cmd type=%s cmds=%zu errors=%llu p50_us=%.1f p99_us=%.1f p999_us=%.1f max_us=%.1f\n",
+           label, count, (unsigned long long)errors,
+           percentile_us(samples, count, 0.50), percentile_us(samples, count, 0.99),
+           percentile_us(samples, count, 0.999), count ? samples[count - 1] / 1000.0 : 0);
+}
+
+static void report(Worker* workers) {
+    size_t total = 0;
+    uint64_t errors = 0, unanswered = 0;
+
+    for (int t = 0; t < cfg.threads; t++) {
+        unanswered += workers[t].unanswered;
+        for (int m = 0; m < cfg.mix_count; m++) {
+            total += workers[t].stats[m].count;
+            errors += workers[t].stats[m].errors;
+        }
+    }
+
+    printf("loadgen mode=%s protocol=%s conns=%d threads=%d depth=%d rate=%.0f warmup_s=%d duration_s=%d "
+           "cmds=%zu errors=%llu unanswered=%llu cmds_per_sec=%.1f\n",
+           cfg.rate > 0 ? "open" : "closed", cfg.binary ? "binary" : "text",
+           cfg.connections, cfg.threads, cfg.rate > 0 ? 0 : cfg.depth, cfg.rate,
+           cfg.warmup_s, cfg.duration_s, total, (unsigned long long)errors,
+           (unsigned long long)unanswered, total / (double)cfg.duration_s);
+
+    uint64_t* all = malloc((total ? total : 1) * sizeof(uint64_t));
+    size_t all_count = 0;
+
+    for (int m = 0; m < cfg.mix_count; m++) {
+        size_t count = 0;
+        uint64_t mix_errors = 0;
+        for (int t = 0; t < cfg.threads; t++) {
+            count += workers[t].stats[m].count;
+        }
+
+        uint64_t* samples = malloc((count ? count : 1) * sizeof(uint64_t));
+        if (samples == NULL || all == NULL) {
+            free(samples);
+            break;
+        }
+        count = 0;
+        for (int t = 0; t < cfg.threads; t++) {
+            MixStats* stats = &workers[t].stats[m];
+            memcpy(samples + count, stats->samples, stats->count * sizeof(uint64_t));
+            count += stats->count;
+            mix_errors += stats->errors;
+        }
+
+        memcpy(all + all_count, samples, count * sizeof(uint64_t));
+        all_count += count;
+        report_mix(cfg.mix[m].label, samples, count, mix_errors);
+        free(samples);
+    }
+
+    if (all) {
+        report_mix("all", all, all_count, errors);
+        free(all);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+static void print_usage(const char* program_name) {
+    printf("Usage: %s [OPTIONS] [host]\n", program_name);
+    printf("\n");
+    printf("Options:\n");
+    printf("  -p, --port <port>         Server port (default %d)\n", SERVER_PORT);
+    printf("  -c, --connections <n>     Connections (default %d)\n", DEFAULT_CONNECTIONS);
+    printf("  -t, --threads <n>         Worker threads, connections split evenly (default 1)\n");
+    printf("  -d, --duration <s>        Measured seconds (default %d)\n", DEFAULT_DURATION_S);
+    printf("  -w, --warmup <s>          Seconds before measuring (default %d)\n", DEFAULT_WARMUP_S);
+    printf("  -q, --depth <n>           Closed loop: commands in flight per connection (1-%d, default 1)\n",
+           MAX_INFLIGHT);
+    printf("  -r, --rate <cmds/s>       Open loop at this total rate (default 0 = closed loop)\n");
+    printf("  -m, --mix <mix>           Command mix name[=param1]:weight,... (default %s)\n", DEFAULT_MIX);
+    printf("  -b, --binary              Use the binary protocol\n");
+    printf("  -s, --seed <n>            Mix random seed (default 1)\n");
+    printf("  -h, --help                Show this help message\n");
+    printf("\n");
+    printf("Mix commands:");
+    for (size_t i = 0; i < sizeof(COMMANDS) / sizeof(COMMANDS[0]); i++) {
+        printf(" %s", COMMANDS[i].name);
+    }
+    printf("\n");
+    printf("\n");
+    printf("Examples:\n");
+    printf("  %s -c 64 -q 4                       Closed loop, 64 connections, 4 in flight each\n", program_name);
+    printf("  %s -c 16 -r 20000 -m status:1       Open loop, 20000 status queries per second\n", program_name);
+}
+
+static bool parse_positive(const char* text, int max, int* value) {
+    char* end;
+    long result = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || result < 1 || result > max) {
+        return false;
+    }
+    *value = (int)result;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const char* host = "127.0.0.1";
+    const char* mix = DEFAULT_MIX;
+    int port = SERVER_PORT;
+
+    cfg.connections = DEFAULT_CONNECTIONS;
+    cfg.threads = 1;
+    cfg.depth = 1;
+    cfg.duration_s = DEFAULT_DURATION_S;
+    cfg.warmup_s = DEFAULT_WARMUP_S;
+    cfg.seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        bool ok = true;
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (strcmp(arg, "-b") == 0 || strcmp(arg, "--binary") == 0) {
+            cfg.binary = true;
+            continue;
+        } else if (arg[0] != '-') {
+            host = arg;
+            continue;
+        } else if (value == NULL) {
+            ok = false;
+        } else if (strcmp(arg, "-p") == 0 || strcmp(arg, "--port") == 0) {
+            ok = parse_positive(value, 65535, &port);
+        } else if (strcmp(arg, "-c") == 0 || strcmp(arg, "--connections") == 0) {
+            ok = parse_positive(value, 65536, &cfg.connections);
+        } else if (strcmp(arg, "-t") == 0 || strcmp(arg, "--threads") == 0) {
+            ok = parse_positive(value, 256, &cfg.threads);
+        } else if (strcmp(arg, "-d") == 0 || strcmp(arg, "--duration") == 0) {
+            ok = parse_positive(value, 86400, &cfg.duration_s);
+        } else if (strcmp(arg, "-w") == 0 || strcmp(arg, "--warmup") == 0) {
+            cfg.warmup_s = atoi(value);
+            ok = cfg.warmup_s >= 0;
+        } else if (strcmp(arg, "-q") == 0 || strcmp(arg, "--depth") == 0) {
+            ok = parse_positive(value, MAX_INFLIGHT, &cfg.depth);
+        } else if (strcmp(arg, "-r") == 0 || strcmp(arg, "--rate") == 0) {
+            cfg.rate = atof(value);
+            ok = cfg.rate >= 0;
+        } else if (strcmp(arg, "-m") == 0 || strcmp(arg, "--mix") == 0) {
+            mix = value;
+        } else if (strcmp(arg, "-s") == 0 || strcmp(arg, "--seed") == 0) {
+            cfg.seed = (unsigned int)strtoul(value, NULL, 10);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Invalid option: %s%s%s\n", arg, value ? " " : "", value ? value : "");
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        i++;
+    }
+
+    if (parse_mix(mix) != 0) {
+        return EXIT_FAILURE;
+    }
+    if (cfg.threads > cfg.connections) {
+        cfg.threads = cfg.connections;
+    }
+
+    cfg.addr.sin_family = AF_INET;
+    cfg.addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &cfg.addr.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid server IP address: %s\n", host);
+        return EXIT_FAILURE;
+    }
+
+    Worker* workers = calloc((size_t)cfg.threads, sizeof(Worker));
+    LoadConn* conns = calloc((size_t)cfg.connections, sizeof(LoadConn));
+    if (workers == NULL || conns == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    // 연결을 워커에 고르게 나눈다. 시드는 연결 번호마다 달라 워커 수를 바꿔도 연결별 명령 순서는 같다
+    for (int i = 0; i < cfg.connections; i++) {
+        conns[i].fd = -1;
+        conns[i].seed = cfg.seed * 1000003u + (unsigned int)i;
+        conns[i].next_id = 1;
+    }
+    int offset = 0;
+    for (int t = 0; t < cfg.threads; t++) {
+        Worker* w = &workers[t];
+        w->conns = conns + offset;
+        w->conn_count = cfg.connections / cfg.threads + (t < cfg.connections % cfg.threads);
+        offset += w->conn_count;
+        w->epfd = epoll_create1(EPOLL_CLOEXEC);
+        w->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (w->epfd < 0 || w->timerfd < 0) {
+            perror("epoll / timerfd");
+            return EXIT_FAILURE;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+        epoll_ctl(w->epfd, EPOLL_CTL_ADD, w->timerfd, &ev);
+    }
+
+    pthread_barrier_init(&start_barrier, NULL, (unsigned int)cfg.threads);
+    for (int t = 0; t < cfg.threads; t++) {
+        if (pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]) != 0) {
+            fprintf(stderr, "Failed to start worker thread\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    int failed = 0;
+    for (int t = 0; t < cfg.threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        failed += workers[t].failed;
+    }
+    pthread_barrier_destroy(&start_barrier);
+
+    if (!failed) {
+        report(workers);
+    }
+
+    for (int i = 0; i < cfg.connections; i++) {
+        if (conns[i].fd >= 0) {
+            close(conns[i].fd);
+        }
+    }
+    for (int t = 0; t < cfg.threads; t++) {
+        close(workers[t].epfd);
+        close(workers[t].timerfd);
+        for (int m = 0; m < cfg.mix_count; m++) {
+            free(workers[t].stats[m].samples);
+        }
+    }
+    free(conns);
+    free(workers);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+# GPIO HAL 빌드 설정 (HAL 소스를 직접 컴파일하는 벤치마크와 gpio/Makefile에서 include)
+GPIO_DIR := $(dir $(lastword $(MAKEFILE_LIST)))
+GPIO_SRC = $(GPIO_DIR)gpio_hal.c $(GPIO_DIR)gpio_wiringpi.c $(GPIO_DIR)gpio_gpiod.c $(GPIO_DIR)gpio_sim.c
+GPIO_HEADERS = $(GPIO_DIR)gpio_hal.h $(GPIO_DIR)gpio_sim.h $(GPIO_DIR)gpio_backend.h
+
+# wiringPi가 있으면 wiringpi 백엔드를 빌드 (make WIRINGPI=0으로 끌 수 있음).
+# 없으면(x86 CI 등) sim 백엔드만으로 빌드되고 기본 백엔드도 sim이 된다.
+WIRINGPI ?= $(shell $(CC) -E -include wiringPi.h -x c /dev/null >/dev/null 2>&1 && echo 1 || echo 0)
+
+# libgpiod v2가 있으면 gpiod 백엔드도 빌드 (make GPIOD=0으로 끌 수 있음)
+GPIOD ?= $(shell pkg-config --exists 'libgpiod >= 2.0' && echo 1 || echo 0)
+
+# 기본 백엔드 (gpio_init(NULL)에 GPIO_BACKEND 환경 변수도 없을 때). 예) make GPIO_DEFAULT=sim
+GPIO_DEFAULT ?=
+
+GPIO_CFLAGS = -I$(GPIO_DIR)
+GPIO_LIBS = -lpthread
+
+ifeq ($(WIRINGPI),1)
+GPIO_CFLAGS += -DGPIO_HAVE_WIRINGPI
+GPIO_LIBS += -lwiringPi
+endif
+
+ifeq ($(GPIOD),1)
+GPIO_CFLAGS += -DGPIO_HAVE_GPIOD
+GPIO_LIBS += -lgpiod
+endif
+
+ifneq ($(GPIO_DEFAULT),)
+GPIO_CFLAGS += -DGPIO_DEFAULT_BACKEND='"$(GPIO_DEFAULT)"'
+endif
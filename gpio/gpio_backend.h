@@ -0,0 +1,47 @@
+#ifndef GPIO_BACKEND_H
+#define GPIO_BACKEND_H
+
+#include "gpio_hal.h"
+
+// GPIO 백엔드 (gpio_hal 내부용)
+// gpio_hal.c가 인자를 확인한 뒤 호출하므로 백엔드는 핀 번호 범위와 요청 방향을 다시 확인하지 않는다.
+// 필요 없는 기능은 NULL로 둔다 (pwm_* 가 NULL이면 PWM 없음, tone_* 가 NULL이면 gpio_hal.c의
+// 소프트웨어 톤 스레드가 write_mask로 파형을 만든다).
+struct GpioLines {
+    int count;
+    int pins[GPIO_MAX_LINES];
+    uint64_t mask;              // pins의 비트
+    bool output;
+    GpioEdge edge;
+    void* priv;                 // 백엔드 데이터
+};
+
+typedef struct {
+    const char* name;
+    int (*init)(void);                                          // 성공 시 0
+    void (*cleanup)(void);
+    int (*request)(GpioLines* lines);                           // 성공 시 0 (priv 채움)
+    void (*release)(GpioLines* lines);
+    void (*write_mask)(GpioLines* lines, uint64_t set, uint64_t clear);
+    int (*read)(GpioLines* lines, int pin);
+    int (*event_fd)(GpioLines* lines);
+    int (*read_events)(GpioLines* lines, GpioEvent* events, int max);
+    int (*pwm_setup)(int pin);
+    int (*pwm_set)(int pin, uint32_t period_ns, uint32_t duty_ns);
+    void (*pwm_release)(int pin);
+    int (*tone_start)(int pin);
+    void (*tone_write)(int pin, int frequency_hz);
+    void (*tone_stop)(int pin);
+} GpioBackend;
+
+#ifdef GPIO_HAVE_WIRINGPI
+extern const GpioBackend gpio_backend_wiringpi;
+#endif
+#ifdef GPIO_HAVE_GPIOD
+extern const GpioBackend gpio_backend_gpiod;
+#endif
+extern const GpioBackend gpio_backend_sim;
+
+uint64_t gpio_now_ns(void);
+
+#endif // GPIO_BACKEND_H
@@ -0,0 +1,290 @@
+#ifdef GPIO_HAVE_GPIOD
+
+#include "gpio_backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <gpiod.h>
+
+// libgpiod v2 백엔드 (GPIO 문자 장치)
+// - 요청(GpioLines) 하나가 gpiod_line_request 하나다. 출력 요청의 핀들은
+//   gpiod_line_request_set_values_subset 한 번(ioctl 한 번)에 함께 바뀐다.
+// - 에지 이벤트: 커널이 요청 fd에 이벤트를 쌓아 두고, gpiod_line_request_read_edge_events로
+//   여러 개를 한 번에 읽는다. 시각은 커널이 에지를 본 CLOCK_MONOTONIC 시각이다.
+// - line offset은 BCM 번호와 같다고 본다 (Pi 4: gpiochip0, Pi 5: 커널 6.6 이후 gpiochip0).
+//   칩은 환경 변수 GPIO_CHIP으로 바꿀 수 있다.
+// - PWM: 문자 장치에는 PWM이 없어 sysfs PWM(/sys/class/pwm)을 쓴다. config.txt에
+//   dtoverlay=pwm-2chan 같은 오버레이로 핀을 PWM 기능으로 잡아 두어야 한다.
+//   (BCM 12/18 = 채널 0, 13/19 = 채널 1, 칩은 환경 변수 GPIO_PWMCHIP)
+// - 톤: 백엔드 톤이 없어 gpio_hal.c의 소프트웨어 톤 스레드를 쓴다.
+// libgpiod 객체는 스레드 안전하지 않지만 값 쓰기 / 읽기는 요청 fd에 ioctl만 하므로
+// 같은 요청을 여러 스레드에서 써도 된다. 이벤트 버퍼는 gpio_read_events를 부르는 스레드 하나만 쓴다.
+
+#define CHIP_ENV            "GPIO_CHIP"
+#define CHIP_DEFAULT        "/dev/gpiochip0"
+#define PWMCHIP_ENV         "GPIO_PWMCHIP"
+#define PWMCHIP_DEFAULT     "/sys/class/pwm/pwmchip0"
+#define CONSUMER            "iot_server"
+#define EVENT_BUFFER_SIZE   64
+
+typedef struct {
+    struct gpiod_line_request* request;
+    struct gpiod_edge_event_buffer* buffer;
+} GpiodLines;
+
+static struct gpiod_chip* chip = NULL;
+
+// sysfs PWM 채널별 현재 주기 (0 = 꺼짐)
+static uint32_t pwm_period[2];
+
+// ---------------------------------------------------------------------------
+// 초기화
+// ---------------------------------------------------------------------------
+static int chardev_init(void) {
+    const char* path = getenv(CHIP_ENV);
+    if (path == NULL || path[0] == '\0') {
+        path = CHIP_DEFAULT;
+    }
+
+    chip = gpiod_chip_open(path);
+    if (chip == NULL) {
+        fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static void chardev_cleanup(void) {
+    if (chip) {
+        gpiod_chip_close(chip);
+        chip = NULL;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 핀 요청
+// ---------------------------------------------------------------------------
+static int chardev_request(GpioLines* lines) {
+    static const enum gpiod_line_edge EDGES[] = {
+        [GPIO_EDGE_NONE] = GPIOD_LINE_EDGE_NONE,
+        [GPIO_EDGE_RISING] = GPIOD_LINE_EDGE_RISING,
+        [GPIO_EDGE_FALLING] = GPIOD_LINE_EDGE_FALLING,
+        [GPIO_EDGE_BOTH] = GPIOD_LINE_EDGE_BOTH
+    };
+    unsigned int offsets[GPIO_MAX_LINES];
+    struct gpiod_line_settings* settings = gpiod_line_settings_new();
+    struct gpiod_line_config* line_config = gpiod_line_config_new();
+    struct gpiod_request_config* request_config = gpiod_request_config_new();
+    GpiodLines* data = calloc(1, sizeof(GpiodLines));
+    int result = -1;
+
+    if (settings == NULL || line_config == NULL || request_config == NULL || data == NULL) {
+        goto out;
+    }
+
+    for (int i = 0; i < lines->count; i++) {
+        offsets[i] = (unsigned int)lines->pins[i];
+    }
+
+    if (lines->output) {
+        gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_OUTPUT);
+        gpiod_line_settings_set_output_value(settings, GPIOD_LINE_VALUE_INACTIVE);
+    } else {
+        gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+        gpiod_line_settings_set_edge_detection(settings, EDGES[lines->edge]);
+        gpiod_line_settings_set_event_clock(settings, GPIOD_LINE_CLOCK_MONOTONIC);
+    }
+
+    if (gpiod_line_config_add_line_settings(line_config, offsets, (size_t)lines->count, settings) != 0) {
+        goto out;
+    }
+
+    gpiod_request_config_set_consumer(request_config, CONSUMER);
+    if (lines->edge != GPIO_EDGE_NONE) {
+        gpiod_request_config_set_event_buffer_size(request_config, EVENT_BUFFER_SIZE);
+        data->buffer = gpiod_edge_event_buffer_new(EVENT_BUFFER_SIZE);
+        if (data->buffer == NULL) {
+            goto out;
+        }
+    }
+
+    data->request = gpiod_chip_request_lines(chip, request_config, line_config);
+    if (data->request == NULL) {
+        fprintf(stderr, "gpiod: %s\n", strerror(errno));
+        goto out;
+    }
+
+    lines->priv = data;
+    data = NULL;
+    result = 0;
+
+out:
+    if (data) {
+        if (data->buffer) {
+            gpiod_edge_event_buffer_free(data->buffer);
+        }
+        free(data);
+    }
+    gpiod_request_config_free(request_config);
+    gpiod_line_config_free(line_config);
+    gpiod_line_settings_free(settings);
+    return result;
+}
+
+static void chardev_release(GpioLines* lines) {
+    GpiodLines* data = lines->priv;
+
+    gpiod_line_request_release(data->request);
+    if (data->buffer) {
+        gpiod_edge_event_buffer_free(data->buffer);
+    }
+    free(data);
+    lines->priv = NULL;
+}
+
+static void chardev_write_mask(GpioLines* lines, uint64_t set, uint64_t clear) {
+    GpiodLines* data = lines->priv;
+    unsigned int offsets[GPIO_MAX_LINES];
+    enum gpiod_line_value values[GPIO_MAX_LINES];
+    size_t count = 0;
+
+    for (uint64_t bits = set | clear; bits; bits &= bits - 1) {
+        int pin = __builtin_ctzll(bits);
+        offsets[count] = (unsigned int)pin;
+        values[count] = (set & (1ULL << pin)) ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE;
+        count++;
+    }
+
+    // 한 ioctl 안에서 바뀌므로 자리 선택과 BCD가 같은 시각에 바뀐다
+    gpiod_line_request_set_values_subset(data->request, count, offsets, values);
+}
+
+static int chardev_read(GpioLines* lines, int pin) {
+    GpiodLines* data = lines->priv;
+    enum gpiod_line_value value = gpiod_line_request_get_value(data->request, (unsigned int)pin);
+
+    if (value == GPIOD_LINE_VALUE_ERROR) {
+        return -1;
+    }
+    return value == GPIOD_LINE_VALUE_ACTIVE ? 1 : 0;
+}
+
+static int chardev_event_fd(GpioLines* lines) {
+    GpiodLines* data = lines->priv;
+    return gpiod_line_request_get_fd(data->request);
+}
+
+static int chardev_read_events(GpioLines* lines, GpioEvent* events, int max) {
+    GpiodLines* data = lines->priv;
+
+    // read_edge_events는 이벤트가 없으면 막히므로 먼저 0ns로 확인한다
+    int ready = gpiod_line_request_wait_edge_events(data->request, 0);
+    if (ready <= 0) {
+        return ready;
+    }
+
+    if (max > EVENT_BUFFER_SIZE) {
+        max = EVENT_BUFFER_SIZE;
+    }
+    int count = gpiod_line_request_read_edge_events(data->request, data->buffer, (size_t)max);
+    for (int i = 0; i < count; i++) {
+        struct gpiod_edge_event* event = gpiod_edge_event_buffer_get_event(data->buffer, (unsigned long)i);
+        events[i].pin = (int)gpiod_edge_event_get_line_offset(event);
+        events[i].level = gpiod_edge_event_get_event_type(event) == GPIOD_EDGE_EVENT_RISING_EDGE;
+        events[i].timestamp_ns = gpiod_edge_event_get_timestamp_ns(event);
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// sysfs PWM
+// ---------------------------------------------------------------------------
+static int pwm_channel(int pin) {
+    return (pin == 12 || pin == 18) ? 0 : 1;
+}
+
+static int pwm_write_attr(int channel, const char* attr, unsigned long value) {
+    const char* base = getenv(PWMCHIP_ENV);
+    char path[128];
+    char text[24];
+
+    if (base == NULL || base[0] == '\0') {
+        base = PWMCHIP_DEFAULT;
+    }
+    if (channel < 0) {
+        snprintf(path, sizeof(path), "%s/%s", base, attr);
+    } else {
+        snprintf(path, sizeof(path), "%s/pwm%d/%s", base, channel, attr);
+    }
+
+    int fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    int len = snprintf(text, sizeof(text), "%lu", value);
+    ssize_t written = write(fd, text, (size_t)len);
+    close(fd);
+    return written == len ? 0 : -1;
+}
+
+static int chardev_pwm_setup(int pin) {
+    int channel = pwm_channel(pin);
+
+    // 이미 export되어 있으면 EBUSY
+    if (pwm_write_attr(-1, "export", (unsigned long)channel) != 0 && errno != EBUSY) {
+        fprintf(stderr, "GPIO %d: sysfs PWM channel %d unavailable (enable a pwm overlay)\n",
+                pin, channel);
+        return -1;
+    }
+    pwm_period[channel] = 0;
+    return 0;
+}
+
+static int chardev_pwm_set(int pin, uint32_t period_ns, uint32_t duty_ns) {
+    int channel = pwm_channel(pin);
+
+    if (period_ns == 0) {
+        return pwm_write_attr(channel, "enable", 0);
+    }
+
+    // duty가 주기보다 길면 주기를 쓸 수 없으므로 주기를 바꿀 때는 duty를 먼저 0으로
+    if (period_ns != pwm_period[channel]) {
+        if (pwm_write_attr(channel, "duty_cycle", 0) != 0 ||
+            pwm_write_attr(channel, "period", period_ns) != 0) {
+            return -1;
+        }
+        pwm_period[channel] = period_ns;
+    }
+    if (pwm_write_attr(channel, "duty_cycle", duty_ns) != 0) {
+        return -1;
+    }
+    return pwm_write_attr(channel, "enable", 1);
+}
+
+static void chardev_pwm_release(int pin) {
+    int channel = pwm_channel(pin);
+
+    pwm_write_attr(channel, "enable", 0);
+    pwm_write_attr(-1, "unexport", (unsigned long)channel);
+    pwm_period[channel] = 0;
+}
+
+const GpioBackend gpio_backend_gpiod = {
+    .name = "gpiod",
+    .init = chardev_init,
+    .cleanup = chardev_cleanup,
+    .request = chardev_request,
+    .release = chardev_release,
+    .write_mask = chardev_write_mask,
+    .read = chardev_read,
+    .event_fd = chardev_event_fd,
+    .read_events = chardev_read_events,
+    .pwm_setup = chardev_pwm_setup,
+    .pwm_set = chardev_pwm_set,
+    .pwm_release = chardev_pwm_release
+};
+
+#endif // GPIO_HAVE_GPIOD
@@ -0,0 +1,417 @@
+#include "gpio_backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#define BACKEND_ENV         "GPIO_BACKEND"
+#define MAX_TONES           4
+
+// 기본 백엔드: 빌드할 때 GPIO_DEFAULT=<이름>으로 정하고, 없으면 wiringPi가 있을 때 wiringpi, 아니면 sim
+#ifndef GPIO_DEFAULT_BACKEND
+#ifdef GPIO_HAVE_WIRINGPI
+#define GPIO_DEFAULT_BACKEND "wiringpi"
+#else
+#define GPIO_DEFAULT_BACKEND "sim"
+#endif
+#endif
+
+static const GpioBackend* const BACKENDS[] = {
+#ifdef GPIO_HAVE_WIRINGPI
+    &gpio_backend_wiringpi,
+#endif
+#ifdef GPIO_HAVE_GPIOD
+    &gpio_backend_gpiod,
+#endif
+    &gpio_backend_sim,
+};
+
+static const GpioBackend* backend = NULL;
+
+// 소프트웨어 톤 (백엔드에 tone_*가 없을 때): 재생하는 동안만 핀마다 스레드 하나가
+// 반 주기마다 절대 시각으로 잠들었다 깨어 핀을 뒤집는다. 소리를 끄면 조건 변수에서 기다린다.
+typedef struct {
+    int pin;                    // -1 = 빈 슬롯
+    GpioLines* lines;
+    pthread_t thread;
+    pthread_cond_t cond;
+    int frequency_hz;
+    bool running;
+} SoftTone;
+
+static pthread_mutex_t tone_mutex = PTHREAD_MUTEX_INITIALIZER;
+static SoftTone tones[MAX_TONES] = {
+    { .pin = -1 }, { .pin = -1 }, { .pin = -1 }, { .pin = -1 }
+};
+
+uint64_t gpio_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static bool check_initialized(void) {
+    if (backend == NULL) {
+        fprintf(stderr, "GPIO not initialized. Call gpio_init() first.\n");
+        return false;
+    }
+    return true;
+}
+
+static bool check_pin(int pin) {
+    if (pin < 0 || pin > GPIO_MAX_PIN) {
+        fprintf(stderr, "Invalid GPIO pin: %d (must be 0-%d)\n", pin, GPIO_MAX_PIN);
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 초기화
+// ---------------------------------------------------------------------------
+int gpio_init(const char* name) {
+    if (name == NULL || name[0] == '\0') {
+        name = getenv(BACKEND_ENV);
+    }
+    if (name == NULL || name[0] == '\0') {
+        name = GPIO_DEFAULT_BACKEND;
+    }
+
+    if (backend != NULL) {
+        if (strcmp(backend->name, name) == 0) {
+            return 0;
+        }
+        fprintf(stderr, "GPIO already initialized with backend %s\n", backend->name);
+        return -1;
+    }
+
+    for (size_t i = 0; i < sizeof(BACKENDS) / sizeof(BACKENDS[0]); i++) {
+        if (strcmp(BACKENDS[i]->name, name) != 0) {
+            continue;
+        }
+        if (BACKENDS[i]->init() != 0) {
+            fprintf(stderr, "Failed to initialize GPIO backend %s\n", name);
+            return -1;
+        }
+        backend = BACKENDS[i];
+        printf("GPIO initialized (backend: %s)\n", backend->name);
+        return 0;
+    }
+
+    fprintf(stderr, "Unknown GPIO backend: %s (available:", name);
+    for (size_t i = 0; i < sizeof(BACKENDS) / sizeof(BACKENDS[0]); i++) {
+        fprintf(stderr, " %s", BACKENDS[i]->name);
+    }
+    fprintf(stderr, ")\n");
+    return -1;
+}
+
+void gpio_cleanup(void) {
+    if (backend == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < MAX_TONES; i++) {
+        if (tones[i].pin >= 0) {
+            gpio_tone_stop(tones[i].pin);
+        }
+    }
+
+    backend->cleanup();
+    backend = NULL;
+}
+
+const char* gpio_backend(void) {
+    return backend ? backend->name : NULL;
+}
+
+// ---------------------------------------------------------------------------
+// 핀 요청
+// ---------------------------------------------------------------------------
+static GpioLines* request_lines(const int* pins, int count, bool output, GpioEdge edge) {
+    if (!check_initialized()) {
+        return NULL;
+    }
+
+    if (pins == NULL || count < 1 || count > GPIO_MAX_LINES) {
+        fprintf(stderr, "Invalid GPIO line count: %d (must be 1-%d)\n", count, GPIO_MAX_LINES);
+        return NULL;
+    }
+
+    GpioLines* lines = calloc(1, sizeof(GpioLines));
+    if (lines == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!check_pin(pins[i])) {
+            free(lines);
+            return NULL;
+        }
+        if (lines->mask & (1ULL << pins[i])) {
+            fprintf(stderr, "GPIO pin %d requested twice\n", pins[i]);
+            free(lines);
+            return NULL;
+        }
+        lines->pins[i] = pins[i];
+        lines->mask |= 1ULL << pins[i];
+    }
+    lines->count = count;
+    lines->output = output;
+    lines->edge = output ? GPIO_EDGE_NONE : edge;
+
+    if (backend->request(lines) != 0) {
+        fprintf(stderr, "Failed to request GPIO pin %d%s\n", pins[0], count > 1 ? " ..." : "");
+        free(lines);
+        return NULL;
+    }
+    return lines;
+}
+
+GpioLines* gpio_request_output(const int* pins, int count) {
+    return request_lines(pins, count, true, GPIO_EDGE_NONE);
+}
+
+GpioLines* gpio_request_input(int pin, GpioEdge edge) {
+    return request_lines(&pin, 1, false, edge);
+}
+
+void gpio_release(GpioLines* lines) {
+    if (lines == NULL || backend == NULL) {
+        return;
+    }
+
+    if (lines->output) {
+        backend->write_mask(lines, 0, lines->mask);
+    }
+    backend->release(lines);
+    free(lines);
+}
+
+// ---------------------------------------------------------------------------
+// 읽기 / 쓰기
+// ---------------------------------------------------------------------------
+void gpio_write_mask(GpioLines* lines, uint64_t set, uint64_t clear) {
+    if (lines == NULL || !lines->output) {
+        return;
+    }
+
+    set &= lines->mask;
+    clear &= lines->mask & ~set;
+    if (set | clear) {
+        backend->write_mask(lines, set, clear);
+    }
+}
+
+void gpio_write(GpioLines* lines, int pin, int level) {
+    if (pin < 0 || pin > GPIO_MAX_PIN) {
+        return;
+    }
+    uint64_t bit = 1ULL << pin;
+    gpio_write_mask(lines, level ? bit : 0, level ? 0 : bit);
+}
+
+int gpio_read(GpioLines* lines, int pin) {
+    if (lines == NULL || pin < 0 || pin > GPIO_MAX_PIN || !(lines->mask & (1ULL << pin))) {
+        return -1;
+    }
+    return backend->read(lines, pin);
+}
+
+int gpio_event_fd(GpioLines* lines) {
+    if (lines == NULL || lines->edge == GPIO_EDGE_NONE) {
+        return -1;
+    }
+    return backend->event_fd(lines);
+}
+
+int gpio_read_events(GpioLines* lines, GpioEvent* events, int max) {
+    if (lines == NULL || lines->edge == GPIO_EDGE_NONE || events == NULL || max < 1) {
+        return -1;
+    }
+    return backend->read_events(lines, events, max);
+}
+
+// ---------------------------------------------------------------------------
+// 하드웨어 PWM
+// ---------------------------------------------------------------------------
+bool gpio_pwm_supported(int pin) {
+    return pin == 12 || pin == 13 || pin == 18 || pin == 19;
+}
+
+int gpio_pwm_setup(int pin) {
+    if (!check_initialized()) {
+        return -1;
+    }
+    if (!gpio_pwm_supported(pin) || backend->pwm_setup == NULL) {
+        fprintf(stderr, "GPIO %d has no hardware PWM on backend %s (use 12, 13, 18 or 19)\n",
+                pin, backend->name);
+        return -1;
+    }
+    return backend->pwm_setup(pin);
+}
+
+int gpio_pwm_set(int pin, uint32_t period_ns, uint32_t duty_ns) {
+    if (backend == NULL || backend->pwm_set == NULL || !gpio_pwm_supported(pin)) {
+        return -1;
+    }
+    if (duty_ns > period_ns) {
+        duty_ns = period_ns;
+    }
+    return backend->pwm_set(pin, period_ns, duty_ns);
+}
+
+void gpio_pwm_release(int pin) {
+    if (backend == NULL || backend->pwm_release == NULL || !gpio_pwm_supported(pin)) {
+        return;
+    }
+    backend->pwm_release(pin);
+}
+
+// ---------------------------------------------------------------------------
+// 톤
+// ---------------------------------------------------------------------------
+static SoftTone* find_tone(int pin) {
+    for (int i = 0; i < MAX_TONES; i++) {
+        if (tones[i].pin == pin) {
+            return &tones[i];
+        }
+    }
+    return NULL;
+}
+
+static void* soft_tone_loop(void* arg) {
+    SoftTone* tone = arg;
+    uint64_t bit = 1ULL << tone->pin;
+    uint64_t deadline = gpio_now_ns();
+    int level = 0;
+
+    pthread_mutex_lock(&tone_mutex);
+    while (tone->running) {
+        if (tone->frequency_hz <= 0) {
+            if (level) {
+                backend->write_mask(tone->lines, 0, bit);
+                level = 0;
+            }
+            pthread_cond_wait(&tone->cond, &tone_mutex);
+            deadline = gpio_now_ns();
+            continue;
+        }
+
+        uint64_t half_period = 500000000ULL / (uint64_t)tone->frequency_hz;
+        pthread_mutex_unlock(&tone_mutex);
+
+        level = !level;
+        backend->write_mask(tone->lines, level ? bit : 0, level ? 0 : bit);
+
+        deadline += half_period;
+        struct timespec ts = {
+            .tv_sec = (time_t)(deadline / 1000000000ULL),
+            .tv_nsec = (long)(deadline % 1000000000ULL)
+        };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+
+        pthread_mutex_lock(&tone_mutex);
+    }
+    pthread_mutex_unlock(&tone_mutex);
+
+    backend->write_mask(tone->lines, 0, bit);
+    return NULL;
+}
+
+int gpio_tone_start(int pin) {
+    if (!check_initialized() || !check_pin(pin)) {
+        return -1;
+    }
+    if (backend->tone_start) {
+        return backend->tone_start(pin);
+    }
+
+    pthread_mutex_lock(&tone_mutex);
+    if (find_tone(pin)) {
+        pthread_mutex_unlock(&tone_mutex);
+        return 0;
+    }
+    SoftTone* tone = find_tone(-1);
+    if (tone == NULL) {
+        pthread_mutex_unlock(&tone_mutex);
+        fprintf(stderr, "Too many tone pins (max %d)\n", MAX_TONES);
+        return -1;
+    }
+    // 슬롯 예약 (gpio_tone_start / gpio_tone_stop은 핀마다 한 스레드에서 부른다)
+    tone->pin = pin;
+    tone->frequency_hz = 0;
+    tone->running = true;
+    pthread_cond_init(&tone->cond, NULL);
+    pthread_mutex_unlock(&tone_mutex);
+
+    GpioLines* lines = gpio_request_output(&pin, 1);
+    if (lines != NULL) {
+        tone->lines = lines;
+        if (pthread_create(&tone->thread, NULL, soft_tone_loop, tone) == 0) {
+            return 0;
+        }
+        fprintf(stderr, "Failed to start tone thread (pin %d)\n", pin);
+        gpio_release(lines);
+    }
+
+    pthread_mutex_lock(&tone_mutex);
+    pthread_cond_destroy(&tone->cond);
+    tone->lines = NULL;
+    tone->running = false;
+    tone->pin = -1;
+    pthread_mutex_unlock(&tone_mutex);
+    return -1;
+}
+
+void gpio_tone_write(int pin, int frequency_hz) {
+    if (backend == NULL) {
+        return;
+    }
+    if (backend->tone_write) {
+        backend->tone_write(pin, frequency_hz);
+        return;
+    }
+
+    pthread_mutex_lock(&tone_mutex);
+    SoftTone* tone = pin >= 0 ? find_tone(pin) : NULL;
+    if (tone) {
+        tone->frequency_hz = frequency_hz > 0 ? frequency_hz : 0;
+        pthread_cond_signal(&tone->cond);
+    }
+    pthread_mutex_unlock(&tone_mutex);
+}
+
+void gpio_tone_stop(int pin) {
+    if (backend == NULL) {
+        return;
+    }
+    if (backend->tone_stop) {
+        backend->tone_stop(pin);
+        return;
+    }
+
+    pthread_mutex_lock(&tone_mutex);
+    SoftTone* tone = pin >= 0 ? find_tone(pin) : NULL;
+    if (tone == NULL) {
+        pthread_mutex_unlock(&tone_mutex);
+        return;
+    }
+    tone->running = false;
+    pthread_cond_signal(&tone->cond);
+    pthread_mutex_unlock(&tone_mutex);
+
+    pthread_join(tone->thread, NULL);
+
+    pthread_mutex_lock(&tone_mutex);
+    pthread_cond_destroy(&tone->cond);
+    GpioLines* lines = tone->lines;
+    tone->lines = NULL;
+    tone->pin = -1;
+    pthread_mutex_unlock(&tone_mutex);
+
+    gpio_release(lines);
+}
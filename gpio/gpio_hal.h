@@ -0,0 +1,88 @@
+#ifndef GPIO_HAL_H
+#define GPIO_HAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// GPIO 하드웨어 추상화 (핀 번호는 BCM)
+// 디바이스 라이브러리(led, buzzer, 7segment, light_sensor)는 wiringPi를 직접 부르지 않고 이 API만 쓴다.
+// 백엔드는 gpio_init에서 이름으로 고른다:
+//   wiringpi - wiringPi (핀마다 쓰기, 0-31번 핀은 /dev/gpiomem 마스크 쓰기)
+//   gpiod    - libgpiod v2 문자 장치 (/dev/gpiochipN, 요청 하나의 핀을 ioctl 한 번에 쓰기, 에지 이벤트 fd)
+//   sim      - 하드웨어 없는 시뮬레이션 (쓰기 / PWM / 톤 기록, 입력 주입, gpio_sim.h)
+//
+// 핀은 요청(GpioLines) 단위로 잡는다. 한 요청의 핀들은 gpio_write_mask 한 번에 함께 바뀌고,
+// 입력 요청의 에지 이벤트는 poll할 수 있는 fd와 여러 개를 한 번에 읽는 gpio_read_events로 받는다.
+
+#define GPIO_MAX_PIN        63      // 마스크는 핀 번호 비트 (uint64_t)
+#define GPIO_MAX_LINES      16      // 요청 하나에 넣을 수 있는 핀 수
+
+typedef enum {
+    GPIO_EDGE_NONE,
+    GPIO_EDGE_RISING,
+    GPIO_EDGE_FALLING,
+    GPIO_EDGE_BOTH
+} GpioEdge;
+
+// 에지 이벤트 (시각은 CLOCK_MONOTONIC ns)
+typedef struct {
+    int pin;
+    int level;                  // 에지 뒤 레벨 (1 = 상승 에지)
+    uint64_t timestamp_ns;
+} GpioEvent;
+
+typedef struct GpioLines GpioLines;
+
+// 백엔드 초기화. name이 NULL이면 환경 변수 GPIO_BACKEND, 없으면 빌드 기본값 (wiringpi, wiringPi 없이 빌드하면 sim). 성공 시 0
+// 디바이스 라이브러리를 초기화하기 전에 main에서 한 번 호출한다.
+int gpio_init(const char* name);
+
+void gpio_cleanup(void);
+
+// 초기화된 백엔드 이름 (초기화 전이면 NULL)
+const char* gpio_backend(void);
+
+// 출력 핀 묶음 요청 (모두 LOW로 시작). 실패 시 NULL
+GpioLines* gpio_request_output(const int* pins, int count);
+
+// 입력 핀 요청. edge가 GPIO_EDGE_NONE이 아니면 에지 이벤트를 모은다. 실패 시 NULL
+GpioLines* gpio_request_input(int pin, GpioEdge edge);
+
+// 출력 핀은 LOW로 두고 놓는다
+void gpio_release(GpioLines* lines);
+
+// set / clear: 핀 번호 비트마스크 (요청에 없는 핀은 무시). 끄는 핀을 켜는 핀보다 늦게 바꾸지 않는다
+void gpio_write_mask(GpioLines* lines, uint64_t set, uint64_t clear);
+
+void gpio_write(GpioLines* lines, int pin, int level);
+
+// 0 / 1, 실패 시 -1
+int gpio_read(GpioLines* lines, int pin);
+
+// 에지 이벤트가 쌓이면 읽기 가능해지는 fd (poll / epoll용). 에지 요청이 아니면 -1
+int gpio_event_fd(GpioLines* lines);
+
+// 쌓인 에지 이벤트를 최대 max개 읽는다 (기다리지 않음). 읽은 수, 실패 시 -1
+// 요청 하나의 이벤트는 한 스레드에서만 읽는다.
+int gpio_read_events(GpioLines* lines, GpioEvent* events, int max);
+
+// 하드웨어 PWM 핀 (BCM 12, 13, 18, 19)이면 true
+bool gpio_pwm_supported(int pin);
+
+int gpio_pwm_setup(int pin);
+
+// 주기 / HIGH 시간 (ns). period_ns 0이면 출력을 끈다. 성공 시 0
+int gpio_pwm_set(int pin, uint32_t period_ns, uint32_t duty_ns);
+
+void gpio_pwm_release(int pin);
+
+// 소프트웨어 톤 (duty 50% 구형파). 재생하는 동안만 스레드를 쓴다. 성공 시 0
+int gpio_tone_start(int pin);
+
+// 0 = 소리 끔
+void gpio_tone_write(int pin, int frequency_hz);
+
+// 스레드를 멈추고 핀을 LOW로
+void gpio_tone_stop(int pin);
+
+#endif // GPIO_HAL_H
@@ -0,0 +1,637 @@
+#include "gpio_backend.h"
+#include "gpio_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+// 시뮬레이션 백엔드 (하드웨어 없이 서버 전체를 돌리는 CI / 부하 시험용)
+// - 핀 레벨은 levels 비트마스크 하나. 출력 쓰기, PWM / 톤 변경, 입력 변화를 sim_mutex 안에서
+//   시각과 함께 기록하므로 트레이스 순서가 곧 적용 순서다.
+// - 입력: gpio_sim_inject 또는 GPIO_SIM_SCRIPT 스크립트 스레드. 레벨이 바뀌면 에지 요청의
+//   링 버퍼에 이벤트를 넣고 eventfd를 깨운다 (wiringpi 백엔드의 인터럽트 경로와 같은 모양).
+// - 지연: 연산마다 정한 시간만큼 호출한 스레드에서 바쁜 대기 (잠그기 전이므로 여러 스레드가 함께 기다릴 수 있다).
+// - 톤은 HAL 톤 스레드 대신 주파수 변경만 기록한다 (반 주기마다 쓰기가 트레이스를 채우지 않도록).
+
+#define TRACE_ENV           "GPIO_SIM_TRACE"
+#define SCRIPT_ENV          "GPIO_SIM_SCRIPT"
+#define LATENCY_ENV         "GPIO_SIM_LATENCY"
+#define TRACE_BUFFER_SIZE   (64 * 1024)
+#define EVENT_RING_SIZE     64          // 2의 거듭제곱
+
+typedef struct {
+    int fd;                             // eventfd
+    GpioEvent ring[EVENT_RING_SIZE];    // sim_mutex로 보호
+    unsigned int head;
+    unsigned int tail;
+} SimQueue;
+
+// 스크립트 한 줄: 시작 기준 at_ms에 pin을 level로
+typedef struct {
+    uint32_t at_ms;
+    int pin;
+    int level;
+} ScriptStep;
+
+static pthread_mutex_t sim_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool active = false;
+static uint64_t start_ns;
+static uint64_t levels;
+static uint64_t driven;                 // 출력 / PWM / 톤으로 쓰는 핀
+static GpioLines* edge_lines[GPIO_MAX_PIN + 1];
+static GpioSimStats stats;
+static GpioSimHook hook;
+static void* hook_data;
+static FILE* trace;
+
+static _Atomic uint32_t latency_ns[GPIO_SIM_OP_COUNT];
+
+static pthread_mutex_t script_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t script_cond;
+static pthread_t script_thread;
+static bool script_running = false;
+static ScriptStep* script_steps;
+static size_t script_count;
+static uint32_t script_loop_ms;         // 0 = 한 번만
+
+static const char* const OP_NAMES[GPIO_SIM_OP_COUNT] = {
+    [GPIO_SIM_OP_WRITE] = "write",
+    [GPIO_SIM_OP_READ] = "read",
+    [GPIO_SIM_OP_PWM] = "pwm",
+    [GPIO_SIM_OP_TONE] = "tone",
+    [GPIO_SIM_OP_INPUT] = "input"
+};
+
+// ---------------------------------------------------------------------------
+// 기록 / 지연
+// ---------------------------------------------------------------------------
+static void model_latency(GpioSimOp op) {
+    uint32_t ns = atomic_load_explicit(&latency_ns[op], memory_order_relaxed);
+    if (ns == 0) {
+        return;
+    }
+
+    uint64_t until = gpio_now_ns() + ns;
+    while (gpio_now_ns() < until) {
+    }
+}
+
+// sim_mutex를 잡고 부른다
+static void record(GpioSimRecord* r) {
+    r->timestamp_ns = gpio_now_ns() - start_ns;
+    stats.ops[r->op]++;
+
+    if (trace) {
+        unsigned long long t = (unsigned long long)r->timestamp_ns;
+        switch (r->op) {
+        case GPIO_SIM_OP_WRITE:
+            fprintf(trace, "t_ns=%llu op=write set=0x%llx clear=0x%llx\n", t,
+                    (unsigned long long)r->set, (unsigned long long)r->clear);
+            break;
+        case GPIO_SIM_OP_PWM:
+            fprintf(trace, "t_ns=%llu op=pwm pin=%d period_ns=%u duty_ns=%u\n", t,
+                    r->pin, r->period_ns, r->duty_ns);
+            break;
+        case GPIO_SIM_OP_TONE:
+            fprintf(trace, "t_ns=%llu op=tone pin=%d hz=%d\n", t, r->pin, r->frequency_hz);
+            break;
+        case GPIO_SIM_OP_INPUT:
+            fprintf(trace, "t_ns=%llu op=input pin=%d level=%d\n", t, r->pin, r->level);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (hook) {
+        hook(r, hook_data);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 환경 변수
+// ---------------------------------------------------------------------------
+static int parse_latency(const char* text) {
+    char* end;
+    unsigned long value = strtoul(text, &end, 10);
+
+    // 숫자 하나: 읽기 / 쓰기 / PWM / 톤 모두
+    if (end != text && *end == '\0') {
+        for (int op = 0; op < GPIO_SIM_OP_COUNT; op++) {
+            if (op != GPIO_SIM_OP_INPUT) {
+                atomic_store(&latency_ns[op], (uint32_t)value);
+            }
+        }
+        return 0;
+    }
+
+    // op=ns,op=ns...
+    const char* p = text;
+    while (*p) {
+        int op;
+        size_t len = strcspn(p, "=");
+        for (op = 0; op < GPIO_SIM_OP_COUNT; op++) {
+            if (op != GPIO_SIM_OP_INPUT && strlen(OP_NAMES[op]) == len &&
+                strncmp(p, OP_NAMES[op], len) == 0) {
+                break;
+            }
+        }
+        if (op == GPIO_SIM_OP_COUNT || p[len] != '=') {
+            return -1;
+        }
+
+        p += len + 1;
+        value = strtoul(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0')) {
+            return -1;
+        }
+        atomic_store(&latency_ns[op], (uint32_t)value);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return 0;
+}
+
+// 한 줄에 "<ms> <pin> <level>" 또는 "loop <ms>". '#' 뒤는 주석. 시각은 줄어들지 않아야 한다
+static int load_script(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "GPIO sim: cannot open script %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    char line[256];
+    int line_no = 0;
+    size_t capacity = 0;
+    uint32_t last_ms = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        line_no++;
+        line[strcspn(line, "#\n")] = '\0';
+
+        char word[16];
+        unsigned int at_ms, loop_ms;
+        int pin, level, used;
+        if (sscanf(line, " %15s%n", word, &used) != 1) {
+            continue;
+        }
+        if (strcmp(word, "loop") == 0) {
+            if (sscanf(line + used, "%u", &loop_ms) != 1 || loop_ms == 0 || loop_ms < last_ms) {
+                goto invalid;
+            }
+            script_loop_ms = loop_ms;
+            continue;
+        }
+        if (sscanf(line, "%u %d %d", &at_ms, &pin, &level) != 3 || pin < 0 || pin > GPIO_MAX_PIN ||
+            (level != 0 && level != 1) || at_ms < last_ms || script_loop_ms) {
+            goto invalid;
+        }
+
+        if (script_count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            ScriptStep* steps = realloc(script_steps, capacity * sizeof(ScriptStep));
+            if (steps == NULL) {
+                goto fail;
+            }
+            script_steps = steps;
+        }
+        script_steps[script_count++] = (ScriptStep){ at_ms, pin, level };
+        last_ms = at_ms;
+    }
+
+    fclose(file);
+    return 0;
+
+invalid:
+    fprintf(stderr, "GPIO sim: %s:%d: expected \"<ms> <pin> <0|1>\" or \"loop <ms>\" in time order\n",
+            path, line_no);
+fail:
+    fclose(file);
+    free(script_steps);
+    script_steps = NULL;
+    script_count = 0;
+    script_loop_ms = 0;
+    return -1;
+}
+
+static void* script_loop(void* arg) {
+    (void)arg;
+    uint64_t base = start_ns;
+    size_t next = 0;
+
+    pthread_mutex_lock(&script_mutex);
+    while (script_running) {
+        if (next == script_count) {
+            if (script_loop_ms == 0) {
+                pthread_cond_wait(&script_cond, &script_mutex);
+                continue;
+            }
+            base += (uint64_t)script_loop_ms * 1000000ULL;
+            next = 0;
+        }
+
+        uint64_t due = base + (uint64_t)script_steps[next].at_ms * 1000000ULL;
+        struct timespec ts = {
+            .tv_sec = (time_t)(due / 1000000000ULL),
+            .tv_nsec = (long)(due % 1000000000ULL)
+        };
+        if (pthread_cond_timedwait(&script_cond, &script_mutex, &ts) != ETIMEDOUT) {
+            continue;
+        }
+
+        ScriptStep step = script_steps[next++];
+        pthread_mutex_unlock(&script_mutex);
+        gpio_sim_inject(step.pin, step.level);
+        pthread_mutex_lock(&script_mutex);
+    }
+    pthread_mutex_unlock(&script_mutex);
+    return NULL;
+}
+
+static int start_script(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&script_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    script_running = true;
+    if (pthread_create(&script_thread, NULL, script_loop, NULL) != 0) {
+        script_running = false;
+        pthread_cond_destroy(&script_cond);
+        return -1;
+    }
+    return 0;
+}
+
+static void stop_script(void) {
+    if (script_running) {
+        pthread_mutex_lock(&script_mutex);
+        script_running = false;
+        pthread_cond_signal(&script_cond);
+        pthread_mutex_unlock(&script_mutex);
+
+        pthread_join(script_thread, NULL);
+        pthread_cond_destroy(&script_cond);
+    }
+
+    free(script_steps);
+    script_steps = NULL;
+    script_count = 0;
+    script_loop_ms = 0;
+}
+
+// ---------------------------------------------------------------------------
+// 초기화
+// ---------------------------------------------------------------------------
+static int sim_init(void) {
+    const char* trace_path = getenv(TRACE_ENV);
+    const char* script_path = getenv(SCRIPT_ENV);
+    const char* latency = getenv(LATENCY_ENV);
+
+    for (int op = 0; op < GPIO_SIM_OP_COUNT; op++) {
+        atomic_store(&latency_ns[op], 0);
+    }
+    if (latency && latency[0] && parse_latency(latency) != 0) {
+        fprintf(stderr, "GPIO sim: invalid %s=%s (use <ns> or write=<ns>,read=<ns>,pwm=<ns>,tone=<ns>)\n",
+                LATENCY_ENV, latency);
+        return -1;
+    }
+
+    if (script_path && script_path[0] && load_script(script_path) != 0) {
+        return -1;
+    }
+
+    if (trace_path && trace_path[0]) {
+        trace = strcmp(trace_path, "-") == 0 ? stderr : fopen(trace_path, "w");
+        if (trace == NULL) {
+            fprintf(stderr, "GPIO sim: cannot open trace %s: %s\n", trace_path, strerror(errno));
+            stop_script();
+            return -1;
+        }
+        if (trace != stderr) {
+            setvbuf(trace, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+        }
+    }
+
+    pthread_mutex_lock(&sim_mutex);
+    start_ns = gpio_now_ns();
+    levels = 0;
+    driven = 0;
+    memset(&stats, 0, sizeof(stats));
+    active = true;
+    pthread_mutex_unlock(&sim_mutex);
+
+    if (script_count > 0 && start_script() != 0) {
+        fprintf(stderr, "GPIO sim: failed to start script thread\n");
+        stop_script();
+        pthread_mutex_lock(&sim_mutex);
+        active = false;
+        pthread_mutex_unlock(&sim_mutex);
+        if (trace && trace != stderr) {
+            fclose(trace);
+        }
+        trace = NULL;
+        return -1;
+    }
+
+    printf("GPIO sim: trace=%s script=%s (%zu steps%s) latency write=%uns read=%uns pwm=%uns tone=%uns\n",
+           trace ? trace_path : "off", script_count ? script_path : "off", script_count,
+           script_loop_ms ? ", looping" : "",
+           atomic_load(&latency_ns[GPIO_SIM_OP_WRITE]), atomic_load(&latency_ns[GPIO_SIM_OP_READ]),
+           atomic_load(&latency_ns[GPIO_SIM_OP_PWM]), atomic_load(&latency_ns[GPIO_SIM_OP_TONE]));
+    return 0;
+}
+
+static void sim_cleanup(void) {
+    stop_script();
+
+    pthread_mutex_lock(&sim_mutex);
+    active = false;
+    hook = NULL;
+    hook_data = NULL;
+    if (trace) {
+        if (trace == stderr) {
+            fflush(trace);
+        } else {
+            fclose(trace);
+        }
+        trace = NULL;
+    }
+
+    // CI가 한 줄로 확인할 수 있게 합계를 남긴다
+    printf("gpio_sim writes=%llu reads=%llu pwm=%llu tone=%llu inputs=%llu edges=%llu dropped=%llu\n",
+           (unsigned long long)stats.ops[GPIO_SIM_OP_WRITE],
+           (unsigned long long)stats.ops[GPIO_SIM_OP_READ],
+           (unsigned long long)stats.ops[GPIO_SIM_OP_PWM],
+           (unsigned long long)stats.ops[GPIO_SIM_OP_TONE],
+           (unsigned long long)stats.ops[GPIO_SIM_OP_INPUT],
+           (unsigned long long)stats.edges,
+           (unsigned long long)stats.dropped);
+    fflush(stdout);
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+// ---------------------------------------------------------------------------
+// 핀 요청
+// ---------------------------------------------------------------------------
+static int sim_request(GpioLines* lines) {
+    int result = 0;
+
+    pthread_mutex_lock(&sim_mutex);
+    if (lines->output) {
+        driven |= lines->mask;
+        levels &= ~lines->mask;
+        pthread_mutex_unlock(&sim_mutex);
+        return 0;
+    }
+
+    int pin = lines->pins[0];
+    if (lines->edge != GPIO_EDGE_NONE) {
+        SimQueue* queue = NULL;
+        if (edge_lines[pin] != NULL) {
+            fprintf(stderr, "GPIO %d: edge events already requested\n", pin);
+            result = -1;
+        } else if ((queue = calloc(1, sizeof(SimQueue))) == NULL ||
+                   (queue->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+            free(queue);
+            result = -1;
+        } else {
+            lines->priv = queue;
+            edge_lines[pin] = lines;
+        }
+    }
+    pthread_mutex_unlock(&sim_mutex);
+    return result;
+}
+
+static void sim_release(GpioLines* lines) {
+    pthread_mutex_lock(&sim_mutex);
+    if (lines->output) {
+        driven &= ~lines->mask;
+    } else if (lines->priv) {
+        SimQueue* queue = lines->priv;
+        edge_lines[lines->pins[0]] = NULL;
+        close(queue->fd);
+        free(queue);
+        lines->priv = NULL;
+    }
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+static void sim_write_mask(GpioLines* lines, uint64_t set, uint64_t clear) {
+    (void)lines;
+    model_latency(GPIO_SIM_OP_WRITE);
+
+    pthread_mutex_lock(&sim_mutex);
+    levels = (levels & ~clear) | set;
+    GpioSimRecord r = { .op = GPIO_SIM_OP_WRITE, .pin = -1, .set = set, .clear = clear };
+    record(&r);
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+static int sim_read(GpioLines* lines, int pin) {
+    (void)lines;
+    model_latency(GPIO_SIM_OP_READ);
+
+    pthread_mutex_lock(&sim_mutex);
+    int level = (int)((levels >> pin) & 1);
+    stats.ops[GPIO_SIM_OP_READ]++;
+    pthread_mutex_unlock(&sim_mutex);
+    return level;
+}
+
+// ---------------------------------------------------------------------------
+// 에지 이벤트
+// ---------------------------------------------------------------------------
+static int sim_event_fd(GpioLines* lines) {
+    SimQueue* queue = lines->priv;
+    return queue->fd;
+}
+
+static int sim_read_events(GpioLines* lines, GpioEvent* events, int max) {
+    SimQueue* queue = lines->priv;
+    uint64_t count;
+    int n = 0;
+
+    // 카운터를 먼저 비우고 꺼낸다 (그 사이에 들어온 이벤트는 다시 fd를 깨운다)
+    ssize_t ret = read(queue->fd, &count, sizeof(count));
+    (void)ret;
+
+    pthread_mutex_lock(&sim_mutex);
+    while (n < max && queue->tail != queue->head) {
+        events[n++] = queue->ring[queue->tail++ & (EVENT_RING_SIZE - 1)];
+    }
+    bool remaining = queue->tail != queue->head;
+    pthread_mutex_unlock(&sim_mutex);
+
+    if (remaining) {
+        uint64_t one = 1;
+        ret = write(queue->fd, &one, sizeof(one));
+    }
+    return n;
+}
+
+// sim_mutex를 잡고 부른다
+static void push_edge(int pin, int level, uint64_t timestamp_ns) {
+    GpioLines* lines = edge_lines[pin];
+    if (lines == NULL) {
+        return;
+    }
+    if ((level && lines->edge == GPIO_EDGE_FALLING) || (!level && lines->edge == GPIO_EDGE_RISING)) {
+        return;
+    }
+
+    // 가득 차면 가장 오래된 이벤트를 버린다
+    SimQueue* queue = lines->priv;
+    if (queue->head - queue->tail == EVENT_RING_SIZE) {
+        queue->tail++;
+        stats.dropped++;
+    }
+    queue->ring[queue->head++ & (EVENT_RING_SIZE - 1)] = (GpioEvent){
+        .pin = pin,
+        .level = level,
+        .timestamp_ns = timestamp_ns
+    };
+    stats.edges++;
+
+    uint64_t one = 1;
+    ssize_t ret = write(queue->fd, &one, sizeof(one));
+    (void)ret;
+}
+
+// ---------------------------------------------------------------------------
+// PWM / 톤 (값 변경만 기록)
+// ---------------------------------------------------------------------------
+static void set_driven(int pin, bool on) {
+    pthread_mutex_lock(&sim_mutex);
+    if (on) {
+        driven |= 1ULL << pin;
+    } else {
+        driven &= ~(1ULL << pin);
+    }
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+static int sim_pwm_setup(int pin) {
+    set_driven(pin, true);
+    return 0;
+}
+
+static int sim_pwm_set(int pin, uint32_t period_ns, uint32_t duty_ns) {
+    model_latency(GPIO_SIM_OP_PWM);
+
+    pthread_mutex_lock(&sim_mutex);
+    GpioSimRecord r = { .op = GPIO_SIM_OP_PWM, .pin = pin, .period_ns = period_ns, .duty_ns = duty_ns };
+    record(&r);
+    pthread_mutex_unlock(&sim_mutex);
+    return 0;
+}
+
+static void sim_pwm_release(int pin) {
+    sim_pwm_set(pin, 0, 0);
+    set_driven(pin, false);
+}
+
+static int sim_tone_start(int pin) {
+    set_driven(pin, true);
+    return 0;
+}
+
+static void sim_tone_write(int pin, int frequency_hz) {
+    model_latency(GPIO_SIM_OP_TONE);
+
+    pthread_mutex_lock(&sim_mutex);
+    GpioSimRecord r = { .op = GPIO_SIM_OP_TONE, .pin = pin, .frequency_hz = frequency_hz > 0 ? frequency_hz : 0 };
+    record(&r);
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+static void sim_tone_stop(int pin) {
+    sim_tone_write(pin, 0);
+    set_driven(pin, false);
+}
+
+const GpioBackend gpio_backend_sim = {
+    .name = "sim",
+    .init = sim_init,
+    .cleanup = sim_cleanup,
+    .request = sim_request,
+    .release = sim_release,
+    .write_mask = sim_write_mask,
+    .read = sim_read,
+    .event_fd = sim_event_fd,
+    .read_events = sim_read_events,
+    .pwm_setup = sim_pwm_setup,
+    .pwm_set = sim_pwm_set,
+    .pwm_release = sim_pwm_release,
+    .tone_start = sim_tone_start,
+    .tone_write = sim_tone_write,
+    .tone_stop = sim_tone_stop
+};
+
+// ---------------------------------------------------------------------------
+// 공개 API (gpio_sim.h)
+// ---------------------------------------------------------------------------
+int gpio_sim_inject(int pin, int level) {
+    if (pin < 0 || pin > GPIO_MAX_PIN) {
+        return -1;
+    }
+    uint64_t bit = 1ULL << pin;
+    level = level ? 1 : 0;
+
+    pthread_mutex_lock(&sim_mutex);
+    if (!active || (driven & bit)) {
+        pthread_mutex_unlock(&sim_mutex);
+        return -1;
+    }
+    if ((int)((levels >> pin) & 1) != level) {
+        levels ^= bit;
+        GpioSimRecord r = { .op = GPIO_SIM_OP_INPUT, .pin = pin, .level = level };
+        record(&r);
+        push_edge(pin, level, start_ns + r.timestamp_ns);
+    }
+    pthread_mutex_unlock(&sim_mutex);
+    return 0;
+}
+
+uint64_t gpio_sim_levels(void) {
+    pthread_mutex_lock(&sim_mutex);
+    uint64_t result = active ? levels : 0;
+    pthread_mutex_unlock(&sim_mutex);
+    return result;
+}
+
+void gpio_sim_set_hook(GpioSimHook new_hook, void* user_data) {
+    pthread_mutex_lock(&sim_mutex);
+    if (active) {
+        hook = new_hook;
+        hook_data = user_data;
+    }
+    pthread_mutex_unlock(&sim_mutex);
+}
+
+int gpio_sim_set_latency(GpioSimOp op, uint32_t ns) {
+    if (op < 0 || op >= GPIO_SIM_OP_COUNT || op == GPIO_SIM_OP_INPUT) {
+        return -1;
+    }
+    atomic_store(&latency_ns[op], ns);
+    return 0;
+}
+
+void gpio_sim_get_stats(GpioSimStats* out) {
+    if (out == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&sim_mutex);
+    if (active) {
+        *out = stats;
+    } else {
+        memset(out, 0, sizeof(*out));
+    }
+    pthread_mutex_unlock(&sim_mutex);
+}
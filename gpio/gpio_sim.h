@@ -0,0 +1,61 @@
+#ifndef GPIO_SIM_H
+#define GPIO_SIM_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// 시뮬레이션 백엔드("sim") 전용 API
+// 하드웨어 없이(x86 CI 등) 서버 전체를 돌리기 위한 백엔드. 핀 레벨은 메모리에만 있고,
+// 출력 쓰기 / PWM / 톤 변경 / 입력 변화를 모두 gpio_init 기준 시각(ns)과 함께 기록한다.
+// 다른 백엔드로 초기화했으면 아래 함수는 아무것도 하지 않는다 (-1 / 0 반환).
+//
+// 환경 변수 (gpio_init에서 읽음):
+//   GPIO_SIM_TRACE=<파일>     기록을 한 줄에 하나씩 key=value로 씀 ("-"이면 stderr)
+//   GPIO_SIM_SCRIPT=<파일>    입력 스크립트 ("<ms> <pin> <level>" 줄, "loop <ms>"로 반복)
+//   GPIO_SIM_LATENCY=<ns>     연산마다 바쁜 대기로 흉내 낼 지연 (예: 2000, write=500,pwm=40000)
+
+typedef enum {
+    GPIO_SIM_OP_WRITE,          // 출력 핀 쓰기
+    GPIO_SIM_OP_READ,           // 입력 읽기 (세기와 지연만, 기록하지 않음)
+    GPIO_SIM_OP_PWM,            // PWM 주기 / duty 변경
+    GPIO_SIM_OP_TONE,           // 톤 주파수 변경
+    GPIO_SIM_OP_INPUT,          // 주입한 입력 레벨 변화
+    GPIO_SIM_OP_COUNT
+} GpioSimOp;
+
+typedef struct {
+    GpioSimOp op;
+    uint64_t timestamp_ns;      // gpio_init 기준 CLOCK_MONOTONIC
+    int pin;                    // WRITE는 -1
+    uint64_t set;               // WRITE: 켠 핀 / 끈 핀 비트
+    uint64_t clear;
+    uint32_t period_ns;         // PWM (0 = 꺼짐)
+    uint32_t duty_ns;
+    int frequency_hz;           // TONE (0 = 소리 끔)
+    int level;                  // INPUT
+} GpioSimRecord;
+
+typedef struct {
+    uint64_t ops[GPIO_SIM_OP_COUNT];    // 연산별 횟수
+    uint64_t edges;                     // 에지 요청에 넣은 이벤트
+    uint64_t dropped;                   // 읽기 전에 큐가 넘쳐 버린 이벤트
+} GpioSimStats;
+
+// 기록마다 불린다 (기록 순서대로, 내부 잠금을 잡은 채로 부르므로 짧게)
+typedef void (*GpioSimHook)(const GpioSimRecord* record, void* user_data);
+
+// 입력 핀 레벨을 바꾼다. 레벨이 바뀌면 그 핀의 에지 요청에 이벤트를 넣는다
+// 성공 시 0, sim 백엔드가 아니거나 출력으로 쓰는 핀이면 -1
+int gpio_sim_inject(int pin, int level);
+
+// 모든 핀의 현재 레벨 (핀 번호 비트)
+uint64_t gpio_sim_levels(void);
+
+void gpio_sim_set_hook(GpioSimHook hook, void* user_data);
+
+// 연산 하나의 지연 (ns, 0 = 없음). GPIO_SIM_LATENCY 대신 코드에서 정할 때
+int gpio_sim_set_latency(GpioSimOp op, uint32_t latency_ns);
+
+void gpio_sim_get_stats(GpioSimStats* stats);
+
+#endif // GPIO_SIM_H
@@ -0,0 +1,349 @@
+#ifdef GPIO_HAVE_WIRINGPI
+
+#include "gpio_backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <wiringPi.h>
+
+// wiringPi 백엔드
+// - 출력: 0-31번 핀만 든 요청은 /dev/gpiomem의 GPSET0 / GPCLR0에 한 번씩 써서 여러 핀을 함께 바꾸고,
+//   gpiomem을 못 열면 핀마다 digitalWrite. 레지스터 배치는 BCM2835 계열(BCM2835/2836/2837/2711)만 같으므로
+//   /proc/device-tree/compatible로 SoC를 확인한 뒤에만 연다 (Pi 5의 BCM2712 등은 digitalWrite).
+// - 에지 이벤트: wiringPiISR의 인터럽트 스레드가 이벤트를 요청의 링 버퍼에 넣고 eventfd를 깨운다.
+//   wiringPiISR 콜백에는 인자가 없어 핀마다 트램펄린 함수를 두며 (헤더의 GPIO 0-27),
+//   등록한 ISR은 해제할 수 없으므로 핀의 큐와 eventfd는 프로세스가 끝날 때까지 두고 다시 요청하면 재사용한다.
+//   요청을 놓으면 큐를 끄고 비우기만 한다 (트램펄린은 GpioLines를 보지 않는다).
+// - PWM: 19.2MHz를 PWM_CLOCK_DIVISOR로 나눈 1.2MHz 카운터. pwmSetRange는 두 채널에 함께 적용되므로
+//   주기가 다른 PWM 출력 두 개(예: LED와 PWM 부저)는 동시에 쓸 수 없다.
+// - 톤: 백엔드 톤을 두지 않고 gpio_hal.c의 소프트웨어 톤 스레드를 쓴다. wiringPi softTone은 소리가 없어도
+//   1ms마다 깨어나지만 HAL 톤 스레드는 주파수가 0이면 잠들므로 톤 출력을 계속 잡아 두어도 대기 중 CPU를 쓰지 않는다.
+
+#define GPIOMEM_PATH        "/dev/gpiomem"
+#define COMPATIBLE_PATH     "/proc/device-tree/compatible"
+#define GPIOMEM_SIZE        4096
+#define GPIO_SET0           (0x1C / 4)
+#define GPIO_CLR0           (0x28 / 4)
+
+#define PWM_CLOCK_DIVISOR   16
+#define PWM_COUNTER_HZ      (19200000 / PWM_CLOCK_DIVISOR)
+
+#define ISR_PIN_COUNT       28
+#define EVENT_RING_SIZE     64          // 2의 거듭제곱
+
+static volatile uint32_t* gpio_regs = NULL;
+static unsigned int pwm_range = 0;
+
+// 에지를 쓰는 핀마다 하나 (처음 요청할 때 만들고 해제하지 않음)
+typedef struct {
+    int fd;                             // eventfd
+    pthread_mutex_t mutex;
+    bool active;                        // 요청이 잡고 있는 동안만 이벤트를 넣는다 (mutex로 보호)
+    GpioEvent ring[EVENT_RING_SIZE];
+    unsigned int head;
+    unsigned int tail;
+} EventQueue;
+
+static EventQueue* _Atomic isr_queues[ISR_PIN_COUNT];
+
+// ---------------------------------------------------------------------------
+// 초기화
+// ---------------------------------------------------------------------------
+// device tree의 compatible 목록(NUL로 구분된 문자열)에 GPSET0 / GPCLR0 배치가 같은 SoC가 있는지
+static bool soc_has_bcm2835_gpio(void) {
+    static const char* const socs[] = { "brcm,bcm2835", "brcm,bcm2836", "brcm,bcm2837", "brcm,bcm2711" };
+    char buf[512];
+
+    int fd = open(COMPATIBLE_PATH, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0) {
+        return false;
+    }
+    buf[len] = '\0';
+
+    for (const char* entry = buf; entry < buf + len; entry += strlen(entry) + 1) {
+        for (size_t i = 0; i < sizeof(socs) / sizeof(socs[0]); i++) {
+            if (strcmp(entry, socs[i]) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static int gpiomem_open(void) {
+    int fd = open(GPIOMEM_PATH, O_RDWR | O_SYNC | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    void* map = mmap(NULL, GPIOMEM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    gpio_regs = (volatile uint32_t*)map;
+    return 0;
+}
+
+static int wiringpi_init(void) {
+    if (wiringPiSetupGpio() == -1) {
+        fprintf(stderr, "Failed to initialize wiringPi\n");
+        return -1;
+    }
+
+    if (!soc_has_bcm2835_gpio()) {
+        fprintf(stderr, "GPIO: SoC without BCM2835 GPIO registers, writing pins one at a time\n");
+    } else if (gpiomem_open() != 0) {
+        fprintf(stderr, "GPIO: %s unavailable, writing pins one at a time\n", GPIOMEM_PATH);
+    }
+    return 0;
+}
+
+static void wiringpi_cleanup(void) {
+    if (gpio_regs) {
+        munmap((void*)gpio_regs, GPIOMEM_SIZE);
+        gpio_regs = NULL;
+    }
+    pwm_range = 0;
+}
+
+// ---------------------------------------------------------------------------
+// 에지 이벤트
+// ---------------------------------------------------------------------------
+static void isr_dispatch(int pin) {
+    EventQueue* queue = atomic_load(&isr_queues[pin]);
+    if (queue == NULL) {
+        return;
+    }
+
+    GpioEvent event = {
+        .pin = pin,
+        .level = digitalRead(pin),
+        .timestamp_ns = gpio_now_ns()
+    };
+
+    // 가득 차면 가장 오래된 이벤트를 버린다
+    pthread_mutex_lock(&queue->mutex);
+    if (!queue->active) {
+        pthread_mutex_unlock(&queue->mutex);
+        return;
+    }
+    if (queue->head - queue->tail == EVENT_RING_SIZE) {
+        queue->tail++;
+    }
+    queue->ring[queue->head++ & (EVENT_RING_SIZE - 1)] = event;
+    pthread_mutex_unlock(&queue->mutex);
+
+    uint64_t one = 1;
+    ssize_t ret = write(queue->fd, &one, sizeof(one));
+    (void)ret;
+}
+
+#define ISR_PINS(X) \
+    X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13) \
+    X(14) X(15) X(16) X(17) X(18) X(19) X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27)
+
+#define ISR_TRAMPOLINE(n) static void isr_##n(void) { isr_dispatch(n); }
+ISR_PINS(ISR_TRAMPOLINE)
+
+#define ISR_ENTRY(n) isr_##n,
+static void (*const ISR_TRAMPOLINES[ISR_PIN_COUNT])(void) = { ISR_PINS(ISR_ENTRY) };
+
+static int wiringpi_event_fd(GpioLines* lines) {
+    EventQueue* queue = lines->priv;
+    return queue->fd;
+}
+
+static int wiringpi_read_events(GpioLines* lines, GpioEvent* events, int max) {
+    EventQueue* queue = lines->priv;
+    uint64_t count;
+    int n = 0;
+
+    // 카운터를 먼저 비우고 꺼낸다 (그 사이에 들어온 이벤트는 다시 fd를 깨운다)
+    ssize_t ret = read(queue->fd, &count, sizeof(count));
+    (void)ret;
+
+    pthread_mutex_lock(&queue->mutex);
+    while (n < max && queue->tail != queue->head) {
+        events[n++] = queue->ring[queue->tail++ & (EVENT_RING_SIZE - 1)];
+    }
+    bool remaining = queue->tail != queue->head;
+    pthread_mutex_unlock(&queue->mutex);
+
+    if (remaining) {
+        uint64_t one = 1;
+        ret = write(queue->fd, &one, sizeof(one));
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// 핀 요청
+// ---------------------------------------------------------------------------
+static int wiringpi_request(GpioLines* lines) {
+    if (lines->output) {
+        for (int i = 0; i < lines->count; i++) {
+            pinMode(lines->pins[i], OUTPUT);
+            digitalWrite(lines->pins[i], LOW);
+        }
+        return 0;
+    }
+
+    int pin = lines->pins[0];
+    pinMode(pin, INPUT);
+    if (lines->edge == GPIO_EDGE_NONE) {
+        return 0;
+    }
+
+    if (pin >= ISR_PIN_COUNT) {
+        fprintf(stderr, "GPIO %d: edge events unavailable (pins 0-%d)\n", pin, ISR_PIN_COUNT - 1);
+        return -1;
+    }
+
+    // 핀을 다시 요청하면 처음 등록한 큐와 ISR을 그대로 쓴다 (에지 종류는 처음 등록한 것)
+    EventQueue* queue = atomic_load(&isr_queues[pin]);
+    if (queue == NULL) {
+        queue = calloc(1, sizeof(EventQueue));
+        if (queue == NULL) {
+            return -1;
+        }
+        queue->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (queue->fd < 0) {
+            free(queue);
+            return -1;
+        }
+        pthread_mutex_init(&queue->mutex, NULL);
+
+        static const int EDGES[] = {
+            [GPIO_EDGE_RISING] = INT_EDGE_RISING,
+            [GPIO_EDGE_FALLING] = INT_EDGE_FALLING,
+            [GPIO_EDGE_BOTH] = INT_EDGE_BOTH
+        };
+        atomic_store(&isr_queues[pin], queue);
+        if (wiringPiISR(pin, EDGES[lines->edge], ISR_TRAMPOLINES[pin]) < 0) {
+            // 등록에 실패했으면 트램펄린이 불리지 않으므로 바로 정리할 수 있다
+            atomic_store(&isr_queues[pin], NULL);
+            close(queue->fd);
+            pthread_mutex_destroy(&queue->mutex);
+            free(queue);
+            return -1;
+        }
+    }
+
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->active) {
+        pthread_mutex_unlock(&queue->mutex);
+        fprintf(stderr, "GPIO %d: edge events already requested (one request per pin)\n", pin);
+        return -1;
+    }
+    uint64_t stale;
+    ssize_t ret = read(queue->fd, &stale, sizeof(stale));     // 이전 요청을 놓은 뒤 늦게 온 깨우기
+    (void)ret;
+    queue->active = true;
+    pthread_mutex_unlock(&queue->mutex);
+
+    lines->priv = queue;
+    return 0;
+}
+
+static void wiringpi_release(GpioLines* lines) {
+    EventQueue* queue = lines->priv;
+    if (queue == NULL) {
+        return;
+    }
+
+    // 인터럽트 스레드가 아직 큐를 쓰고 있을 수 있으므로 끄고 비우기만 한다 (fd도 닫지 않음).
+    // 끈 뒤에는 이벤트가 들어오지 않고, 늦게 온 eventfd 쓰기는 다음 요청 때 비운다
+    pthread_mutex_lock(&queue->mutex);
+    queue->active = false;
+    queue->tail = queue->head;
+    pthread_mutex_unlock(&queue->mutex);
+
+    uint64_t count;
+    ssize_t ret = read(queue->fd, &count, sizeof(count));
+    (void)ret;
+    lines->priv = NULL;
+}
+
+static void wiringpi_write_mask(GpioLines* lines, uint64_t set, uint64_t clear) {
+    if (gpio_regs && (lines->mask >> 32) == 0) {
+        // 끄는 쪽을 먼저 써야 자리 선택이 바뀔 때 두 자리가 함께 켜지지 않는다
+        if (clear) gpio_regs[GPIO_CLR0] = (uint32_t)clear;
+        if (set) gpio_regs[GPIO_SET0] = (uint32_t)set;
+        return;
+    }
+
+    for (uint64_t bits = clear; bits; bits &= bits - 1) {
+        digitalWrite(__builtin_ctzll(bits), LOW);
+    }
+    for (uint64_t bits = set; bits; bits &= bits - 1) {
+        digitalWrite(__builtin_ctzll(bits), HIGH);
+    }
+}
+
+static int wiringpi_read(GpioLines* lines, int pin) {
+    (void)lines;
+    return digitalRead(pin) ? 1 : 0;
+}
+
+// ---------------------------------------------------------------------------
+// PWM / 톤
+// ---------------------------------------------------------------------------
+static int wiringpi_pwm_setup(int pin) {
+    pinMode(pin, PWM_OUTPUT);
+    pwmSetMode(PWM_MODE_MS);
+    pwmSetClock(PWM_CLOCK_DIVISOR);
+    pwmWrite(pin, 0);
+    return 0;
+}
+
+static int wiringpi_pwm_set(int pin, uint32_t period_ns, uint32_t duty_ns) {
+    if (period_ns == 0) {
+        pwmWrite(pin, 0);
+        return 0;
+    }
+
+    unsigned int range = (unsigned int)(((uint64_t)period_ns * PWM_COUNTER_HZ + 500000000ULL) / 1000000000ULL);
+    if (range < 2) {
+        return -1;
+    }
+    if (range != pwm_range) {
+        pwmSetRange(range);
+        pwm_range = range;
+    }
+    pwmWrite(pin, (int)(((uint64_t)duty_ns * range + period_ns / 2) / period_ns));
+    return 0;
+}
+
+static void wiringpi_pwm_release(int pin) {
+    pwmWrite(pin, 0);
+}
+
+const GpioBackend gpio_backend_wiringpi = {
+    .name = "wiringpi",
+    .init = wiringpi_init,
+    .cleanup = wiringpi_cleanup,
+    .request = wiringpi_request,
+    .release = wiringpi_release,
+    .write_mask = wiringpi_write_mask,
+    .read = wiringpi_read,
+    .event_fd = wiringpi_event_fd,
+    .read_events = wiringpi_read_events,
+    .pwm_setup = wiringpi_pwm_setup,
+    .pwm_set = wiringpi_pwm_set,
+    .pwm_release = wiringpi_pwm_release
+};
+
+#endif // GPIO_HAVE_WIRINGPI
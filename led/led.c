@@ -1,11 +1,17 @@
 #include "led.h"
 #include <stdio.h>
-#include <wiringPi.h>
+#include "gpio_hal.h"
 
 #define PWM_LOW     33
 #define PWM_MEDIUM  66
 #define PWM_HIGH    100
 #define PWM_RANGE   100
+#define PWM_PERIOD_NS   1000000     // 1kHz
+
+// value: 0 ~ PWM_RANGE (LED는 HIGH일 때 꺼진다)
+static void pwm_write(int pin, int value) {
+    gpio_pwm_set(pin, PWM_PERIOD_NS, (uint32_t)(PWM_PERIOD_NS / PWM_RANGE * value));
+}
 
 static int LED_PIN = -1;
 static bool is_initialized = false;
@@ -29,11 +35,10 @@ int led_init(const LedPin* led_pin) {
 
     LED_PIN = led_pin->pin;
 
-	pinMode(LED_PIN, PWM_OUTPUT);
-	pwmSetMode(PWM_MODE_MS);
-	pwmSetRange(PWM_RANGE);
-	pwmSetClock(192);
-	pwmWrite(LED_PIN, PWM_HIGH);
+    if (gpio_pwm_setup(LED_PIN) != 0) {
+        return -1;
+    }
+    pwm_write(LED_PIN, PWM_HIGH);
 
     led_state = false;
     is_initialized = true;
@@ -49,7 +54,7 @@ int led_on(void) {
         return -1;
     }
 
-    pwmWrite(LED_PIN, 0);
+    pwm_write(LED_PIN, 0);
     led_state = true;
 
     return 0;
@@ -61,7 +66,7 @@ int led_off(void) {
         return -1;
     }
 
-    pwmWrite(LED_PIN, PWM_HIGH);
+    pwm_write(LED_PIN, PWM_HIGH);
     led_state = false;
 
     return 0;
@@ -90,7 +95,7 @@ int led_set_brightness(int brightness) {
             return -1;
     }
 
-    pwmWrite(LED_PIN, pwm_value);
+    pwm_write(LED_PIN, pwm_value);
     led_state = true;
 
     return 0;
@@ -105,7 +110,8 @@ void led_cleanup(void) {
         return;
     }
 
-    pwmWrite(LED_PIN, PWM_HIGH);
+    // PWM을 놓으면 출력이 LOW가 되어 LED가 켜지므로 HIGH(꺼짐)로 둔다
+    pwm_write(LED_PIN, PWM_HIGH);
     led_state = false;
     is_initialized = false;
 
@@ -0,0 +1,311 @@
+#include "light_sampler.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+// 센서 라인 샘플러
+// - 샘플러 스레드 하나가 rate_hz 주기로 light_sensor_read()를 호출해 링 버퍼에 기록한다
+// - 필터: 최근 window_ms 동안의 밝음 비율이 bright_percent 이상이면 밝음, dark_percent 이하이면
+//   어두움 후보가 된다 (그 사이 구간은 현재 상태 유지 = 히스테리시스).
+//   후보가 현재 상태와 다른 채로 debounce_ms 동안 유지되어야 상태가 바뀐다.
+// - 링 버퍼는 샘플러 스레드만 쓰고, 읽는 쪽은 슬롯마다 sequence를 확인해 덮어쓰인 슬롯을 건너뛴다.
+//     sequence == 2 * pos + 1 : 쓰는 중
+//     sequence == 2 * pos + 2 : pos번째 샘플 쓰기 완료
+
+#define RING_MASK (LIGHT_SAMPLER_RING_SIZE - 1)
+
+_Static_assert((LIGHT_SAMPLER_RING_SIZE & RING_MASK) == 0,
+               "LIGHT_SAMPLER_RING_SIZE must be a power of two");
+
+typedef struct {
+    atomic_ullong sequence;
+    LightSample sample;
+} SampleSlot;
+
+static SampleSlot ring[LIGHT_SAMPLER_RING_SIZE];
+static atomic_ullong ring_head;             // 다음에 쓸 위치 (= 누적 샘플 수)
+
+static LightSamplerConfig config;
+static LightChangeCallback change_callback = NULL;
+static LightSampleCallback sample_callback = NULL;
+static pthread_t sampler_thread;
+static atomic_bool running;
+static bool started = false;
+
+// 샘플러 스레드가 쓰고 누구나 읽는 값
+static atomic_int filtered_state = -1;     // -1 = 첫 샘플 전
+static atomic_uint ring_bright;             // 링 버퍼 안의 밝음 샘플 수
+static atomic_ulong raw_transitions;
+static atomic_ulong transitions;
+
+// 필터 상태 (샘플러 스레드 전용)
+static unsigned int window_samples;
+static unsigned int window_bright;
+static int last_raw;
+static bool pending;
+static unsigned long long pending_since_ms;
+
+static unsigned long long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000ULL + (unsigned long long)ts.tv_nsec / 1000000ULL;
+}
+
+void light_sampler_default_config(LightSamplerConfig* cfg) {
+    cfg->rate_hz = LIGHT_SAMPLER_DEFAULT_RATE_HZ;
+    cfg->window_ms = LIGHT_SAMPLER_DEFAULT_WINDOW_MS;
+    cfg->debounce_ms = LIGHT_SAMPLER_DEFAULT_DEBOUNCE_MS;
+    cfg->bright_percent = LIGHT_SAMPLER_DEFAULT_BRIGHT_PCT;
+    cfg->dark_percent = LIGHT_SAMPLER_DEFAULT_DARK_PCT;
+}
+
+// 히스테리시스 창과 디바운스를 적용한 다음 상태
+static int filter_sample(int state, unsigned long long filled, unsigned long long now_ms, int raw) {
+    unsigned int percent = (unsigned int)(window_bright * 100ULL / filled);
+    int candidate = state;
+
+    if ((int)percent >= config.bright_percent) {
+        candidate = 1;
+    } else if ((int)percent <= config.dark_percent) {
+        candidate = 0;
+    } else if (state < 0) {
+        candidate = raw;
+    }
+
+    // 첫 샘플은 바로 상태로 정한다
+    if (state < 0 || candidate == state) {
+        pending = false;
+        return candidate;
+    }
+
+    if (!pending) {
+        pending = true;
+        pending_since_ms = now_ms;
+    }
+    if (now_ms - pending_since_ms < (unsigned long long)config.debounce_ms) {
+        return state;
+    }
+
+    pending = false;
+    return candidate;
+}
+
+static void record_sample(int raw) {
+    unsigned long long now_ms = monotonic_ms();
+    unsigned long long pos = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    SampleSlot* slot = &ring[pos & RING_MASK];
+
+    // 창과 링에서 밀려나는 샘플 (덮어쓰기 전에 읽는다)
+    if (pos >= window_samples && ring[(pos - window_samples) & RING_MASK].sample.raw) {
+        window_bright--;
+    }
+    if (pos >= LIGHT_SAMPLER_RING_SIZE && slot->sample.raw) {
+        atomic_fetch_sub_explicit(&ring_bright, 1, memory_order_relaxed);
+    }
+
+    if (raw) {
+        window_bright++;
+        atomic_fetch_add_explicit(&ring_bright, 1, memory_order_relaxed);
+    }
+    if (last_raw >= 0 && raw != last_raw) {
+        atomic_fetch_add_explicit(&raw_transitions, 1, memory_order_relaxed);
+    }
+    last_raw = raw;
+
+    unsigned long long filled = pos + 1 < window_samples ? pos + 1 : window_samples;
+    int state = atomic_load_explicit(&filtered_state, memory_order_relaxed);
+    int next = filter_sample(state, filled, now_ms, raw);
+
+    atomic_store_explicit(&slot->sequence, 2 * pos + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->sample.timestamp_ms = now_ms;
+    slot->sample.raw = (unsigned char)raw;
+    slot->sample.filtered = (unsigned char)next;
+    atomic_store_explicit(&slot->sequence, 2 * pos + 2, memory_order_release);
+    atomic_store_explicit(&ring_head, pos + 1, memory_order_release);
+
+    if (sample_callback) {
+        sample_callback(&slot->sample);
+    }
+
+    if (next != state) {
+        atomic_store_explicit(&filtered_state, next, memory_order_release);
+        if (state >= 0) {
+            atomic_fetch_add_explicit(&transitions, 1, memory_order_relaxed);
+        }
+        if (change_callback) {
+            change_callback(next == 1);
+        }
+    }
+}
+
+static void* sampler_main(void* arg) {
+    (void)arg;
+    long period_ns = 1000000000L / config.rate_hz;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (atomic_load_explicit(&running, memory_order_relaxed)) {
+        int value = light_sensor_read();
+        if (value >= 0) {
+            record_sample(value == 0);
+        }
+
+        next.tv_nsec += period_ns;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+
+        // 주기를 놓쳤으면 몰아서 샘플링하지 않고 지금부터 다시 센다
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > next.tv_sec ||
+            (now.tv_sec == next.tv_sec && now.tv_nsec > next.tv_nsec)) {
+            next = now;
+            continue;
+        }
+
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    return NULL;
+}
+
+int light_sampler_start(const LightSamplerConfig* cfg, LightChangeCallback callback) {
+    if (started) {
+        fprintf(stderr, "Light sampler already running\n");
+        return -1;
+    }
+
+    if (cfg == NULL || cfg->rate_hz < 1 || cfg->rate_hz > 1000 ||
+        cfg->window_ms < 0 || cfg->debounce_ms < 0 ||
+        cfg->dark_percent < 0 || cfg->bright_percent > 100 ||
+        cfg->dark_percent >= cfg->bright_percent) {
+        fprintf(stderr, "Invalid light sampler configuration\n");
+        return -1;
+    }
+
+    if (light_sensor_read() < 0) {
+        return -1;
+    }
+
+    config = *cfg;
+    change_callback = callback;
+
+    window_samples = (unsigned int)((long long)config.window_ms * config.rate_hz / 1000);
+    if (window_samples < 1) {
+        window_samples = 1;
+    } else if (window_samples > LIGHT_SAMPLER_RING_SIZE) {
+        window_samples = LIGHT_SAMPLER_RING_SIZE;
+    }
+    window_bright = 0;
+    last_raw = -1;
+    pending = false;
+
+    memset(ring, 0, sizeof(ring));
+    atomic_store(&ring_head, 0);
+    atomic_store(&filtered_state, -1);
+    atomic_store(&ring_bright, 0);
+    atomic_store(&raw_transitions, 0);
+    atomic_store(&transitions, 0);
+    atomic_store(&running, true);
+
+    if (pthread_create(&sampler_thread, NULL, sampler_main, NULL) != 0) {
+        fprintf(stderr, "Failed to start light sampler thread\n");
+        atomic_store(&running, false);
+        return -1;
+    }
+
+    started = true;
+    printf("Light sampler started (%d Hz, window %d samples, debounce %d ms)\n",
+           config.rate_hz, window_samples, config.debounce_ms);
+    return 0;
+}
+
+void light_sampler_stop(void) {
+    if (!started) {
+        return;
+    }
+
+    atomic_store(&running, false);
+    pthread_join(sampler_thread, NULL);
+    started = false;
+    change_callback = NULL;
+    atomic_store(&filtered_state, -1);
+
+    printf("Light sampler stopped\n");
+}
+
+int light_sampler_set_sample_callback(LightSampleCallback callback) {
+    if (started) {
+        fprintf(stderr, "Light sampler is running; stop it before changing the sample callback\n");
+        return -1;
+    }
+
+    sample_callback = callback;
+    return 0;
+}
+
+bool light_sampler_is_bright(void) {
+    int state = atomic_load_explicit(&filtered_state, memory_order_acquire);
+
+    if (state < 0) {
+        return light_sensor_is_bright();
+    }
+    return state == 1;
+}
+
+int light_sampler_get_stats(LightSamplerStats* stats) {
+    if (stats == NULL) {
+        return -1;
+    }
+
+    unsigned long long head = atomic_load_explicit(&ring_head, memory_order_acquire);
+    unsigned long long in_ring = head < LIGHT_SAMPLER_RING_SIZE ? head : LIGHT_SAMPLER_RING_SIZE;
+    int state = atomic_load_explicit(&filtered_state, memory_order_acquire);
+
+    stats->samples = (unsigned long)head;
+    stats->raw_transitions = atomic_load_explicit(&raw_transitions, memory_order_relaxed);
+    stats->transitions = atomic_load_explicit(&transitions, memory_order_relaxed);
+    stats->duty_cycle = in_ring > 0
+        ? (double)atomic_load_explicit(&ring_bright, memory_order_relaxed) / (double)in_ring
+        : 0.0;
+    stats->is_bright = (state == 1);
+    stats->valid = (state >= 0);
+    return 0;
+}
+
+int light_sampler_read_history(LightSample* samples, int max) {
+    if (samples == NULL || max <= 0) {
+        return 0;
+    }
+
+    unsigned long long head = atomic_load_explicit(&ring_head, memory_order_acquire);
+    unsigned long long count = head < LIGHT_SAMPLER_RING_SIZE ? head : LIGHT_SAMPLER_RING_SIZE;
+    if (count > (unsigned long long)max) {
+        count = (unsigned long long)max;
+    }
+
+    int copied = 0;
+    for (unsigned long long pos = head - count; pos < head; pos++) {
+        SampleSlot* slot = &ring[pos & RING_MASK];
+        unsigned long long seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+
+        if (seq != 2 * pos + 2) {
+            continue;   // 이미 다음 바퀴 샘플로 덮어쓰는 중
+        }
+
+        LightSample sample = slot->sample;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) != seq) {
+            continue;
+        }
+
+        samples[copied++] = sample;
+    }
+
+    return copied;
+}
@@ -0,0 +1,62 @@
+#ifndef LIGHT_SAMPLER_H
+#define LIGHT_SAMPLER_H
+
+#include <stdbool.h>
+#include "light_sensor.h"
+
+// 고정 주기 샘플러: 센서 라인을 일정 주기로 읽어 링 버퍼에 기록하고,
+// 히스테리시스 창과 디바운스를 거친 상태가 바뀔 때만 콜백을 호출한다.
+
+#define LIGHT_SAMPLER_RING_SIZE         1024    // 2의 거듭제곱
+
+#define LIGHT_SAMPLER_DEFAULT_RATE_HZ   100
+#define LIGHT_SAMPLER_DEFAULT_WINDOW_MS 100
+#define LIGHT_SAMPLER_DEFAULT_DEBOUNCE_MS 50
+#define LIGHT_SAMPLER_DEFAULT_BRIGHT_PCT 70
+#define LIGHT_SAMPLER_DEFAULT_DARK_PCT  30
+
+typedef struct {
+    int rate_hz;            // 초당 샘플 수 (1-1000)
+    int window_ms;          // 히스테리시스 창 길이
+    int debounce_ms;        // 새 상태가 이 시간 동안 유지되어야 전환
+    int bright_percent;     // 창 안의 밝음 비율이 이 값 이상이면 밝음
+    int dark_percent;       // 이 값 이하이면 어두움 (그 사이는 현재 상태 유지)
+} LightSamplerConfig;
+
+typedef struct {
+    unsigned long long timestamp_ms;    // CLOCK_MONOTONIC
+    unsigned char raw;                  // 1 = 밝음
+    unsigned char filtered;             // 필터를 거친 상태 (1 = 밝음)
+} LightSample;
+
+// 샘플마다 샘플러 스레드에서 호출 (짧게 끝나야 한다)
+typedef void (*LightSampleCallback)(const LightSample* sample);
+
+typedef struct {
+    unsigned long samples;              // 누적 샘플 수
+    unsigned long raw_transitions;      // 원시 라인의 레벨 변화 수
+    unsigned long transitions;          // 필터를 거친 상태 전환 수
+    double duty_cycle;                  // 링 버퍼 구간에서 밝음 비율 (0.0-1.0)
+    bool is_bright;                     // 필터를 거친 현재 상태
+    bool valid;                         // 첫 샘플 이후 true
+} LightSamplerStats;
+
+void light_sampler_default_config(LightSamplerConfig* config);
+
+// 샘플러 스레드 시작. callback은 필터 상태가 정해지거나 바뀔 때 샘플러 스레드에서 호출된다
+int light_sampler_start(const LightSamplerConfig* config, LightChangeCallback callback);
+
+void light_sampler_stop(void);
+
+// 샘플 콜백 등록 (NULL이면 해제). 샘플러가 멈춰 있을 때만 바꿀 수 있다. 성공 시 0
+int light_sampler_set_sample_callback(LightSampleCallback callback);
+
+// 필터를 거친 현재 상태 (샘플러가 돌고 있지 않으면 원시 값)
+bool light_sampler_is_bright(void);
+
+int light_sampler_get_stats(LightSamplerStats* stats);
+
+// 최근 샘플을 오래된 순서로 최대 max개 복사 (복사한 개수 반환)
+int light_sampler_read_history(LightSample* samples, int max);
+
+#endif // LIGHT_SAMPLER_H
@@ -1,9 +1,105 @@
 #include "light_sensor.h"
 #include <stdio.h>
-#include <wiringPi.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "gpio_hal.h"
+
+#define EVENT_BATCH  16
 
 static int SENSOR_PIN = -1;
 static bool is_initialized = false;
+static GpioLines* sensor_lines = NULL;
+
+static pthread_mutex_t callback_mutex = PTHREAD_MUTEX_INITIALIZER;
+static LightChangeCallback change_callback = NULL;
+static bool edges_enabled = false;
+
+// 이벤트 스레드: GPIO 에지 이벤트 fd를 poll로 기다린다
+static int event_source_fd = -1;
+static int stop_pipe[2] = {-1, -1};
+static pthread_t event_thread;
+static bool event_thread_running = false;
+
+// 에지 처리 (이벤트 스레드). level은 에지 뒤 라인 레벨
+static void sensor_edge(int level) {
+    pthread_mutex_lock(&callback_mutex);
+    LightChangeCallback callback = change_callback;
+    pthread_mutex_unlock(&callback_mutex);
+
+    if (callback) {
+        callback(level == 0);
+    }
+}
+
+// 쌓인 에지를 한 번에 읽어 순서대로 알린다
+static void read_gpio_events(void) {
+    GpioEvent events[EVENT_BATCH];
+    int count = gpio_read_events(sensor_lines, events, EVENT_BATCH);
+
+    for (int i = 0; i < count; i++) {
+        sensor_edge(events[i].level);
+    }
+}
+
+static void* event_loop(void* arg) {
+    (void)arg;
+    struct pollfd fds[2] = {
+        { .fd = event_source_fd, .events = POLLIN },
+        { .fd = stop_pipe[0], .events = POLLIN }
+    };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+
+        read_gpio_events();
+    }
+
+    return NULL;
+}
+
+static int start_event_thread(int fd) {
+    if (fd < 0 || pipe(stop_pipe) != 0) {
+        return -1;
+    }
+
+    event_source_fd = fd;
+    if (pthread_create(&event_thread, NULL, event_loop, NULL) != 0) {
+        close(stop_pipe[0]);
+        close(stop_pipe[1]);
+        stop_pipe[0] = stop_pipe[1] = -1;
+        return -1;
+    }
+
+    event_thread_running = true;
+    return 0;
+}
+
+static void stop_event_thread(void) {
+    if (event_thread_running) {
+        ssize_t ret = write(stop_pipe[1], "x", 1);
+        (void)ret;
+        pthread_join(event_thread, NULL);
+        event_thread_running = false;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        if (stop_pipe[i] >= 0) {
+            close(stop_pipe[i]);
+            stop_pipe[i] = -1;
+        }
+    }
+    event_source_fd = -1;
+}
 
 int light_sensor_init(const LightSensorPin* sensor_pin) {
     if (is_initialized) {
@@ -23,7 +119,11 @@ int light_sensor_init(const LightSensorPin* sensor_pin) {
 
     SENSOR_PIN = sensor_pin->pin;
 
-    pinMode(SENSOR_PIN, INPUT);
+    // 에지 이벤트는 콜백을 등록할 때 켠다
+    sensor_lines = gpio_request_input(SENSOR_PIN, GPIO_EDGE_NONE);
+    if (sensor_lines == NULL) {
+        return -1;
+    }
 
     is_initialized = true;
 
@@ -38,7 +138,7 @@ int light_sensor_read(void) {
         return -1;
     }
 
-    return digitalRead(SENSOR_PIN);
+    return gpio_read(sensor_lines, SENSOR_PIN);
 }
 
 bool light_sensor_is_bright(void) {
@@ -51,11 +151,50 @@ bool light_sensor_is_bright(void) {
     return (value == 0);
 }
 
+int light_sensor_set_callback(LightChangeCallback callback) {
+    if (!is_initialized) {
+        fprintf(stderr, "Light sensor not initialized. Call light_sensor_init() first.\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&callback_mutex);
+    change_callback = callback;
+    pthread_mutex_unlock(&callback_mutex);
+
+    // 에지 요청과 이벤트 스레드는 처음 한 번만 만들고 이후에는 콜백만 바꾼다
+    if (!edges_enabled && callback != NULL) {
+        GpioLines* lines = gpio_request_input(SENSOR_PIN, GPIO_EDGE_BOTH);
+        if (lines == NULL) {
+            fprintf(stderr, "Failed to register light sensor interrupt\n");
+            return -1;
+        }
+        gpio_release(sensor_lines);
+        sensor_lines = lines;
+
+        if (start_event_thread(gpio_event_fd(sensor_lines)) != 0) {
+            fprintf(stderr, "Failed to start light sensor event thread\n");
+            return -1;
+        }
+        edges_enabled = true;
+    }
+
+    return 0;
+}
+
 void light_sensor_cleanup(void) {
     if (!is_initialized) {
         return;
     }
 
+    pthread_mutex_lock(&callback_mutex);
+    change_callback = NULL;
+    pthread_mutex_unlock(&callback_mutex);
+
+    stop_event_thread();
+    gpio_release(sensor_lines);
+    sensor_lines = NULL;
+    edges_enabled = false;
+
     is_initialized = false;
 
     printf("Light sensor cleaned up\n");
@@ -7,12 +7,18 @@ typedef struct {
     int pin;
 } LightSensorPin;
 
+// 밝기 변화(에지) 알림 콜백 - 라이브러리의 이벤트 스레드에서 호출된다
+typedef void (*LightChangeCallback)(bool is_bright);
+
 int light_sensor_init(const LightSensorPin* sensor_pin);
 
 int light_sensor_read(void);
 
 bool light_sensor_is_bright(void);
 
+// 에지 인터럽트 등록 (NULL이면 알림 중단). 성공 시 0
+int light_sensor_set_callback(LightChangeCallback callback);
+
 void light_sensor_cleanup(void);
 
 #endif // LIGHT_SENSOR_H
@@ -0,0 +1,191 @@
+// 스케줄러 벤치마크: 작업마다 스레드를 만드는 기존 방식과 스케줄러 콜백 방식 비교
+// 1) 작업 시작 비용: 작업을 요청한 스레드가 쓰는 시간(submit)과 작업이 실제로 시작되기까지의 지연
+//    - thread: 작업마다 pthread_create + pthread_detach (기존 seg7_counting / play_music_async)
+//    - scheduler: 작업마다 scheduler_add(지금)
+// 2) 주기 틱 오차: TICK_PERIOD_MS 주기로 TICKS번 깨어날 때 각 틱의 간격 오차와 누적 오차(drift)
+//    - thread: 틱마다 상대 시간만큼 잠든다 (기존 sleep(1) / delay(tempo) 루프)
+//    - scheduler: 이전 틱의 예약 시각 + 주기로 다음 틱을 예약
+//
+// 출력 형식 (한 줄 = 한 측정):
+//   scheduler_start mode=<thread|scheduler> ops=<n> submit_ns=<n> start_p50_us=<n> start_p99_us=<n>
+//   scheduler_tick mode=<thread|scheduler> ticks=<n> period_ms=<n> jitter_p50_us=<n> jitter_p99_us=<n> drift_us=<n>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "scheduler.h"
+
+#define START_OPS       2000
+#define TICKS           200
+#define TICK_PERIOD_MS  10
+#define TICK_WORK_US    300     // 틱마다 하는 일 (GPIO 출력, 로그 등)
+
+typedef struct {
+    uint64_t requested_ns;
+    uint64_t started_ns;
+} StartSample;
+
+static StartSample start_samples[START_OPS];
+static atomic_int started_count;
+static uint64_t tick_times[TICKS + 1];
+static atomic_int tick_count;
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void busy_us(unsigned int us) {
+    uint64_t end = scheduler_now_ns() + (uint64_t)us * 1000ULL;
+    while (scheduler_now_ns() < end) {
+    }
+}
+
+static void report_start(const char* mode, uint64_t submit_total_ns) {
+    uint64_t latency[START_OPS];
+    for (int i = 0; i < START_OPS; i++) {
+        latency[i] = start_samples[i].started_ns - start_samples[i].requested_ns;
+    }
+    qsort(latency, START_OPS, sizeof(uint64_t), compare_u64);
+
+    printf("scheduler_start mode=%s ops=%d submit_ns=%llu start_p50_us=%.1f start_p99_us=%.1f\n",
+           mode, START_OPS, (unsigned long long)(submit_total_ns / START_OPS),
+           latency[START_OPS / 2] / 1000.0, latency[(int)(START_OPS * 0.99)] / 1000.0);
+}
+
+static void report_ticks(const char* mode) {
+    uint64_t period_ns = (uint64_t)TICK_PERIOD_MS * 1000000ULL;
+    uint64_t jitter[TICKS];
+
+    for (int i = 0; i < TICKS; i++) {
+        uint64_t interval = tick_times[i + 1] - tick_times[i];
+        jitter[i] = interval > period_ns ? interval - period_ns : period_ns - interval;
+    }
+    qsort(jitter, TICKS, sizeof(uint64_t), compare_u64);
+
+    long long drift = (long long)(tick_times[TICKS] - tick_times[0]) - (long long)(TICKS * period_ns);
+    printf("scheduler_tick mode=%s ticks=%d period_ms=%d jitter_p50_us=%.1f jitter_p99_us=%.1f "
+           "drift_us=%lld\n",
+           mode, TICKS, TICK_PERIOD_MS, jitter[TICKS / 2] / 1000.0,
+           jitter[(int)(TICKS * 0.99)] / 1000.0, drift / 1000);
+}
+
+static void wait_count(atomic_int* counter, int target) {
+    while (atomic_load(counter) < target) {
+        usleep(1000);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 작업 시작 비용
+// ---------------------------------------------------------------------------
+static void* start_thread_func(void* arg) {
+    StartSample* sample = (StartSample*)arg;
+    sample->started_ns = scheduler_now_ns();
+    atomic_fetch_add(&started_count, 1);
+    return NULL;
+}
+
+static void start_callback(void* arg, uint64_t deadline_ns) {
+    (void)deadline_ns;
+    StartSample* sample = (StartSample*)arg;
+    sample->started_ns = scheduler_now_ns();
+    atomic_fetch_add(&started_count, 1);
+}
+
+static void bench_start_thread(void) {
+    uint64_t submit_total = 0;
+    atomic_store(&started_count, 0);
+
+    for (int i = 0; i < START_OPS; i++) {
+        pthread_t thread;
+        start_samples[i].requested_ns = scheduler_now_ns();
+        if (pthread_create(&thread, NULL, start_thread_func, &start_samples[i]) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(EXIT_FAILURE);
+        }
+        pthread_detach(thread);
+        submit_total += scheduler_now_ns() - start_samples[i].requested_ns;
+
+        // 기존 서버처럼 작업이 하나씩 들어오는 상황 (동시에 수천 개의 스레드를 만들지 않음)
+        wait_count(&started_count, i + 1);
+    }
+
+    report_start("thread", submit_total);
+}
+
+static void bench_start_scheduler(void) {
+    uint64_t submit_total = 0;
+    atomic_store(&started_count, 0);
+
+    for (int i = 0; i < START_OPS; i++) {
+        start_samples[i].requested_ns = scheduler_now_ns();
+        if (scheduler_add(start_samples[i].requested_ns, start_callback, &start_samples[i]) == 0) {
+            exit(EXIT_FAILURE);
+        }
+        submit_total += scheduler_now_ns() - start_samples[i].requested_ns;
+        wait_count(&started_count, i + 1);
+    }
+
+    report_start("scheduler", submit_total);
+}
+
+// ---------------------------------------------------------------------------
+// 주기 틱 오차
+// ---------------------------------------------------------------------------
+static void* tick_thread_func(void* arg) {
+    (void)arg;
+    for (int i = 0; i <= TICKS; i++) {
+        tick_times[i] = scheduler_now_ns();
+        busy_us(TICK_WORK_US);
+        if (i < TICKS) {
+            usleep(TICK_PERIOD_MS * 1000);
+        }
+    }
+    return NULL;
+}
+
+static void tick_callback(void* arg, uint64_t deadline_ns) {
+    (void)arg;
+    int i = atomic_load(&tick_count);
+
+    tick_times[i] = scheduler_now_ns();
+    busy_us(TICK_WORK_US);
+
+    if (i < TICKS) {
+        scheduler_add(deadline_ns + (uint64_t)TICK_PERIOD_MS * 1000000ULL, tick_callback, NULL);
+    }
+    atomic_store(&tick_count, i + 1);
+}
+
+static void bench_tick_thread(void) {
+    pthread_t thread;
+    pthread_create(&thread, NULL, tick_thread_func, NULL);
+    pthread_join(thread, NULL);
+    report_ticks("thread");
+}
+
+static void bench_tick_scheduler(void) {
+    atomic_store(&tick_count, 0);
+    scheduler_add(scheduler_now_ns(), tick_callback, NULL);
+    wait_count(&tick_count, TICKS + 1);
+    report_ticks("scheduler");
+}
+
+int main(void) {
+    if (scheduler_start() != 0) {
+        return EXIT_FAILURE;
+    }
+
+    bench_start_thread();
+    bench_start_scheduler();
+    bench_tick_thread();
+    bench_tick_scheduler();
+
+    scheduler_stop();
+    return 0;
+}
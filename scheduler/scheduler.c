@@ -0,0 +1,318 @@
+#include "scheduler.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+// 타이머 스케줄러
+// - 타이머는 고정 크기 풀에서 꺼내 쓰고, 마감 시각 순 min-heap에 풀 인덱스를 넣는다.
+// - timerfd 하나를 heap의 가장 이른 마감 시각(절대 시각)으로 맞춰 두고, 스케줄러 스레드는
+//   timerfd와 종료용 eventfd만 기다린다. 새 타이머가 가장 이르면 추가한 스레드가 바로 timerfd를 다시 맞춘다.
+// - 콜백은 잠금을 풀고 실행하므로 콜백 안에서 scheduler_add / cancel을 불러도 된다.
+// - 타이머 ID = (세대 << 16) | (풀 인덱스 + 1). 슬롯을 재사용해도 예전 ID로는 취소되지 않는다.
+
+typedef struct {
+    uint64_t deadline_ns;
+    SchedCallback callback;
+    void* arg;
+    uint16_t generation;
+    int heap_index;                 // -1 = 예약되어 있지 않음
+    int next_free;
+} SchedTimer;
+
+static SchedTimer timers[SCHED_MAX_TIMERS];
+static int heap[SCHED_MAX_TIMERS];
+static int heap_size = 0;
+static int free_head = -1;
+
+static pthread_mutex_t sched_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t sched_thread;
+static int timer_fd = -1;
+static int stop_fd = -1;
+static int ref_count = 0;
+
+uint64_t scheduler_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// min-heap (sched_mutex를 잡은 상태에서만 호출)
+// ---------------------------------------------------------------------------
+static bool heap_less(int a, int b) {
+    return timers[heap[a]].deadline_ns < timers[heap[b]].deadline_ns;
+}
+
+static void heap_swap(int a, int b) {
+    int tmp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = tmp;
+    timers[heap[a]].heap_index = a;
+    timers[heap[b]].heap_index = b;
+}
+
+static void heap_up(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heap_less(i, parent)) {
+            break;
+        }
+        heap_swap(i, parent);
+        i = parent;
+    }
+}
+
+static void heap_down(int i) {
+    for (;;) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int smallest = i;
+
+        if (left < heap_size && heap_less(left, smallest)) {
+            smallest = left;
+        }
+        if (right < heap_size && heap_less(right, smallest)) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            break;
+        }
+        heap_swap(i, smallest);
+        i = smallest;
+    }
+}
+
+static void heap_remove(int i) {
+    int slot = heap[i];
+
+    heap_size--;
+    if (i != heap_size) {
+        heap[i] = heap[heap_size];
+        timers[heap[i]].heap_index = i;
+        heap_down(i);
+        heap_up(i);
+    }
+    timers[slot].heap_index = -1;
+}
+
+// ---------------------------------------------------------------------------
+// 타이머 풀
+// ---------------------------------------------------------------------------
+static void pool_init(void) {
+    heap_size = 0;
+    free_head = 0;
+    for (int i = 0; i < SCHED_MAX_TIMERS; i++) {
+        timers[i].heap_index = -1;
+        timers[i].next_free = (i + 1 < SCHED_MAX_TIMERS) ? i + 1 : -1;
+    }
+}
+
+static void pool_release(int slot) {
+    timers[slot].generation++;
+    timers[slot].callback = NULL;
+    timers[slot].next_free = free_head;
+    free_head = slot;
+}
+
+// 가장 이른 마감 시각으로 timerfd를 맞춘다 (타이머가 없으면 해제)
+static void arm_timer(void) {
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+
+    if (heap_size > 0) {
+        uint64_t deadline = timers[heap[0]].deadline_ns;
+        if (deadline == 0) {
+            deadline = 1;   // it_value가 0이면 해제로 처리되므로
+        }
+        spec.it_value.tv_sec = (time_t)(deadline / 1000000000ULL);
+        spec.it_value.tv_nsec = (long)(deadline % 1000000000ULL);
+    }
+
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+static void* scheduler_thread(void* arg) {
+    (void)arg;
+    struct pollfd fds[2] = {
+        { .fd = timer_fd, .events = POLLIN },
+        { .fd = stop_fd, .events = POLLIN }
+    };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+
+        uint64_t expirations;
+        ssize_t ret = read(timer_fd, &expirations, sizeof(expirations));
+        (void)ret;
+
+        pthread_mutex_lock(&sched_mutex);
+        uint64_t now = scheduler_now_ns();
+
+        while (heap_size > 0 && timers[heap[0]].deadline_ns <= now) {
+            int slot = heap[0];
+            SchedCallback callback = timers[slot].callback;
+            void* cb_arg = timers[slot].arg;
+            uint64_t deadline = timers[slot].deadline_ns;
+
+            heap_remove(0);
+            pool_release(slot);
+
+            pthread_mutex_unlock(&sched_mutex);
+            callback(cb_arg, deadline);
+            pthread_mutex_lock(&sched_mutex);
+
+            now = scheduler_now_ns();
+        }
+
+        arm_timer();
+        pthread_mutex_unlock(&sched_mutex);
+    }
+
+    return NULL;
+}
+
+int scheduler_start(void) {
+    pthread_mutex_lock(&sched_mutex);
+
+    if (ref_count > 0) {
+        ref_count++;
+        pthread_mutex_unlock(&sched_mutex);
+        return 0;
+    }
+
+    pool_init();
+
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (timer_fd < 0 || stop_fd < 0) {
+        fprintf(stderr, "Failed to create scheduler timerfd/eventfd: %s\n", strerror(errno));
+        goto fail;
+    }
+
+    if (pthread_create(&sched_thread, NULL, scheduler_thread, NULL) != 0) {
+        fprintf(stderr, "Failed to create scheduler thread\n");
+        goto fail;
+    }
+
+    ref_count = 1;
+    pthread_mutex_unlock(&sched_mutex);
+    printf("Scheduler started (max %d timers)\n", SCHED_MAX_TIMERS);
+    return 0;
+
+fail:
+    if (timer_fd >= 0) close(timer_fd);
+    if (stop_fd >= 0) close(stop_fd);
+    timer_fd = -1;
+    stop_fd = -1;
+    pthread_mutex_unlock(&sched_mutex);
+    return -1;
+}
+
+void scheduler_stop(void) {
+    pthread_mutex_lock(&sched_mutex);
+
+    if (ref_count == 0 || --ref_count > 0) {
+        pthread_mutex_unlock(&sched_mutex);
+        return;
+    }
+    pthread_mutex_unlock(&sched_mutex);
+
+    uint64_t one = 1;
+    ssize_t ret = write(stop_fd, &one, sizeof(one));
+    (void)ret;
+    pthread_join(sched_thread, NULL);
+
+    pthread_mutex_lock(&sched_mutex);
+    while (heap_size > 0) {
+        int slot = heap[0];
+        heap_remove(0);
+        pool_release(slot);
+    }
+    close(timer_fd);
+    close(stop_fd);
+    timer_fd = -1;
+    stop_fd = -1;
+    pthread_mutex_unlock(&sched_mutex);
+
+    printf("Scheduler stopped\n");
+}
+
+SchedTimerId scheduler_add(uint64_t deadline_ns, SchedCallback callback, void* arg) {
+    if (callback == NULL) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&sched_mutex);
+
+    if (ref_count == 0 || free_head < 0) {
+        pthread_mutex_unlock(&sched_mutex);
+        fprintf(stderr, ref_count == 0 ? "Scheduler not started\n" : "Scheduler timer pool full\n");
+        return 0;
+    }
+
+    int slot = free_head;
+    SchedTimer* timer = &timers[slot];
+    free_head = timer->next_free;
+
+    timer->deadline_ns = deadline_ns;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->heap_index = heap_size;
+    heap[heap_size++] = slot;
+    heap_up(timer->heap_index);
+
+    // 가장 이른 타이머가 바뀌었으면 timerfd를 다시 맞춘다
+    if (heap[0] == slot) {
+        arm_timer();
+    }
+
+    SchedTimerId id = ((SchedTimerId)timer->generation << 16) | (SchedTimerId)(slot + 1);
+    pthread_mutex_unlock(&sched_mutex);
+    return id;
+}
+
+SchedTimerId scheduler_add_after(unsigned int delay_ms, SchedCallback callback, void* arg) {
+    return scheduler_add(scheduler_now_ns() + (uint64_t)delay_ms * 1000000ULL, callback, arg);
+}
+
+int scheduler_cancel(SchedTimerId id) {
+    int slot = (int)(id & 0xFFFF) - 1;
+    uint16_t generation = (uint16_t)(id >> 16);
+
+    if (slot < 0 || slot >= SCHED_MAX_TIMERS) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&sched_mutex);
+
+    SchedTimer* timer = &timers[slot];
+    if (timer->generation != generation || timer->heap_index < 0) {
+        pthread_mutex_unlock(&sched_mutex);
+        return -1;
+    }
+
+    bool was_first = (timer->heap_index == 0);
+    heap_remove(timer->heap_index);
+    pool_release(slot);
+    if (was_first) {
+        arm_timer();
+    }
+
+    pthread_mutex_unlock(&sched_mutex);
+    return 0;
+}
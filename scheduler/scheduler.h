@@ -0,0 +1,35 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+// 단일 스레드 타이머 스케줄러
+// 카운트다운 틱, 음표 전환처럼 주기적으로 깨어나야 하는 작업을 작업마다 스레드를 만들지 않고
+// 스케줄러 스레드 하나에서 콜백으로 실행한다.
+
+#define SCHED_MAX_TIMERS 256        // 동시에 예약할 수 있는 타이머 수 (고정 풀)
+
+typedef uint32_t SchedTimerId;      // 0 = 잘못된 타이머
+
+// deadline_ns: 예약했던 시각 (CLOCK_MONOTONIC ns). 다음 주기는 deadline_ns + period로 예약하면
+// 실행이 늦어져도 오차가 누적되지 않는다.
+typedef void (*SchedCallback)(void* arg, uint64_t deadline_ns);
+
+// 스케줄러 스레드 시작 (참조 카운트: 여러 라이브러리가 각자 호출해도 스레드는 하나). 성공 시 0
+int scheduler_start(void);
+
+// scheduler_start와 짝을 맞춰 호출. 마지막 호출에서 스레드를 종료하고 남은 타이머를 버린다
+void scheduler_stop(void);
+
+// 절대 시각(CLOCK_MONOTONIC ns)에 callback 실행 예약. 풀이 가득 차면 0
+SchedTimerId scheduler_add(uint64_t deadline_ns, SchedCallback callback, void* arg);
+
+// 지금부터 delay_ms 뒤에 실행 예약
+SchedTimerId scheduler_add_after(unsigned int delay_ms, SchedCallback callback, void* arg);
+
+// 아직 실행되지 않은 타이머 취소. 취소했으면 0, 이미 실행 중이거나 끝났으면 -1
+int scheduler_cancel(SchedTimerId id);
+
+uint64_t scheduler_now_ns(void);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,231 @@
+// 동시 연결 수 확장성 벤치마크 (실행 중인 서버 대상)
+// 연결 수를 늘려 가며 접속 지연(connect -> 첫 메뉴 수신)과 명령 처리량을 측정한다.
+// 각 연결은 응답을 기다리지 않고 depth개의 명령을 유지하는 closed-loop 방식이다.
+//
+// 사용법: bench_connections [host] [port] [commands_per_conn] [depth] [conn_count...]
+// 출력 형식 (한 줄 = 한 측정):
+//   connections n=<n> accept_p50_us=<n> accept_p99_us=<n> accept_max_us=<n> cmds=<n> errors=<n> elapsed_ms=<n> cmds_per_sec=<n>
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#define DEFAULT_COMMANDS    200
+#define DEFAULT_DEPTH       4
+#define RECV_BUFFER_SIZE    8192
+#define BENCH_COMMAND       "11 0 0\n"  // STATUS: GPIO와 디바이스 상태를 건드리지 않는 명령
+
+typedef struct {
+    int fd;
+    bool connected;         // 빈 줄 전송 여부 (connect 완료 후)
+    bool ready;             // 첫 메뉴 수신 여부
+    uint64_t t_connect;
+    uint64_t accept_us;
+    int sent;
+    int received;
+    int errors;
+    char buf[RECV_BUFFER_SIZE];
+    size_t len;
+} BenchConn;
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void send_commands(BenchConn* c, int total, int depth) {
+    while (c->sent < total && c->sent - c->received < depth) {
+        if (send(c->fd, BENCH_COMMAND, strlen(BENCH_COMMAND), MSG_NOSIGNAL) <= 0) {
+            return;
+        }
+        c->sent++;
+    }
+}
+
+// 수신 데이터에서 완료된 응답 줄("[#id] ...")을 센다
+static void consume_lines(BenchConn* c) {
+    char* start = c->buf;
+    char* end = c->buf + c->len;
+    char* nl;
+
+    while ((nl = memchr(start, '\n', (size_t)(end - start))) != NULL) {
+        // 메뉴의 "Select: " 뒤에 바로 응답이 이어질 수 있다
+        if (nl - start >= 8 && memcmp(start, "Select: ", 8) == 0) {
+            start += 8;
+        }
+        if (nl - start >= 2 && start[0] == '[' && start[1] == '#') {
+            c->received++;
+            if (memmem(start, (size_t)(nl - start), "[ERROR]", 7) != NULL) {
+                c->errors++;
+            }
+        }
+        start = nl + 1;
+    }
+
+    c->len = (size_t)(end - start);
+    memmove(c->buf, start, c->len);
+}
+
+static int run_round(const struct sockaddr_in* addr, int count, int commands, int depth) {
+    BenchConn* conns = calloc((size_t)count, sizeof(BenchConn));
+    uint64_t* accept_us = calloc((size_t)count, sizeof(uint64_t));
+    int epfd = epoll_create1(0);
+    int done = 0, ready = 0;
+
+    uint64_t start = now_us();
+
+    for (int i = 0; i < count; i++) {
+        BenchConn* c = &conns[i];
+        c->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (c->fd < 0) {
+            perror("socket");
+            return -1;
+        }
+
+        int one = 1;
+        setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        c->t_connect = now_us();
+        if (connect(c->fd, (const struct sockaddr*)addr, sizeof(*addr)) < 0 &&
+            errno != EINPROGRESS) {
+            perror("connect");
+            return -1;
+        }
+
+        // connect 완료(EPOLLOUT)를 기다렸다가 빈 줄을 보낸다
+        struct epoll_event ev = { .events = EPOLLIN | EPOLLOUT, .data.u32 = (uint32_t)i };
+        epoll_ctl(epfd, EPOLL_CTL_ADD, c->fd, &ev);
+    }
+
+    struct epoll_event events[256];
+
+    while (done < count) {
+        int n = epoll_wait(epfd, events, 256, 5000);
+        if (n <= 0) {
+            fprintf(stderr, "timeout: %d/%d connections finished\n", done, count);
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            BenchConn* c = &conns[events[i].data.u32];
+
+            // 텍스트 클라이언트는 빈 줄을 보내 바이너리 핸드셰이크 대기 시간을 건너뛴다
+            if (!c->connected && (events[i].events & EPOLLOUT)) {
+                struct epoll_event ev = { .events = EPOLLIN, .data.u32 = events[i].data.u32 };
+                epoll_ctl(epfd, EPOLL_CTL_MOD, c->fd, &ev);
+                send(c->fd, "\n", 1, MSG_NOSIGNAL);
+                c->connected = true;
+            }
+            if (!(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                continue;
+            }
+
+            ssize_t r = recv(c->fd, c->buf + c->len, sizeof(c->buf) - c->len - 1, 0);
+
+            if (r <= 0) {
+                if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    fprintf(stderr, "connection closed by server\n");
+                    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+                    done++;
+                }
+                continue;
+            }
+            c->len += (size_t)r;
+            c->buf[c->len] = '\0';
+
+            if (!c->ready) {
+                // 환영 메시지 + 메뉴가 끝나면 접속 완료
+                if (strstr(c->buf, "Select: ") == NULL) {
+                    continue;
+                }
+                c->ready = true;
+                c->accept_us = now_us() - c->t_connect;
+                accept_us[ready++] = c->accept_us;
+                c->len = 0;
+            } else {
+                consume_lines(c);
+            }
+
+            if (c->received >= commands) {
+                epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+                done++;
+                continue;
+            }
+
+            send_commands(c, commands, depth);
+        }
+    }
+
+    uint64_t elapsed = now_us() - start;
+    int total = 0, errors = 0;
+
+    for (int i = 0; i < count; i++) {
+        total += conns[i].received;
+        errors += conns[i].errors;
+        close(conns[i].fd);
+    }
+
+    qsort(accept_us, (size_t)ready, sizeof(uint64_t), compare_u64);
+
+    printf("connections n=%d accept_p50_us=%llu accept_p99_us=%llu accept_max_us=%llu "
+           "cmds=%d errors=%d elapsed_ms=%llu cmds_per_sec=%.0f\n",
+           count,
+           (unsigned long long)(ready ? accept_us[ready / 2] : 0),
+           (unsigned long long)(ready ? accept_us[(int)(ready * 0.99)] : 0),
+           (unsigned long long)(ready ? accept_us[ready - 1] : 0),
+           total, errors, (unsigned long long)(elapsed / 1000),
+           total / (elapsed / 1e6));
+
+    close(epfd);
+    free(accept_us);
+    free(conns);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    const char* host = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? atoi(argv[2]) : 8080;
+    int commands = argc > 3 ? atoi(argv[3]) : DEFAULT_COMMANDS;
+    int depth = argc > 4 ? atoi(argv[4]) : DEFAULT_DEPTH;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid host: %s\n", host);
+        return EXIT_FAILURE;
+    }
+
+    if (argc > 5) {
+        for (int i = 5; i < argc; i++) {
+            run_round(&addr, atoi(argv[i]), commands, depth);
+        }
+    } else {
+        int default_counts[] = { 1, 8, 64, 256 };
+        for (size_t i = 0; i < sizeof(default_counts) / sizeof(default_counts[0]); i++) {
+            run_round(&addr, default_counts[i], commands, depth);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
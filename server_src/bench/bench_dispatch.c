@@ -0,0 +1,297 @@
+// 명령 실행 경로 벤치마크 (sim GPIO 백엔드, 하드웨어 / 서버 불필요)
+// 1) dispatch: 디바이스 lane이 명령 하나를 실행하는 비용 (device_execute의 switch, 디바이스 라이브러리,
+//    sim GPIO 기록, 상태 저장소, 이벤트 발행). 시작 / 중단 짝은 두 명령과 중단이 끝나기까지를 한 op로 센다.
+// 2) respond: reactor가 응답 하나를 연결 출력 버퍼에 넣는 비용 (conn_deliver_response: 완료 슬롯 해제 +
+//    텍스트 형식 / 바이너리 인코딩). text_menu는 응답 뒤 메뉴 재전송까지 포함한다.
+// 3) handoff: reactor(이 스레드) -> LED lane 큐 -> lane 스레드 실행 -> Response Queue + eventfd -> reactor 왕복.
+//    pingpong은 응답을 받은 뒤 다음 명령을 넣으므로 lane이 매번 조건 변수에서 잠들었다 깨어나고,
+//    burst는 depth개를 한 번에 넣고 모두 받는다 (LED coalescing 켬, 서버 기본값).
+//
+// 같은 빌드 / 같은 머신에서 op 수와 순서가 고정이므로 줄 단위로 이전 결과와 비교할 수 있다.
+// GPIO_SIM_LATENCY를 주면 sim GPIO 연산마다 그만큼 바쁜 대기한다 (하드웨어 호출 비용 흉내).
+//
+// 출력 형식 (한 줄 = 한 측정):
+//   dispatch cmd=<name> ops=<n> errors=<n> ns_per_op=<n> gpio_ops_per_op=<n>
+//   respond mode=<text|text_menu|binary> ops=<n> ns_per_op=<n> bytes_per_op=<n>
+//   handoff mode=<pingpong|burst> depth=<n> ops=<n> cmds_per_sec=<n> p50_ns=<n> p99_ns=<n> max_ns=<n>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <poll.h>
+#include <sched.h>
+#include <unistd.h>
+#include "gpio_hal.h"
+#include "gpio_sim.h"
+#include "server.h"
+
+#define DISPATCH_OPS    200000
+#define CYCLE_OPS       2000        // 스케줄러 작업을 만들고 취소하는 시작 / 중단 짝
+#define RESPOND_OPS     1000000
+#define HANDOFF_OPS     20480       // BURST_DEPTH의 배수
+#define BURST_DEPTH     MAX_INFLIGHT
+#define BENCH_CONN_ID   1
+
+// 서버와 같은 핀 (server.c)
+static const LedPin led_pin = {.pin = 12};
+static const LightSensorPin sensor_pin = {.pin = 11};
+static const Seg7Config seg7_config = {
+    .bcd = {.pin_a = 14, .pin_b = 15, .pin_c = 18, .pin_d = 23},
+    .digit_count = 1,
+    .colon_pin = -1
+};
+static const int buzzer_pin = 21;
+
+typedef struct {
+    const char* name;
+    CommandType type;
+    int param1;
+    int stop_type;              // 0이 아니면 같은 op에서 이어서 실행할 중단 명령
+    int ops;
+} DispatchCase;
+
+static const DispatchCase DISPATCH_CASES[] = {
+    {"led_on",            CMD_LED_ON,          0,  0,                DISPATCH_OPS},
+    {"led_off",           CMD_LED_OFF,         0,  0,                DISPATCH_OPS},
+    {"brightness",        CMD_SET_BRIGHTNESS,  2,  0,                DISPATCH_OPS},
+    {"brightness_invalid", CMD_SET_BRIGHTNESS, 9,  0,                DISPATCH_OPS},
+    {"sensor_on",         CMD_SENSOR_ON,       0,  0,                DISPATCH_OPS},
+    {"sensor_off",        CMD_SENSOR_OFF,      0,  0,                DISPATCH_OPS},
+    {"segment_stop_idle", CMD_SEGMENT_STOP,    0,  0,                DISPATCH_OPS},
+    {"buzzer_off_idle",   CMD_BUZZER_OFF,      0,  0,                DISPATCH_OPS},
+    {"unknown",           (CommandType)99,     0,  0,                DISPATCH_OPS},
+    {"segment_cycle",     CMD_SEGMENT_DISPLAY, 5,  CMD_SEGMENT_STOP, CYCLE_OPS},
+    {"buzzer_cycle",      CMD_BUZZER_ON,       1,  CMD_BUZZER_OFF,   CYCLE_OPS},
+};
+
+// 결과 줄 (디바이스 라이브러리의 로그는 stdout으로 나가므로 결과는 원래 stdout을 복제해 따로 쓴다)
+static FILE* g_out;
+static ServerState g_state;
+static Connection g_conn;
+static uint64_t g_bytes_sent;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// reactor.c 대신: 출력 버퍼에 쌓고, 차면 보낸 것으로 치고 비운다
+bool conn_send(Connection* conn, const char* data, size_t len) {
+    if (conn->out_len + len > sizeof(conn->out_buf)) {
+        conn->out_len = 0;
+    }
+    memcpy(conn->out_buf + conn->out_len, data, len);
+    conn->out_len += len;
+    g_bytes_sent += len;
+    return true;
+}
+
+static uint64_t gpio_ops(void) {
+    GpioSimStats stats;
+    gpio_sim_get_stats(&stats);
+    return stats.ops[GPIO_SIM_OP_WRITE] + stats.ops[GPIO_SIM_OP_PWM] + stats.ops[GPIO_SIM_OP_TONE];
+}
+
+// reactor 몫: 발행된 이벤트와 다른 lane으로 보낸 내부 명령(센서 -> LED)을 비운다
+static void drain(void) {
+    DeviceEvent event;
+    Command cmd;
+
+    while (event_queue_pop(&g_state.event_queue, &event)) {
+    }
+    for (int i = 0; i < LANE_COUNT; i++) {
+        while (queue_pop(&g_state.lanes[i].queue, &cmd)) {
+        }
+    }
+}
+
+static int execute(CommandType type, int param1) {
+    Command cmd = {0};
+    cmd.type = type;
+    cmd.param1 = param1;
+    cmd.conn_id = BENCH_CONN_ID;
+
+    CommandResponse response = {0};
+    device_execute(&g_state, &cmd, &response);
+    return response.status;
+}
+
+static void bench_dispatch(const DispatchCase* c) {
+    int errors = 0;
+    uint64_t gpio_before = gpio_ops();
+    uint64_t start = now_ns();
+
+    for (int i = 0; i < c->ops; i++) {
+        if (execute(c->type, c->param1) != 0) {
+            errors++;
+        }
+        if (c->stop_type != 0) {
+            if (execute((CommandType)c->stop_type, 0) != 0) {
+                errors++;
+            }
+            // 곡 정지는 스케줄러 스레드가 마무리하므로 끝날 때까지 기다린다 (다음 재생이 거부되지 않도록)
+            while (is_music_playing()) {
+                sched_yield();
+            }
+        }
+        drain();
+    }
+
+    uint64_t elapsed = now_ns() - start;
+    fprintf(g_out, "dispatch cmd=%s ops=%d errors=%d ns_per_op=%.1f gpio_ops_per_op=%.2f\n",
+            c->name, c->ops, errors, (double)elapsed / c->ops,
+            (double)(gpio_ops() - gpio_before) / c->ops);
+}
+
+static void bench_respond(const char* mode, ConnMode conn_mode, bool menu) {
+    CommandResponse response = {0};
+    response.status = STATUS_OK;
+    strcpy(response.message, "Brightness set to 2");
+
+    memset(&g_conn, 0, sizeof(g_conn));
+    g_conn.conn_id = BENCH_CONN_ID;
+    g_conn.mode = conn_mode;
+    g_conn.state = CONN_STATE_COMMAND;
+    g_bytes_sent = 0;
+
+    uint64_t start = now_ns();
+    for (uint32_t id = 1; id <= RESPOND_OPS; id++) {
+        InflightSlot* slot = &g_conn.inflight[id % MAX_INFLIGHT];
+        slot->in_use = true;
+        slot->request_id = id;
+        g_conn.inflight_count = 1;
+
+        response.request_id = id;
+        conn_deliver_response(&g_conn, &response);
+        if (menu) {
+            conn_flush_menu(&g_conn);
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    fprintf(g_out, "respond mode=%s ops=%d ns_per_op=%.1f bytes_per_op=%.1f\n",
+            mode, RESPOND_OPS, (double)elapsed / RESPOND_OPS, (double)g_bytes_sent / RESPOND_OPS);
+}
+
+// 응답 count개를 받을 때까지 eventfd를 기다렸다가 비운다 (reactor와 같은 ack -> pop 순서)
+static void collect(int count, uint64_t* sent_at, uint64_t* latency, int* samples) {
+    while (count > 0) {
+        struct pollfd pfd = {.fd = g_state.resp_queue.event_fd, .events = POLLIN};
+        poll(&pfd, 1, -1);
+        response_queue_ack(&g_state.resp_queue);
+
+        CommandResponse response;
+        while (response_queue_pop(&g_state.resp_queue, &response)) {
+            latency[(*samples)++] = now_ns() - sent_at[response.request_id % MAX_INFLIGHT];
+            count--;
+        }
+
+        DeviceEvent event;
+        while (event_queue_pop(&g_state.event_queue, &event)) {
+        }
+    }
+}
+
+static void bench_handoff(const char* mode, int depth) {
+    uint64_t* latency = calloc(HANDOFF_OPS, sizeof(uint64_t));
+    uint64_t sent_at[MAX_INFLIGHT];
+    int samples = 0;
+
+    uint64_t start = now_ns();
+    for (uint32_t id = 0; id < HANDOFF_OPS; id += (uint32_t)depth) {
+        for (int i = 0; i < depth; i++) {
+            Command cmd = {0};
+            cmd.type = ((id + (uint32_t)i) & 1) ? CMD_LED_OFF : CMD_LED_ON;
+            cmd.request_id = id + (uint32_t)i;
+            cmd.conn_id = BENCH_CONN_ID;
+
+            sent_at[cmd.request_id % MAX_INFLIGHT] = now_ns();
+            device_submit(&g_state, &cmd);
+        }
+        collect(depth, sent_at, latency, &samples);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    qsort(latency, (size_t)samples, sizeof(uint64_t), compare_u64);
+    fprintf(g_out, "handoff mode=%s depth=%d ops=%d cmds_per_sec=%.0f p50_ns=%llu p99_ns=%llu max_ns=%llu\n",
+            mode, depth, samples, (double)samples * 1e9 / (double)elapsed,
+            (unsigned long long)latency[samples / 2],
+            (unsigned long long)latency[(int)(samples * 0.99)],
+            (unsigned long long)latency[samples - 1]);
+    free(latency);
+}
+
+static int devices_init(void) {
+    if (gpio_init("sim") != 0 || device_lanes_init(&g_state) != 0 ||
+        response_queue_init(&g_state.resp_queue) != 0 ||
+        event_queue_init(&g_state.event_queue) != 0) {
+        return -1;
+    }
+    if (seg7_init_multi(&seg7_config) != 0 || music_init(buzzer_pin) != 0 ||
+        led_init(&led_pin) != 0 || light_sensor_init(&sensor_pin) != 0) {
+        return -1;
+    }
+
+    g_state.led_coalescing = true;
+    g_state.server_running = true;
+    return 0;
+}
+
+int main(void) {
+    // 트레이스 파일 쓰기와 입력 스크립트는 측정에서 뺀다
+    unsetenv("GPIO_SIM_TRACE");
+    unsetenv("GPIO_SIM_SCRIPT");
+
+    fflush(stdout);
+    g_out = fdopen(dup(STDOUT_FILENO), "w");
+    if (!g_out || !freopen("/dev/null", "w", stdout)) {
+        perror("stdout");
+        return 1;
+    }
+
+    if (devices_init() != 0) {
+        fprintf(stderr, "Failed to initialize devices (sim GPIO)\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(DISPATCH_CASES) / sizeof(DISPATCH_CASES[0]); i++) {
+        bench_dispatch(&DISPATCH_CASES[i]);
+    }
+
+    bench_respond("text", CONN_MODE_TEXT, false);
+    bench_respond("text_menu", CONN_MODE_TEXT, true);
+    bench_respond("binary", CONN_MODE_BINARY, false);
+
+    // 센서 감시가 꺼진 상태에서 lane 시작 (Sensor lane은 센서 에지 콜백만 받고 잠든다)
+    execute(CMD_SENSOR_OFF, 0);
+    drain();
+    if (device_lanes_start(&g_state) != 0) {
+        fprintf(stderr, "Failed to start device lanes\n");
+        return 1;
+    }
+    bench_handoff("pingpong", 1);
+    bench_handoff("burst", BURST_DEPTH);
+
+    g_state.server_running = false;
+    device_lanes_stop(&g_state);
+    device_lanes_cleanup(&g_state);
+    response_queue_cleanup(&g_state.resp_queue);
+    event_queue_cleanup(&g_state.event_queue);
+    light_sensor_cleanup();
+    led_cleanup();
+    music_cleanup();
+    seg7_cleanup();
+    gpio_cleanup();
+
+    fclose(g_out);
+    return 0;
+}
@@ -0,0 +1,151 @@
+// 우선순위 Command Queue 벤치마크
+// 일반 명령으로 큐를 가득 채운 상태(saturated)에서 stop 명령의 지연 시간을 측정한다.
+// - 생산자 1: 일반 명령(LED)을 큐가 가득 찰 때까지 계속 넣는다
+// - 생산자 2: STOP_INTERVAL_US마다 stop 명령(BUZZER_OFF)을 넣는다
+// - 소비자: 명령마다 WORK_NS 동안 디바이스 작업을 흉내 낸다
+// mode=fifo는 stop 명령도 일반 우선순위로 넣어 기존 FIFO 큐와 비교한다.
+//
+// 출력 형식 (한 줄 = 한 측정):
+//   priority mode=<fifo|priority> class=<stop|bulk> ops=<n> p50_ns=<n> p99_ns=<n> max_ns=<n>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include "server.h"
+
+#define STOP_OPS            1000
+#define STOP_INTERVAL_US    500
+#define WORK_NS             2000
+#define BULK_TIME_SLOTS     (1 << 20)
+
+typedef struct {
+    CommandQueue queue;
+    bool use_priority;
+    atomic_bool done;
+    uint64_t* stop_push_time;
+    uint64_t* bulk_push_time;
+    uint64_t* stop_latency;
+    uint64_t* bulk_latency;
+    int bulk_count;
+} Bench;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void spin_ns(uint64_t ns) {
+    uint64_t end = now_ns() + ns;
+    while (now_ns() < end) {
+    }
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void* bulk_producer(void* arg) {
+    Bench* b = (Bench*)arg;
+    int i = 0;
+
+    while (!atomic_load(&b->done)) {
+        Command cmd = { .type = CMD_LED_ON, .param1 = i % BULK_TIME_SLOTS };
+        b->bulk_push_time[cmd.param1] = now_ns();
+        if (queue_push(&b->queue, &cmd)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* stop_producer(void* arg) {
+    Bench* b = (Bench*)arg;
+
+    for (int i = 0; i < STOP_OPS && !atomic_load(&b->done); i++) {
+        usleep(STOP_INTERVAL_US);
+
+        Command cmd = { .type = CMD_BUZZER_OFF, .param1 = i };
+        CommandPriority priority = b->use_priority ? PRIORITY_URGENT : PRIORITY_NORMAL;
+        for (;;) {
+            b->stop_push_time[i] = now_ns();
+            if (queue_push_priority(&b->queue, &cmd, priority)) break;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void report(const char* mode, const char* cls, uint64_t* latency, int count) {
+    if (count == 0) {
+        return;
+    }
+    qsort(latency, (size_t)count, sizeof(uint64_t), compare_u64);
+    printf("priority mode=%s class=%s ops=%d p50_ns=%llu p99_ns=%llu max_ns=%llu\n",
+           mode, cls, count,
+           (unsigned long long)latency[count / 2],
+           (unsigned long long)latency[(int)(count * 0.99)],
+           (unsigned long long)latency[count - 1]);
+}
+
+static void run(bool use_priority) {
+    static Bench b;
+    memset(&b, 0, sizeof(b));
+    b.use_priority = use_priority;
+    atomic_init(&b.done, false);
+    b.stop_push_time = calloc(STOP_OPS, sizeof(uint64_t));
+    b.stop_latency = calloc(STOP_OPS, sizeof(uint64_t));
+    b.bulk_push_time = calloc(BULK_TIME_SLOTS, sizeof(uint64_t));
+    b.bulk_latency = calloc(BULK_TIME_SLOTS, sizeof(uint64_t));
+    queue_init(&b.queue);
+
+    pthread_t bulk_thread, stop_thread;
+    pthread_create(&bulk_thread, NULL, bulk_producer, &b);
+    pthread_create(&stop_thread, NULL, stop_producer, &b);
+
+    // 소비자 (디바이스 lane worker 역할)
+    int stops = 0;
+    while (stops < STOP_OPS) {
+        Command cmd;
+        if (!queue_pop(&b.queue, &cmd)) {
+            queue_wait(&b.queue, 10);
+            continue;
+        }
+
+        uint64_t now = now_ns();
+        if (cmd.type == CMD_BUZZER_OFF) {
+            b.stop_latency[stops++] = now - b.stop_push_time[cmd.param1];
+        } else if (b.bulk_count < BULK_TIME_SLOTS) {
+            b.bulk_latency[b.bulk_count++] = now - b.bulk_push_time[cmd.param1];
+        }
+        spin_ns(WORK_NS);
+    }
+
+    atomic_store(&b.done, true);
+    pthread_join(stop_thread, NULL);
+    pthread_join(bulk_thread, NULL);
+
+    const char* mode = use_priority ? "priority" : "fifo";
+    report(mode, "stop", b.stop_latency, stops);
+    report(mode, "bulk", b.bulk_latency, b.bulk_count);
+
+    queue_cleanup(&b.queue);
+    free(b.stop_push_time);
+    free(b.stop_latency);
+    free(b.bulk_push_time);
+    free(b.bulk_latency);
+}
+
+int main(void) {
+    run(false);
+    run(true);
+    return 0;
+}
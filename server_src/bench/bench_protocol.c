@@ -0,0 +1,267 @@
+// 텍스트 / 바이너리 프로토콜 비교 벤치마크
+// 1) 인자 없이 실행: 명령 하나를 해석하고 응답 하나를 만드는 비용과 바이트 수 (서버 불필요)
+// 2) host port 인자: 실행 중인 서버에 명령을 하나씩 보내고(대화형 사용 패턴)
+//    명령당 송수신 바이트와 왕복 시간 측정. 텍스트 모드는 메뉴 재전송까지 포함된다.
+//
+// 사용법: bench_protocol [host port [commands]]
+// 출력 형식 (한 줄 = 한 측정):
+//   protocol mode=<text|binary> ops=<n> parse_ns=<n> format_ns=<n> request_bytes=<n> response_bytes=<n>
+//   protocol_live mode=<text|binary> cmds=<n> tx_bytes_per_cmd=<n> rx_bytes_per_cmd=<n> rtt_p50_us=<n> rtt_p99_us=<n>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "server.h"
+
+#define BENCH_OPS       1000000
+#define LIVE_COMMANDS   2000
+#define TEXT_REQUEST    "@123456 3 2 0\n"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// 컴파일러가 결과를 버리지 못하게 한다
+static volatile int g_sink;
+
+static void bench_text(void) {
+    Command cmd;
+    CommandResponse response = { .request_id = 123456, .status = STATUS_OK };
+    char out[512];
+    int out_len = 0;
+
+    strcpy(response.message, "Brightness set to 2");
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < BENCH_OPS; i++) {
+        const char* p = TEXT_REQUEST;
+        uint32_t request_id = 0;
+        bool has_id;
+        protocol_parse_request_id(&p, &request_id, &has_id);
+        protocol_parse_command(p, &cmd);
+        g_sink += cmd.param1 + (int)request_id;
+    }
+    uint64_t parse_ns = now_ns() - start;
+
+    start = now_ns();
+    for (int i = 0; i < BENCH_OPS; i++) {
+        out_len = protocol_format_response(&response, out, sizeof(out));
+        g_sink += out_len;
+    }
+    uint64_t format_ns = now_ns() - start;
+
+    printf("protocol mode=text ops=%d parse_ns=%.1f format_ns=%.1f "
+           "request_bytes=%zu response_bytes=%d\n",
+           BENCH_OPS, (double)parse_ns / BENCH_OPS, (double)format_ns / BENCH_OPS,
+           strlen(TEXT_REQUEST), out_len);
+}
+
+static void bench_binary(void) {
+    Command cmd = { .type = CMD_SET_BRIGHTNESS, .param1 = 2, .request_id = 123456 };
+    CommandResponse response = { .request_id = 123456, .status = STATUS_OK };
+    uint8_t in[BINARY_COMMAND_FRAME_SIZE];
+    uint8_t out[BINARY_RESPONSE_FRAME_SIZE];
+
+    protocol_encode_command(&cmd, in);
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < BENCH_OPS; i++) {
+        protocol_decode_command(in, &cmd);
+        g_sink += cmd.param1 + (int)cmd.request_id;
+    }
+    uint64_t parse_ns = now_ns() - start;
+
+    start = now_ns();
+    for (int i = 0; i < BENCH_OPS; i++) {
+        response.value = i;
+        protocol_encode_response(&response, out);
+        g_sink += out[8];
+    }
+    uint64_t format_ns = now_ns() - start;
+
+    printf("protocol mode=binary ops=%d parse_ns=%.1f format_ns=%.1f "
+           "request_bytes=%d response_bytes=%d\n",
+           BENCH_OPS, (double)parse_ns / BENCH_OPS, (double)format_ns / BENCH_OPS,
+           BINARY_COMMAND_FRAME_SIZE, BINARY_RESPONSE_FRAME_SIZE);
+}
+
+// ---------------------------------------------------------------------------
+// 실행 중인 서버 대상 측정
+// ---------------------------------------------------------------------------
+static int connect_server(const struct sockaddr_in* addr) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, (const struct sockaddr*)addr, sizeof(*addr)) < 0) {
+        perror("connect");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// pattern이 나올 때까지 수신 (받은 바이트 수 반환)
+static long recv_until(int fd, const char* pattern) {
+    char buf[4096];
+    size_t len = 0;
+    long total = 0;
+
+    for (;;) {
+        ssize_t r = recv(fd, buf + len, sizeof(buf) - 1 - len, 0);
+        if (r <= 0) {
+            return -1;
+        }
+        total += r;
+        len += (size_t)r;
+        buf[len] = '\0';
+        if (strstr(buf, pattern) != NULL) {
+            return total;
+        }
+        // 패턴이 경계에 걸칠 수 있으므로 끝부분만 남긴다
+        if (len > 64) {
+            memmove(buf, buf + len - 64, 64);
+            len = 64;
+        }
+    }
+}
+
+static long recv_exact(int fd, uint8_t* buf, size_t size) {
+    size_t len = 0;
+    while (len < size) {
+        ssize_t r = recv(fd, buf + len, size - len, 0);
+        if (r <= 0) {
+            return -1;
+        }
+        len += (size_t)r;
+    }
+    return (long)len;
+}
+
+static void report_live(const char* mode, int cmds, long tx, long rx, uint64_t* rtt) {
+    qsort(rtt, (size_t)cmds, sizeof(uint64_t), compare_u64);
+    printf("protocol_live mode=%s cmds=%d tx_bytes_per_cmd=%.1f rx_bytes_per_cmd=%.1f "
+           "rtt_p50_us=%llu rtt_p99_us=%llu\n",
+           mode, cmds, (double)tx / cmds, (double)rx / cmds,
+           (unsigned long long)(rtt[cmds / 2] / 1000),
+           (unsigned long long)(rtt[(int)(cmds * 0.99)] / 1000));
+}
+
+static int live_text(const struct sockaddr_in* addr, int cmds, uint64_t* rtt) {
+    int fd = connect_server(addr);
+    if (fd < 0) {
+        return -1;
+    }
+
+    // 빈 줄로 핸드셰이크 대기 시간을 건너뛴다
+    send(fd, "\n", 1, 0);
+    if (recv_until(fd, "Select: ") < 0) {
+        close(fd);
+        return -1;
+    }
+
+    long tx = 0, rx = 0;
+    for (int i = 0; i < cmds; i++) {
+        char line[64];
+        int len = snprintf(line, sizeof(line), "@%d 7 0 0\n", i + 1);
+
+        uint64_t start = now_ns();
+        send(fd, line, (size_t)len, 0);
+        long r = recv_until(fd, "Select: ");    // 응답 + 메뉴
+        rtt[i] = now_ns() - start;
+        if (r < 0) {
+            close(fd);
+            return -1;
+        }
+        tx += len;
+        rx += r;
+    }
+
+    close(fd);
+    report_live("text", cmds, tx, rx, rtt);
+    return 0;
+}
+
+static int live_binary(const struct sockaddr_in* addr, int cmds, uint64_t* rtt) {
+    int fd = connect_server(addr);
+    if (fd < 0) {
+        return -1;
+    }
+
+    uint8_t frame[BINARY_RESPONSE_FRAME_SIZE];
+    send(fd, BINARY_MAGIC, BINARY_MAGIC_LEN, 0);
+    if (recv_exact(fd, frame, sizeof(frame)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    long tx = 0, rx = 0;
+    for (int i = 0; i < cmds; i++) {
+        Command cmd = { .type = CMD_SENSOR_OFF, .request_id = (uint32_t)(i + 1) };
+        uint8_t request[BINARY_COMMAND_FRAME_SIZE];
+        protocol_encode_command(&cmd, request);
+
+        uint64_t start = now_ns();
+        send(fd, request, sizeof(request), 0);
+        long r = recv_exact(fd, frame, sizeof(frame));
+        rtt[i] = now_ns() - start;
+        if (r < 0) {
+            close(fd);
+            return -1;
+        }
+        tx += (long)sizeof(request);
+        rx += r;
+    }
+
+    close(fd);
+    report_live("binary", cmds, tx, rx, rtt);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    bench_text();
+    bench_binary();
+
+    if (argc < 3) {
+        return 0;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)atoi(argv[2]));
+    if (inet_pton(AF_INET, argv[1], &addr.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid host: %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    int cmds = argc > 3 ? atoi(argv[3]) : LIVE_COMMANDS;
+    uint64_t* rtt = calloc((size_t)cmds, sizeof(uint64_t));
+
+    if (live_text(&addr, cmds, rtt) != 0 || live_binary(&addr, cmds, rtt) != 0) {
+        fprintf(stderr, "Live measurement failed\n");
+        free(rtt);
+        return EXIT_FAILURE;
+    }
+
+    free(rtt);
+    return 0;
+}
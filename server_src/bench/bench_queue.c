@@ -0,0 +1,195 @@
+// Command Queue 마이크로벤치마크
+// 기존 mutex + malloc 큐와 lock-free 링 버퍼의 push/pop 처리량과 지연 시간을 비교한다.
+//
+// 출력 형식 (한 줄 = 한 측정):
+//   queue impl=<legacy|ring> producers=<n> ops=<n> ops_per_sec=<n> p50_ns=<n> p99_ns=<n> p999_ns=<n> max_ns=<n>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <time.h>
+#include "server.h"
+
+#define BENCH_OPS       1000000
+#define MAX_PRODUCERS   4
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// 기존 구현 (mutex + condvar + 명령마다 malloc/free)
+// ---------------------------------------------------------------------------
+typedef struct {
+    Command* commands[MAX_QUEUE_SIZE];
+    int front;
+    int rear;
+    int count;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+} LegacyQueue;
+
+static void legacy_init(LegacyQueue* q) {
+    memset(q, 0, sizeof(*q));
+    pthread_mutex_init(&q->mutex, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+}
+
+static bool legacy_push(LegacyQueue* q, const Command* cmd) {
+    pthread_mutex_lock(&q->mutex);
+    if (q->count >= MAX_QUEUE_SIZE) {
+        pthread_mutex_unlock(&q->mutex);
+        return false;
+    }
+    Command* new_cmd = (Command*)malloc(sizeof(Command));
+    memcpy(new_cmd, cmd, sizeof(Command));
+    q->commands[q->rear] = new_cmd;
+    q->rear = (q->rear + 1) % MAX_QUEUE_SIZE;
+    q->count++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->mutex);
+    return true;
+}
+
+static bool legacy_pop(LegacyQueue* q, Command* out) {
+    pthread_mutex_lock(&q->mutex);
+    while (q->count == 0) {
+        pthread_cond_wait(&q->not_empty, &q->mutex);
+    }
+    Command* cmd = q->commands[q->front];
+    q->front = (q->front + 1) % MAX_QUEUE_SIZE;
+    q->count--;
+    pthread_mutex_unlock(&q->mutex);
+
+    *out = *cmd;
+    free(cmd);
+    return true;
+}
+
+static void legacy_destroy(LegacyQueue* q) {
+    pthread_cond_destroy(&q->not_empty);
+    pthread_mutex_destroy(&q->mutex);
+}
+
+// ---------------------------------------------------------------------------
+// 벤치마크 본체
+// ---------------------------------------------------------------------------
+typedef struct {
+    bool use_ring;
+    LegacyQueue legacy;
+    CommandQueue ring;
+    uint64_t* push_time;   // 명령 번호별 push 시각
+    uint64_t* latency;     // 명령 번호별 push -> pop 지연
+    int producers;
+} Bench;
+
+typedef struct {
+    Bench* bench;
+    int first;
+    int count;
+} ProducerArg;
+
+static void* producer_thread(void* arg) {
+    ProducerArg* p = (ProducerArg*)arg;
+    Bench* b = p->bench;
+
+    for (int i = p->first; i < p->first + p->count; i++) {
+        Command cmd = { .type = CMD_LED_ON, .param1 = i, .param2 = 0 };
+        for (;;) {
+            b->push_time[i] = now_ns();
+            bool ok = b->use_ring ? queue_push(&b->ring, &cmd)
+                                  : legacy_push(&b->legacy, &cmd);
+            if (ok) break;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void run(bool use_ring, int producers) {
+    static Bench b;
+    memset(&b, 0, sizeof(b));
+    b.use_ring = use_ring;
+    b.producers = producers;
+    b.push_time = calloc(BENCH_OPS, sizeof(uint64_t));
+    b.latency = calloc(BENCH_OPS, sizeof(uint64_t));
+
+    if (use_ring) {
+        queue_init(&b.ring);
+    } else {
+        legacy_init(&b.legacy);
+    }
+
+    pthread_t threads[MAX_PRODUCERS];
+    ProducerArg args[MAX_PRODUCERS];
+    int per_thread = BENCH_OPS / producers;
+
+    uint64_t start = now_ns();
+
+    for (int i = 0; i < producers; i++) {
+        args[i].bench = &b;
+        args[i].first = i * per_thread;
+        args[i].count = per_thread;
+        pthread_create(&threads[i], NULL, producer_thread, &args[i]);
+    }
+
+    // 소비자 (device thread 역할)
+    int total = per_thread * producers;
+    for (int n = 0; n < total; n++) {
+        Command cmd;
+        if (use_ring) {
+            while (!queue_pop(&b.ring, &cmd)) {
+                queue_wait(&b.ring, 10);
+            }
+        } else {
+            legacy_pop(&b.legacy, &cmd);
+        }
+        b.latency[n] = now_ns() - b.push_time[cmd.param1];
+    }
+
+    uint64_t elapsed = now_ns() - start;
+
+    for (int i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    qsort(b.latency, total, sizeof(uint64_t), compare_u64);
+
+    printf("queue impl=%s producers=%d ops=%d ops_per_sec=%.0f "
+           "p50_ns=%llu p99_ns=%llu p999_ns=%llu max_ns=%llu\n",
+           use_ring ? "ring" : "legacy", producers, total,
+           total / (elapsed / 1e9),
+           (unsigned long long)b.latency[total / 2],
+           (unsigned long long)b.latency[(int)(total * 0.99)],
+           (unsigned long long)b.latency[(int)(total * 0.999)],
+           (unsigned long long)b.latency[total - 1]);
+
+    if (use_ring) {
+        queue_cleanup(&b.ring);
+    } else {
+        legacy_destroy(&b.legacy);
+    }
+    free(b.push_time);
+    free(b.latency);
+}
+
+int main(void) {
+    int producer_counts[] = { 1, MAX_PRODUCERS };
+
+    for (size_t i = 0; i < sizeof(producer_counts) / sizeof(producer_counts[0]); i++) {
+        run(false, producer_counts[i]);
+        run(true, producer_counts[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+// 디바이스 상태 읽기 경합 벤치마크
+// writer 1개(디바이스 lane 역할)가 상태를 계속 고치는 동안 reader N개(STATUS 조회, 센서 루프 역할)가
+// 상태를 읽는다. 기존 방식(state_mutex)과 seqlock 저장소를 비교한다.
+// - reads_per_sec: 모든 reader가 읽은 일관된 스냅샷 수의 합
+// - write_*_ns: writer의 쓰기 구간(잠금 ~ 해제) 시간. reader가 많아도 늘지 않아야 한다.
+//
+// 출력 형식 (한 줄 = 한 측정):
+//   state impl=<mutex|seqlock> readers=<n> reads_per_sec=<n> writes_per_sec=<n> write_p50_ns=<n> write_p99_ns=<n>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "server.h"
+
+#define RUN_MS          500
+#define WRITE_GAP_NS    1000    // 쓰기 사이 명령 처리 시간
+#define MAX_SAMPLES     (1 << 20)
+#define MAX_READERS     16
+
+typedef struct {
+    bool use_seqlock;
+    atomic_bool done;
+    DeviceState store;
+    pthread_mutex_t mutex;
+    DeviceStatus locked_status;
+    uint64_t* write_latency;
+    int writes;
+    _Alignas(CACHE_LINE_SIZE) unsigned long reads[MAX_READERS][CACHE_LINE_SIZE / sizeof(unsigned long)];
+} Bench;
+
+typedef struct {
+    Bench* bench;
+    int index;
+} ReaderArg;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// 컴파일러가 읽은 값을 버리지 못하게 한다
+static volatile int g_sink;
+
+static void* reader_thread(void* arg) {
+    ReaderArg* r = (ReaderArg*)arg;
+    Bench* b = r->bench;
+    unsigned long count = 0;
+    int sink = 0;
+
+    while (!atomic_load_explicit(&b->done, memory_order_relaxed)) {
+        DeviceStatus status;
+
+        if (b->use_seqlock) {
+            device_state_read(&b->store, &status);
+        } else {
+            pthread_mutex_lock(&b->mutex);
+            status = b->locked_status;
+            pthread_mutex_unlock(&b->mutex);
+        }
+        sink += status.led_brightness;
+        count++;
+    }
+
+    g_sink += sink;
+    b->reads[r->index][0] = count;
+    return NULL;
+}
+
+static void write_once(Bench* b, int i) {
+    if (b->use_seqlock) {
+        DeviceStatus* dev = device_state_begin_write(&b->store);
+        dev->led_on = (i & 1) != 0;
+        dev->led_brightness = i % 3 + 1;
+        device_state_end_write(&b->store);
+    } else {
+        pthread_mutex_lock(&b->mutex);
+        b->locked_status.led_on = (i & 1) != 0;
+        b->locked_status.led_brightness = i % 3 + 1;
+        pthread_mutex_unlock(&b->mutex);
+    }
+}
+
+static void run(bool use_seqlock, int readers) {
+    static Bench b;
+    memset(&b, 0, sizeof(b));
+    b.use_seqlock = use_seqlock;
+    b.write_latency = calloc(MAX_SAMPLES, sizeof(uint64_t));
+    atomic_init(&b.done, false);
+    device_state_init(&b.store);
+    pthread_mutex_init(&b.mutex, NULL);
+
+    pthread_t threads[MAX_READERS];
+    ReaderArg args[MAX_READERS];
+    for (int i = 0; i < readers; i++) {
+        args[i].bench = &b;
+        args[i].index = i;
+        pthread_create(&threads[i], NULL, reader_thread, &args[i]);
+    }
+
+    // writer (디바이스 lane 역할)
+    uint64_t start = now_ns();
+    uint64_t end = start + (uint64_t)RUN_MS * 1000000ULL;
+    uint64_t now = start;
+    while (now < end) {
+        uint64_t t0 = now_ns();
+        write_once(&b, b.writes);
+        uint64_t t1 = now_ns();
+
+        if (b.writes < MAX_SAMPLES) {
+            b.write_latency[b.writes] = t1 - t0;
+        }
+        b.writes++;
+
+        do {
+            now = now_ns();
+        } while (now < t1 + WRITE_GAP_NS);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    atomic_store(&b.done, true);
+    unsigned long total_reads = 0;
+    for (int i = 0; i < readers; i++) {
+        pthread_join(threads[i], NULL);
+        total_reads += b.reads[i][0];
+    }
+
+    int samples = b.writes < MAX_SAMPLES ? b.writes : MAX_SAMPLES;
+    qsort(b.write_latency, (size_t)samples, sizeof(uint64_t), compare_u64);
+
+    printf("state impl=%s readers=%d reads_per_sec=%.0f writes_per_sec=%.0f "
+           "write_p50_ns=%llu write_p99_ns=%llu\n",
+           use_seqlock ? "seqlock" : "mutex", readers,
+           (double)total_reads * 1e9 / (double)elapsed,
+           (double)b.writes * 1e9 / (double)elapsed,
+           (unsigned long long)b.write_latency[samples / 2],
+           (unsigned long long)b.write_latency[(int)(samples * 0.99)]);
+
+    pthread_mutex_destroy(&b.mutex);
+    free(b.write_latency);
+}
+
+int main(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_readers = (cpus > 1 && cpus - 1 < MAX_READERS) ? (int)cpus - 1 : MAX_READERS;
+
+    for (int readers = 1; readers <= max_readers; readers *= 2) {
+        run(false, readers);
+        run(true, readers);
+    }
+    return 0;
+}
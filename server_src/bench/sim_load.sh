@@ -0,0 +1,96 @@
+#!/bin/bash
+# 하드웨어 없는 부하 시험 (x86 CI용, server_src에서 실행: make sim-load)
+# sim GPIO 백엔드로 서버를 띄워 조도 입력 스크립트를 돌리고, 한 연결(세션)로 디바이스 명령을 보내
+# LED / 부저 / 4자리 7-Segment를 움직이는 동안 bench_connections와 loadgen으로 부하를 건 뒤 SIGINT로 종료한다.
+# 세션 명령은 모두 성공해야 한다 (부하 시간 + HOLD가 곡 길이 약 13초보다 짧아야 정지 명령이 성공).
+# 서버 로그, 세션 응답(client.log), GPIO 트레이스는 OUT 디렉토리에 남는다.
+#
+# 사용법: bench/sim_load.sh [bench_connections 연결 수...]   (기본: 1 8 64)
+# 환경 변수: OUT (기본 sim_out), GPIO_SIM_SCRIPT (기본 bench/light.sim), GPIO_SIM_LATENCY,
+#            COMMANDS (연결당 명령 수, 기본 200), DEPTH (기본 4),
+#            LOADGEN (loadgen 경로, 기본 ../client_src/loadgen), LOADGEN_ARGS (기본 -c 8 -d 2),
+#            HOLD (부하 뒤 센서 스크립트 / 카운트다운 / 곡이 도는 동안 기다릴 초, 기본 3)
+# 출력: bench_connections / loadgen 결과 줄 + 마지막 줄 (실패하면 종료 코드 1)
+#   sim_load status=ok exit=0 writes=<n> pwm=<n> tone=<n> inputs=<n> edges=<n> trace_lines=<n> errors=<n> session_answers=<n> session_errors=<n>
+
+PORT=8080
+SEG_DIGITS=5,6,13,19:26     # 다자리 refresh와 mm:ss 카운트다운까지 돌도록 4자리 + 콜론
+OUT=${OUT:-sim_out}
+COMMANDS=${COMMANDS:-200}
+DEPTH=${DEPTH:-4}
+HOLD=${HOLD:-3}
+LOADGEN=${LOADGEN:-../client_src/loadgen}
+LOADGEN_ARGS=${LOADGEN_ARGS:--c 8 -d 2}
+CONNS=("$@")
+[ ${#CONNS[@]} -eq 0 ] && CONNS=(1 8 64)
+
+fail() {
+    echo "sim_load status=fail reason=$1"
+    [ -n "$SERVER_PID" ] && kill -INT "$SERVER_PID" 2>/dev/null
+    exit 1
+}
+
+[ -x ./server ] && [ -x ./bench/bench_connections ] || fail "build_server_and_bench_connections_first"
+[ -x "$LOADGEN" ] || fail "build_loadgen_first"
+
+# 빌드 디렉토리의 라이브러리를 soname 이름으로 링크 (설치하지 않고 실행)
+mkdir -p "$OUT/lib"
+for lib in ../gpio/libgpio_hal.so ../scheduler/libscheduler.so ../led/libled.so \
+           ../buzzer/libbuzzer.so ../light_sensor/liblight_sensor.so ../7segment/lib7segment.so; do
+    [ -f "$lib" ] || fail "missing_$(basename "$lib")"
+    soname=$(readelf -d "$lib" | sed -n 's/.*SONAME.*\[\(.*\)\]/\1/p')
+    ln -sf "$(readlink -f "$lib")" "$OUT/lib/${soname:-$(basename "$lib")}"
+done
+
+export LD_LIBRARY_PATH="$OUT/lib${LD_LIBRARY_PATH:+:$LD_LIBRARY_PATH}"
+export GPIO_SIM_TRACE="$OUT/gpio.trace"
+export GPIO_SIM_SCRIPT=${GPIO_SIM_SCRIPT:-bench/light.sim}
+
+./server -g sim -s "$SEG_DIGITS" > "$OUT/server.log" 2>&1 &
+SERVER_PID=$!
+
+for _ in $(seq 50); do
+    grep -q "Listening on port" "$OUT/server.log" && break
+    kill -0 "$SERVER_PID" 2>/dev/null || fail "server_exited"
+    sleep 0.1
+done
+grep -q "Listening on port" "$OUT/server.log" || fail "server_not_listening"
+
+# 디바이스 세션: 감시 시작, LED 켜고 밝기, 60초 카운트다운, 곡 2 재생 (부하가 걸리는 동안 진행)
+exec 3<>/dev/tcp/127.0.0.1/$PORT || fail "connect"
+printf '\n6 0 0\n1 0 0\n3 2 0\n8 60 0\n4 2 0\n' >&3
+
+./bench/bench_connections 127.0.0.1 $PORT "$COMMANDS" "$DEPTH" "${CONNS[@]}" | tee "$OUT/bench.log"
+# shellcheck disable=SC2086
+"$LOADGEN" -p $PORT $LOADGEN_ARGS 127.0.0.1 | tee -a "$OUT/bench.log"
+sleep "$HOLD"
+
+# 정지 명령은 디바이스 lane이 처리하므로 응답이 돌아온 뒤에 연결을 끊는다 (세션 명령 11개 모두 응답해야 함)
+printf '11 0 0\n12 10 0\n5 0 0\n9 0 0\n7 0 0\n2 0 0\n' >&3
+sleep 1
+printf '0 0 0\n' >&3
+timeout 5 cat <&3 > "$OUT/client.log"
+exec 3>&-
+
+kill -INT "$SERVER_PID"
+wait "$SERVER_PID"
+status=$?
+
+summary=$(grep '^gpio_sim ' "$OUT/server.log" | tail -1)
+value() { echo "$summary" | sed -n "s/.* $1=\([0-9]*\).*/\1/p"; }
+writes=$(value writes)
+inputs=$(value inputs)
+session_errors=$(grep -ac '\[ERROR\]' "$OUT/client.log")
+session_answers=$(grep -ao '\[#[0-9]*\]' "$OUT/client.log" | wc -l)
+errors=$(awk '$1 == "connections" || $1 == "loadgen" { for (i = 1; i <= NF; i++) if ($i ~ /^errors=/) { split($i, kv, "="); sum += kv[2] } } END { print sum + 0 }' "$OUT/bench.log")
+
+result=ok
+if [ $status -ne 0 ] || [ -z "$summary" ] || [ "${writes:-0}" -eq 0 ] || [ "${inputs:-0}" -eq 0 ] || [ "$errors" -ne 0 ] || \
+   [ "$session_errors" -ne 0 ] || [ "$session_answers" -ne 11 ] || ! grep -aq 'Countdown started' "$OUT/client.log"; then
+    result=fail
+fi
+
+echo "sim_load status=$result exit=$status writes=${writes:-0} pwm=$(value pwm) tone=$(value tone)" \
+     "inputs=${inputs:-0} edges=$(value edges) trace_lines=$(wc -l < "$GPIO_SIM_TRACE") errors=$errors" \
+     "session_answers=$session_answers session_errors=$session_errors"
+[ $result = ok ]
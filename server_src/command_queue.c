@@ -1,54 +1,215 @@
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "server.h"
 
-void queue_init(CommandQueue* queue) {
-    queue->front = 0;
-    queue->rear = 0;
-    queue->count = 0;
-    memset(queue->commands, 0, sizeof(queue->commands));
+// 고정 크기 링 버퍼 (Command를 값으로 저장)
+// - 생산자: 여러 스레드 가능 (head CAS)
+// - 소비자: 단일 스레드 (해당 디바이스 lane의 worker)
+// 각 슬롯의 sequence 값으로 슬롯의 사용 가능 여부를 판단한다.
+//   sequence == pos       : 생산자가 쓸 수 있음
+//   sequence == pos + 1   : 소비자가 읽을 수 있음
+//
+// 우선순위마다 링을 하나씩 두고, 소비자는 긴급(stop/abort) 링을 먼저 비운다.
+// 긴급 명령이 PRIORITY_STARVATION_LIMIT개 연속으로 처리되면 일반 명령을 하나 처리해
+// 일반 명령이 무한정 밀리지 않도록 한다.
+
+#define QUEUE_MASK (MAX_QUEUE_SIZE - 1)
+
+_Static_assert((MAX_QUEUE_SIZE & QUEUE_MASK) == 0,
+               "MAX_QUEUE_SIZE must be a power of two");
+
+static void ring_init(CommandRing* ring) {
+    for (unsigned int i = 0; i < MAX_QUEUE_SIZE; i++) {
+        atomic_init(&ring->slots[i].sequence, i);
+        memset(&ring->slots[i].command, 0, sizeof(Command));
+    }
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
 }
 
-bool queue_push(CommandQueue* queue, Command* cmd) {
-    if (queue->count >= MAX_QUEUE_SIZE) {
+static bool ring_push(CommandRing* ring, const Command* cmd) {
+    QueueSlot* slot;
+    unsigned int pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    
+    for (;;) {
+        slot = &ring->slots[pos & QUEUE_MASK];
+        unsigned int seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int diff = (int)(seq - pos);
+        
+        if (diff == 0) {
+            // 슬롯 예약 (실패 시 pos가 최신 head로 갱신됨)
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 가득 참
+            return false;
+        } else {
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+    
+    slot->command = *cmd;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+static bool ring_pop(CommandRing* ring, Command* cmd) {
+    unsigned int pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    QueueSlot* slot = &ring->slots[pos & QUEUE_MASK];
+    unsigned int seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    
+    if (seq != pos + 1) {
         return false;
     }
     
-    Command* new_cmd = (Command*)malloc(sizeof(Command));
-    if (!new_cmd) {
+    *cmd = slot->command;
+    
+    // 슬롯을 다음 바퀴의 생산자에게 반환
+    atomic_store_explicit(&slot->sequence, pos + MAX_QUEUE_SIZE, memory_order_release);
+    atomic_store_explicit(&ring->tail, pos + 1, memory_order_relaxed);
+    
+    return true;
+}
+
+static bool ring_is_empty(CommandRing* ring) {
+    unsigned int pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    QueueSlot* slot = &ring->slots[pos & QUEUE_MASK];
+    
+    return atomic_load_explicit(&slot->sequence, memory_order_acquire) != pos + 1;
+}
+
+int queue_init(CommandQueue* queue) {
+    for (int i = 0; i < PRIORITY_COUNT; i++) {
+        ring_init(&queue->rings[i]);
+    }
+    queue->urgent_streak = 0;
+    queue->closed = false;
+    atomic_init(&queue->waiting, 0);
+    
+    // 대기용 condition은 CLOCK_MONOTONIC 기준
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    
+    if (pthread_mutex_init(&queue->wait_mutex, NULL) != 0) {
+        pthread_condattr_destroy(&attr);
+        return -1;
+    }
+    
+    if (pthread_cond_init(&queue->not_empty, &attr) != 0) {
+        pthread_mutex_destroy(&queue->wait_mutex);
+        pthread_condattr_destroy(&attr);
+        return -1;
+    }
+    
+    pthread_condattr_destroy(&attr);
+    return 0;
+}
+
+bool queue_push_priority(CommandQueue* queue, const Command* cmd, CommandPriority priority) {
+    if (!ring_push(&queue->rings[priority], cmd)) {
         return false;
     }
     
-    memcpy(new_cmd, cmd, sizeof(Command));
-    queue->commands[queue->rear] = new_cmd;
-    queue->rear = (queue->rear + 1) % MAX_QUEUE_SIZE;
-    queue->count++;
+    // 소비자가 잠들어 있을 때만 깨운다 (queue_wait과 짝을 이루는 fence)
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&queue->waiting, memory_order_relaxed)) {
+        pthread_mutex_lock(&queue->wait_mutex);
+        pthread_cond_signal(&queue->not_empty);
+        pthread_mutex_unlock(&queue->wait_mutex);
+    }
     
     return true;
 }
 
-Command* queue_pop(CommandQueue* queue) {
-    if (queue->count == 0) {
-        return NULL;
+bool queue_push(CommandQueue* queue, const Command* cmd) {
+    return queue_push_priority(queue, cmd, PRIORITY_NORMAL);
+}
+
+bool queue_pop(CommandQueue* queue, Command* cmd) {
+    if (queue->urgent_streak < PRIORITY_STARVATION_LIMIT &&
+        ring_pop(&queue->rings[PRIORITY_URGENT], cmd)) {
+        queue->urgent_streak++;
+        return true;
     }
     
-    Command* cmd = queue->commands[queue->front];
-    queue->commands[queue->front] = NULL;
-    queue->front = (queue->front + 1) % MAX_QUEUE_SIZE;
-    queue->count--;
+    if (ring_pop(&queue->rings[PRIORITY_NORMAL], cmd)) {
+        queue->urgent_streak = 0;
+        return true;
+    }
     
-    return cmd;
+    // 일반 명령이 없으면 제한 없이 긴급 명령 처리
+    if (ring_pop(&queue->rings[PRIORITY_URGENT], cmd)) {
+        queue->urgent_streak = 0;
+        return true;
+    }
+    
+    return false;
 }
 
 bool queue_is_empty(CommandQueue* queue) {
-    return queue->count == 0;
+    for (int i = 0; i < PRIORITY_COUNT; i++) {
+        if (!ring_is_empty(&queue->rings[i])) {
+            return false;
+        }
+    }
+    return true;
 }
 
-void queue_cleanup(CommandQueue* queue) {
-    while (!queue_is_empty(queue)) {
-        Command* cmd = queue_pop(queue);
-        if (cmd) {
-            free(cmd);
+bool queue_wait(CommandQueue* queue, int timeout_ms) {
+    pthread_mutex_lock(&queue->wait_mutex);
+    
+    atomic_store_explicit(&queue->waiting, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    
+    if (!queue->closed && queue_is_empty(queue)) {
+        if (timeout_ms < 0) {
+            // timeout 없이 대기 (push 또는 queue_close로 깨어남)
+            pthread_cond_wait(&queue->not_empty, &queue->wait_mutex);
+        } else {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            ts.tv_sec += timeout_ms / 1000;
+            ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+            
+            pthread_cond_timedwait(&queue->not_empty, &queue->wait_mutex, &ts);
         }
     }
+    
+    atomic_store_explicit(&queue->waiting, 0, memory_order_relaxed);
+    pthread_mutex_unlock(&queue->wait_mutex);
+    
+    return !queue_is_empty(queue);
+}
+
+void queue_wakeup(CommandQueue* queue) {
+    pthread_mutex_lock(&queue->wait_mutex);
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->wait_mutex);
+}
+
+// 이후 queue_wait은 바로 반환 (timeout 없이 기다리는 소비자를 종료시킬 때 사용)
+void queue_close(CommandQueue* queue) {
+    pthread_mutex_lock(&queue->wait_mutex);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->wait_mutex);
+}
+
+void queue_cleanup(CommandQueue* queue) {
+    Command cmd;
+    while (queue_pop(queue, &cmd)) {
+        // 남은 명령 폐기
+    }
+    
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->wait_mutex);
 }
@@ -1,13 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unistd.h>
-#include <sys/socket.h>
-#include <errno.h>
 #include "server.h"
 
-static void send_menu(int client_socket) {
-    const char* menu = 
+// 연결별 프로토콜 처리
+// 소켓 I/O는 reactor가 담당하고, 여기서는 수신한 데이터를 해석해
+// 명령을 큐에 넣고 응답/프롬프트/메뉴를 conn_send로 내보낸다.
+
+static void send_text(Connection* conn, const char* text) {
+    conn_send(conn, text, strlen(text));
+}
+
+static void send_menu(Connection* conn) {
+    const char* menu =
         "\n[ Device Control Menu ]\n"
         "1. LED ON\n"
         "2. LED OFF\n"
@@ -18,44 +23,418 @@ static void send_menu(int client_socket) {
         "7. SENSOR OFF (감시 종료)\n"
         "8. SEGMENT DISPLAY (숫자 표시 후 카운트다운)\n"
         "9. SEGMENT STOP (카운트다운 중단)\n"
+        "10. SUBSCRIBE EVENTS (1:LED 2:Buzzer 4:Segment 8:Sensor 합, 0:해제)\n"
+        "11. STATUS (디바이스 상태 조회)\n"
+        "12. SENSOR HISTORY (최근 N초 조도 통계)\n"
+        "13. MUSIC LIST (재생할 수 있는 곡 목록)\n"
         "0. Exit\n"
         "Select: ";
     
-    send(client_socket, menu, strlen(menu), 0);
+    send_text(conn, menu);
 }
 
-static bool parse_command(const char* buffer, Command* cmd) {
-    int type, param1 = 0, param2 = 0;
+static void send_response(Connection* conn, const CommandResponse* response) {
+    if (conn->mode == CONN_MODE_BINARY) {
+        uint8_t frame[BINARY_RESPONSE_FRAME_SIZE];
+        protocol_encode_response(response, frame);
+        conn_send(conn, (const char*)frame, sizeof(frame));
+        return;
+    }
     
-    if (sscanf(buffer, "%d %d %d", &type, &param1, &param2) < 1) {
-        return false;
+    char buffer[512];
+    int len = protocol_format_response(response, buffer, sizeof(buffer));
+    conn_send(conn, buffer, (size_t)len);
+}
+
+static void send_error(Connection* conn, uint32_t request_id, ResponseStatus status,
+                       const char* message) {
+    CommandResponse response = {0};
+    response.request_id = request_id;
+    response.status = status;
+    snprintf(response.message, sizeof(response.message), "%s", message);
+    send_response(conn, &response);
+}
+
+static void send_event(Connection* conn, const DeviceEvent* event, unsigned int coalesced) {
+    if (conn->mode == CONN_MODE_BINARY) {
+        uint8_t frame[BINARY_EVENT_FRAME_SIZE];
+        protocol_encode_event(event, frame);
+        conn_send(conn, (const char*)frame, sizeof(frame));
+        return;
+    }
+    
+    char buffer[128];
+    int len = protocol_format_event(event, coalesced, buffer, sizeof(buffer));
+    conn_send(conn, buffer, (size_t)len);
+}
+
+// 출력이 밀려 있으면 (소켓 버퍼가 가득 찼거나 보낼 데이터가 많이 쌓임) 느린 구독자로 본다
+static bool conn_backlogged(const Connection* conn) {
+    return conn->want_write || conn->out_len >= EVENT_BACKLOG_BYTES;
+}
+
+// 이벤트 구독 변경 (디바이스 lane을 거치지 않고 바로 응답)
+static void handle_subscribe(ServerState* state, Connection* conn, const Command* cmd) {
+    CommandResponse response = {0};
+    response.request_id = cmd->request_id;
+    conn->menu_pending = true;
+    
+    if (cmd->param1 < 0 || cmd->param1 > EVENT_MASK_ALL) {
+        send_error(conn, cmd->request_id, STATUS_INVALID, "Invalid event mask (use 0-15)");
+        return;
+    }
+    
+    unsigned int mask = (unsigned int)cmd->param1;
+    if (conn->event_mask == 0 && mask != 0) {
+        state->subscriber_count++;
+    } else if (conn->event_mask != 0 && mask == 0) {
+        state->subscriber_count--;
+    }
+    conn->event_mask = mask;
+    conn->events_held &= mask;
+    
+    response.status = STATUS_OK;
+    response.value = (int)mask;
+    if (mask == 0) {
+        strcpy(response.message, "Unsubscribed from events");
+    } else {
+        size_t len = (size_t)snprintf(response.message, sizeof(response.message),
+                                      "Subscribed to events:");
+        for (int i = 0; i < EVENT_DEVICE_COUNT; i++) {
+            if (mask & (1u << i)) {
+                len += (size_t)snprintf(response.message + len, sizeof(response.message) - len,
+                                        " %s", event_device_name((EventDevice)i));
+            }
+        }
+    }
+    
+    printf("[Comm] Conn %u event mask: 0x%x\n", conn->conn_id, mask);
+    send_response(conn, &response);
+}
+
+// 상태 조회: 게시된 스냅샷으로 바로 응답 (디바이스 lane에 부하를 주지 않는다)
+static void handle_status(ServerState* state, Connection* conn, const Command* cmd) {
+    DeviceStatus status;
+    long long now = monotonic_ms();
+    
+    device_state_read(&state->device, &status);
+    
+    CommandResponse response = {0};
+    response.request_id = cmd->request_id;
+    response.status = STATUS_OK;
+    response.value = protocol_status_value(&status, now);
+    protocol_format_status(&status, now, response.message, sizeof(response.message));
+    
+    send_response(conn, &response);
+}
+
+// 센서 기록 조회: 시계열 저장소에서 바로 계산해 응답
+static void handle_sensor_history(ServerState* state, Connection* conn, const Command* cmd) {
+    if (cmd->param1 < 1 || cmd->param1 > HISTORY_MAX_WINDOW_SEC ||
+        cmd->param2 < 0 || cmd->param2 > HISTORY_MAX_WINDOW_SEC) {
+        send_error(conn, cmd->request_id, STATUS_INVALID,
+                   "Invalid window (use 1-604800 seconds)");
+        return;
+    }
+    
+    if (!state->sensor_sampler) {
+        send_error(conn, cmd->request_id, STATUS_FAILED,
+                   "Sensor history needs the light sampler (-r > 0)");
+        return;
+    }
+    
+    long long to_ms = realtime_ms() - (long long)cmd->param2 * 1000;
+    long long from_ms = to_ms - (long long)cmd->param1 * 1000;
+    HistoryStats stats;
+    
+    if (!sensor_history_query(&state->history, from_ms, to_ms, &stats)) {
+        send_error(conn, cmd->request_id, STATUS_FAILED, "No sensor samples in window");
+        return;
+    }
+    
+    CommandResponse response = {0};
+    response.request_id = cmd->request_id;
+    response.status = STATUS_OK;
+    response.value = protocol_history_value(&stats);
+    protocol_format_history(&stats, cmd->param1, response.message, sizeof(response.message));
+    
+    send_response(conn, &response);
+}
+
+// 곡 목록: 카탈로그는 시작할 때 한 번 만들어지므로 lane을 거치지 않고 바로 응답
+static void handle_music_list(Connection* conn, const Command* cmd) {
+    MusicInfo infos[MUSIC_MAX_MELODIES];
+    int count = music_list(infos, MUSIC_MAX_MELODIES);
+    
+    if (count > MUSIC_MAX_MELODIES) {
+        count = MUSIC_MAX_MELODIES;
+    }
+    
+    if (conn->mode == CONN_MODE_BINARY) {
+        CommandResponse response = {0};
+        response.request_id = cmd->request_id;
+        response.status = STATUS_OK;
+        response.value = count;
+        send_response(conn, &response);
+        return;
     }
     
-    cmd->type = (CommandType)type;
-    cmd->param1 = param1;
-    cmd->param2 = param2;
+    // 곡이 많으면 응답 메시지(256 bytes)를 넘으므로 직접 한 줄로 만든다
+    char buffer[MUSIC_MAX_MELODIES * (MUSIC_NAME_SIZE + 6) + 64];
+    int len = snprintf(buffer, sizeof(buffer), "[#%u] [SUCCESS] ", cmd->request_id);
+    len += protocol_format_music_list(infos, count, buffer + len, sizeof(buffer) - (size_t)len - 1);
+    buffer[len++] = '\n';
+    conn_send(conn, buffer, (size_t)len);
+}
+
+// 곡 이름을 번호로 바꾼다 (카탈로그에 없으면 오류 응답 후 false)
+static bool resolve_music_name(Connection* conn, Command* cmd, const char* name) {
+    int music_number = music_find(name);
     
+    if (music_number < 0) {
+        send_error(conn, cmd->request_id, STATUS_INVALID, "Unknown melody name (see 13 for the list)");
+        conn->menu_pending = true;
+        return false;
+    }
+    cmd->param1 = music_number;
     return true;
 }
 
-static bool send_response(int client_socket, const CommandResponse* response) {
-    char buffer[512];
+static InflightSlot* inflight_slot(Connection* conn, uint32_t request_id) {
+    return &conn->inflight[request_id % MAX_INFLIGHT];
+}
+
+// 완료 슬롯 예약 (같은 슬롯의 요청이 아직 처리 중이면 NULL)
+static InflightSlot* reserve_inflight(Connection* conn, uint32_t request_id) {
+    InflightSlot* slot = inflight_slot(conn, request_id);
     
-    if (response->status == 0) {
-        snprintf(buffer, sizeof(buffer), "[SUCCESS] %s\n", response->message);
-    } else {
-        snprintf(buffer, sizeof(buffer), "[ERROR] %s\n", response->message);
+    if (slot->in_use) {
+        send_error(conn, request_id, STATUS_BUSY, "Too many commands in flight");
+        return NULL;
+    }
+    return slot;
+}
+
+static void commit_inflight(Connection* conn, InflightSlot* slot, uint32_t request_id) {
+    slot->in_use = true;
+    slot->request_id = request_id;
+    slot->deadline_ms = monotonic_ms() + COMMAND_TIMEOUT_MS;
+    conn->inflight_count++;
+}
+
+// 완료 슬롯을 예약하고 해당 디바이스 lane의 큐에 추가 (응답은 기다리지 않는다)
+static void submit_command(ServerState* state, Connection* conn, Command* cmd) {
+    conn->menu_pending = true;
+    
+    if (cmd->type == CMD_SUBSCRIBE) {
+        handle_subscribe(state, conn, cmd);
+        return;
     }
     
-    ssize_t sent = send(client_socket, buffer, strlen(buffer), 0);
-    return sent > 0;
+    if (cmd->type == CMD_STATUS) {
+        handle_status(state, conn, cmd);
+        return;
+    }
+    
+    if (cmd->type == CMD_SENSOR_HISTORY) {
+        handle_sensor_history(state, conn, cmd);
+        return;
+    }
+    
+    if (cmd->type == CMD_MUSIC_LIST) {
+        handle_music_list(conn, cmd);
+        return;
+    }
+    
+    if (command_lane(cmd->type) < 0) {
+        send_error(conn, cmd->request_id, STATUS_INVALID, "Unknown command");
+        return;
+    }
+    
+    InflightSlot* slot = reserve_inflight(conn, cmd->request_id);
+    if (!slot) {
+        return;
+    }
+    
+    if (!device_submit(state, cmd)) {
+        send_error(conn, cmd->request_id, STATUS_QUEUE_FULL, "Command queue full");
+        return;
+    }
+    
+    commit_inflight(conn, slot, cmd->request_id);
+}
+
+// batch: "B <type> <p1> <p2>;<type> <p1> <p2>;..." -> 응답 하나
+static void submit_batch(ServerState* state, Connection* conn, char* body, uint32_t request_id) {
+    Command commands[MAX_BATCH_COMMANDS];
+    int count = 0;
+    char* saveptr = NULL;
+    
+    conn->menu_pending = true;
+    
+    for (char* item = strtok_r(body, ";", &saveptr);
+         item != NULL;
+         item = strtok_r(NULL, ";", &saveptr)) {
+        if (count == MAX_BATCH_COMMANDS) {
+            send_error(conn, request_id, STATUS_INVALID, "Too many commands in batch");
+            return;
+        }
+        
+        Command* cmd = &commands[count];
+        if (!protocol_parse_command(item, cmd) || command_lane(cmd->type) < 0) {
+            send_error(conn, request_id, STATUS_INVALID, "Invalid command in batch");
+            return;
+        }
+        cmd->request_id = request_id;
+        cmd->conn_id = conn->conn_id;
+        count++;
+    }
+    
+    if (count == 0) {
+        send_error(conn, request_id, STATUS_INVALID, "Empty batch");
+        return;
+    }
+    
+    InflightSlot* slot = reserve_inflight(conn, request_id);
+    if (!slot) {
+        return;
+    }
+    
+    if (!device_submit_batch(state, commands, count, request_id, conn->conn_id)) {
+        send_error(conn, request_id, STATUS_QUEUE_FULL, "Batch queue full");
+        return;
+    }
+    
+    commit_inflight(conn, slot, request_id);
 }
 
-void* communication_thread(void* arg) {
-    ServerState* state = (ServerState*)arg;
-    int client_socket = state->client_socket;
+// 프롬프트 응답 (brightness, music number or name, countdown seconds)
+static void handle_prompt_reply(ServerState* state, Connection* conn, const char* line) {
+    Command cmd = conn->pending_cmd;
+    bool awaiting_music = (conn->state == CONN_STATE_AWAIT_MUSIC);
+    char name[MUSIC_NAME_SIZE];
     
-    printf("[Comm Thread] Started for client socket %d\n", client_socket);
+    conn->state = CONN_STATE_COMMAND;
+    
+    if (awaiting_music && protocol_parse_name(&line, name, sizeof(name))) {
+        if (resolve_music_name(conn, &cmd, name)) {
+            submit_command(state, conn, &cmd);
+        }
+        return;
+    }
+    
+    if (!protocol_parse_int(&line, &cmd.param1)) {
+        send_error(conn, cmd.request_id, STATUS_INVALID, "Invalid number");
+        conn->menu_pending = true;
+        return;
+    }
+    submit_command(state, conn, &cmd);
+}
+
+// 한 줄(명령 하나) 처리. 연결을 끊어야 하면 false 반환
+static bool handle_line(ServerState* state, Connection* conn, char* line) {
+    // 개행 문자 제거
+    char* newline = strchr(line, '\r');
+    if (newline) *newline = '\0';
+    
+    if (line[0] == '\0') {
+        return true;
+    }
+    
+    if (conn->state != CONN_STATE_COMMAND) {
+        handle_prompt_reply(state, conn, line);
+        return true;
+    }
+    
+    printf("[Comm] Conn %u received: %s\n", conn->conn_id, line);
+    
+    const char* p = line;
+    uint32_t request_id = 0;
+    bool has_id;
+    
+    if (!protocol_parse_request_id(&p, &request_id, &has_id)) {
+        send_text(conn, "[ERROR] Invalid command format\n");
+        conn->menu_pending = true;
+        return true;
+    }
+    
+    // batch 프레임
+    if (*p == 'B' || *p == 'b') {
+        if (!has_id) {
+            request_id = conn->next_request_id++;
+        }
+        submit_batch(state, conn, line + (p - line) + 1, request_id);
+        return true;
+    }
+    
+    Command cmd;
+    if (!protocol_parse_command(p, &cmd)) {
+        send_text(conn, "[ERROR] Invalid command format\n");
+        conn->menu_pending = true;
+        return true;
+    }
+    cmd.request_id = request_id;
+    
+    // EXIT 명령 처리
+    if (cmd.type == CMD_EXIT) {
+        send_text(conn, "Disconnecting...\n");
+        printf("[Comm] Conn %u requested exit\n", conn->conn_id);
+        return false;
+    }
+    
+    if (!has_id) {
+        cmd.request_id = conn->next_request_id++;
+    }
+    cmd.conn_id = conn->conn_id;
+    
+    // "4 <곡 이름>": 이름으로 곡 선택
+    if (cmd.type == CMD_BUZZER_ON && cmd.param1 == 0) {
+        const char* rest = p;
+        char name[MUSIC_NAME_SIZE];
+        int type;
+        
+        protocol_parse_int(&rest, &type);
+        if (protocol_parse_name(&rest, name, sizeof(name))) {
+            if (resolve_music_name(conn, &cmd, name)) {
+                submit_command(state, conn, &cmd);
+            }
+            return true;
+        }
+    }
+    
+    // 추가 파라미터가 필요하면 프롬프트를 보내고 다음 줄을 기다린다
+    if (cmd.param1 == 0) {
+        const char* prompt = NULL;
+        char countdown_prompt[64];
+        
+        if (cmd.type == CMD_SET_BRIGHTNESS) {
+            conn->state = CONN_STATE_AWAIT_BRIGHTNESS;
+            prompt = "Enter brightness level (1-3): ";
+        } else if (cmd.type == CMD_BUZZER_ON) {
+            conn->state = CONN_STATE_AWAIT_MUSIC;
+            prompt = "Enter music number or name (13: list): ";
+        } else if (cmd.type == CMD_SEGMENT_DISPLAY) {
+            conn->state = CONN_STATE_AWAIT_COUNTDOWN;
+            snprintf(countdown_prompt, sizeof(countdown_prompt),
+                     "Enter countdown seconds (1-%d): ", seg7_max_count());
+            prompt = countdown_prompt;
+        }
+        
+        if (prompt) {
+            conn->pending_cmd = cmd;
+            send_text(conn, prompt);
+            return true;
+        }
+    }
+    
+    submit_command(state, conn, &cmd);
+    return true;
+}
+
+// 텍스트 모드 시작: 환영 메시지와 메뉴 전송
+static void start_text_mode(ServerState* state, Connection* conn) {
+    conn->mode = CONN_MODE_TEXT;
+    state->negotiating_count--;
     
     // 환영 메시지 + 웹 서버 URL (버퍼 크기 증가)
     char welcome_msg[2048];  // 1024 -> 2048로 증가
@@ -80,129 +459,306 @@ void* communication_thread(void* arg) {
         "\n",
         url);
     
-    send(client_socket, welcome_msg, strlen(welcome_msg), 0);
+    send_text(conn, welcome_msg);
+    send_menu(conn);
+    conn->menu_pending = false;
+}
+
+// 바이너리 모드 시작: 배너/메뉴 없이 버전만 담은 응답 프레임으로 확인
+static void start_binary_mode(ServerState* state, Connection* conn) {
+    conn->mode = CONN_MODE_BINARY;
+    state->negotiating_count--;
     
-    char buffer[BUFFER_SIZE];
+    CommandResponse ack = {0};
+    ack.status = STATUS_OK;
+    ack.value = BINARY_VERSION;
+    send_response(conn, &ack);
     
-    while (state->server_running) {
-        send_menu(client_socket);
-        
-        memset(buffer, 0, sizeof(buffer));
-        ssize_t received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-        
-        if (received <= 0) {
-            if (received == 0) {
-                printf("[Comm Thread] Client disconnected\n");
-            } else {
-                printf("[Comm Thread] Receive error: %s\n", strerror(errno));
-            }
-            break;
-        }
-        
-        buffer[received] = '\0';
-        
-        // 개행 문자 제거
-        char* newline = strchr(buffer, '\n');
-        if (newline) *newline = '\0';
-        newline = strchr(buffer, '\r');
-        if (newline) *newline = '\0';
-        
-        printf("[Comm Thread] Received: %s\n", buffer);
-        
-        Command cmd;
-        if (!parse_command(buffer, &cmd)) {
-            const char* error_msg = "[ERROR] Invalid command format\n";
-            send(client_socket, error_msg, strlen(error_msg), 0);
-            continue;
-        }
+    printf("[Comm] Conn %u switched to binary mode\n", conn->conn_id);
+}
+
+static void send_line_too_long(Connection* conn) {
+    send_text(conn, "[ERROR] Line too long\n");
+    conn->menu_pending = true;
+}
+
+// 완성된 줄을 제자리에서 처리 (개행을 NUL로 바꿔 handle_line에 넘긴다)
+// 처리한 바이트 수를 consumed에 기록. 연결을 끊어야 하면 false 반환
+static bool process_lines(ServerState* state, Connection* conn, char* data, size_t len,
+                          size_t* consumed) {
+    char* start = data;
+    char* end = data + len;
+    char* newline;
+    
+    while ((newline = memchr(start, '\n', (size_t)(end - start))) != NULL) {
+        *newline = '\0';
         
-        // EXIT 명령 처리
-        if (cmd.type == CMD_EXIT) {
-            const char* bye_msg = "Disconnecting...\n";
-            send(client_socket, bye_msg, strlen(bye_msg), 0);
-            printf("[Comm Thread] Client requested exit\n");
-            break;
+        if (conn->discarding) {
+            conn->discarding = false;
+        } else if (!handle_line(state, conn, start)) {
+            *consumed = (size_t)(newline + 1 - data);
+            return false;
         }
+        start = newline + 1;
+    }
+    
+    *consumed = (size_t)(start - data);
+    return true;
+}
+
+// 텍스트 입력: recv 경계와 줄 경계가 달라도 되도록 남은 조각은 in_buf에 보관한다
+static bool process_text(ServerState* state, Connection* conn, char* data, size_t len) {
+    // 이전 recv에서 남은 조각이 있으면 첫 줄만 이어 붙여 처리
+    if (conn->in_len > 0) {
+        char* newline = memchr(data, '\n', len);
+        size_t head = newline ? (size_t)(newline - data) + 1 : len;
         
-        // 추가 파라미터 요청 (brightness, music number, countdown seconds)
-        if (cmd.type == CMD_SET_BRIGHTNESS) {
-            if (cmd.param1 == 0) {
-                const char* prompt = "Enter brightness level (1-3): ";
-                send(client_socket, prompt, strlen(prompt), 0);
-                
-                memset(buffer, 0, sizeof(buffer));
-                received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-                if (received <= 0) break;
-                
-                cmd.param1 = atoi(buffer);
-            }
-        } else if (cmd.type == CMD_BUZZER_ON) {
-            if (cmd.param1 == 0) {
-                const char* prompt = "Enter music number (1:School Bell, 2:Twinkle Star, 3:Happy Birthday, 4:Butterfly): ";
-                send(client_socket, prompt, strlen(prompt), 0);
-                
-                memset(buffer, 0, sizeof(buffer));
-                received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-                if (received <= 0) break;
-                
-                cmd.param1 = atoi(buffer);
+        if (conn->in_len + head > INPUT_BUFFER_SIZE) {
+            send_line_too_long(conn);
+            conn->in_len = 0;
+            conn->discarding = (newline == NULL);
+        } else {
+            memcpy(conn->in_buf + conn->in_len, data, head);
+            conn->in_len += head;
+            
+            if (!newline) {
+                return true;
             }
-        } else if (cmd.type == CMD_SEGMENT_DISPLAY) {
-            if (cmd.param1 == 0) {
-                const char* prompt = "Enter countdown seconds (1-9): ";
-                send(client_socket, prompt, strlen(prompt), 0);
-                
-                memset(buffer, 0, sizeof(buffer));
-                received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-                if (received <= 0) break;
-                
-                cmd.param1 = atoi(buffer);
+            
+            conn->in_buf[conn->in_len - 1] = '\0';
+            conn->in_len = 0;
+            if (!handle_line(state, conn, conn->in_buf)) {
+                return false;
             }
         }
         
-        // Command Queue에 추가
-        pthread_mutex_lock(&state->queue_mutex);
-        
-        if (!queue_push(&state->cmd_queue, &cmd)) {
-            pthread_mutex_unlock(&state->queue_mutex);
-            const char* error_msg = "[ERROR] Command queue full\n";
-            send(client_socket, error_msg, strlen(error_msg), 0);
+        data += head;
+        len -= head;
+    }
+    
+    // 나머지 완성된 줄은 recv 버퍼에서 바로 처리 (복사 없음)
+    size_t consumed;
+    if (!process_lines(state, conn, data, len, &consumed)) {
+        return false;
+    }
+    
+    // 끝에 남은 미완성 줄 보관
+    size_t rest = len - consumed;
+    if (rest > 0 && !conn->discarding) {
+        if (rest >= INPUT_BUFFER_SIZE) {
+            send_line_too_long(conn);
+            conn->discarding = true;
+        } else {
+            memcpy(conn->in_buf, data + consumed, rest);
+            conn->in_len = rest;
+        }
+    }
+    
+    return true;
+}
+
+static bool handle_frame(ServerState* state, Connection* conn, const uint8_t* frame) {
+    Command cmd;
+    protocol_decode_command(frame, &cmd);
+    
+    // 이벤트 프레임 표시와 같은 ID로 답하면 클라이언트가 응답을 이벤트 프레임으로 읽으므로 실행하지 않는다
+    if (cmd.request_id == BINARY_EVENT_ID) {
+        send_error(conn, 0, STATUS_INVALID, "Reserved request id");
+        return true;
+    }
+    
+    if (cmd.type == CMD_EXIT) {
+        printf("[Comm] Conn %u requested exit\n", conn->conn_id);
+        return false;
+    }
+    
+    cmd.conn_id = conn->conn_id;
+    submit_command(state, conn, &cmd);
+    return true;
+}
+
+// 고정 크기 명령 프레임 처리 (프레임이 recv 경계에 걸치면 in_buf에 모은다)
+static bool process_binary(ServerState* state, Connection* conn, const char* data, size_t len) {
+    while (len > 0) {
+        if (conn->in_len == 0 && len >= BINARY_COMMAND_FRAME_SIZE) {
+            if (!handle_frame(state, conn, (const uint8_t*)data)) {
+                return false;
+            }
+            data += BINARY_COMMAND_FRAME_SIZE;
+            len -= BINARY_COMMAND_FRAME_SIZE;
             continue;
         }
         
-        // Device Thread 깨우기
-        pthread_cond_signal(&state->queue_not_empty);
-        
-        // 응답 대기
-        struct timespec ts;
-        clock_gettime(CLOCK_REALTIME, &ts);
-        ts.tv_sec += 5; // 5초 timeout
-        
-        int wait_result = pthread_cond_timedwait(&state->response_ready, 
-                                                  &state->queue_mutex, &ts);
+        size_t take = BINARY_COMMAND_FRAME_SIZE - conn->in_len;
+        if (take > len) {
+            take = len;
+        }
+        memcpy(conn->in_buf + conn->in_len, data, take);
+        conn->in_len += take;
+        data += take;
+        len -= take;
         
-        if (wait_result == 0) {
-            CommandResponse response = state->response;
-            pthread_mutex_unlock(&state->queue_mutex);
-            
-            if (!send_response(client_socket, &response)) {
-                printf("[Comm Thread] Failed to send response\n");
-                break;
+        if (conn->in_len == BINARY_COMMAND_FRAME_SIZE) {
+            conn->in_len = 0;
+            if (!handle_frame(state, conn, (const uint8_t*)conn->in_buf)) {
+                return false;
             }
+        }
+    }
+    
+    return true;
+}
+
+void conn_open(ServerState* state, Connection* conn) {
+    conn->state = CONN_STATE_COMMAND;
+    conn->next_request_id = 1;
+    conn->inflight_count = 0;
+    conn->in_len = 0;
+    conn->discarding = false;
+    conn->event_mask = 0;
+    conn->events_held = 0;
+    memset(conn->inflight, 0, sizeof(conn->inflight));
+    
+    // 첫 데이터가 BINARY_MAGIC이면 바이너리 모드, 그 외의 데이터가 오거나
+    // HANDSHAKE_WINDOW_MS 동안 아무것도 오지 않으면 텍스트 모드
+    conn->mode = CONN_MODE_NEGOTIATE;
+    conn->negotiate_deadline_ms = monotonic_ms() + HANDSHAKE_WINDOW_MS;
+    state->negotiating_count++;
+}
+
+bool conn_process_input(ServerState* state, Connection* conn, char* data, size_t len) {
+    if (conn->mode == CONN_MODE_BINARY) {
+        return process_binary(state, conn, data, len);
+    }
+    
+    if (conn->mode == CONN_MODE_TEXT) {
+        return process_text(state, conn, data, len);
+    }
+    
+    // 핸드셰이크: 지금까지 받은 바이트가 BINARY_MAGIC의 앞부분과 일치하는지 확인
+    size_t matched = conn->in_len;
+    size_t i = 0;
+    while (i < len && matched < BINARY_MAGIC_LEN && data[i] == BINARY_MAGIC[matched]) {
+        i++;
+        matched++;
+    }
+    
+    if (matched == BINARY_MAGIC_LEN) {
+        conn->in_len = 0;
+        start_binary_mode(state, conn);
+        return process_binary(state, conn, data + i, len - i);
+    }
+    
+    if (i == len) {
+        // 아직 magic의 앞부분만 도착
+        memcpy(conn->in_buf + conn->in_len, data, len);
+        conn->in_len += len;
+        return true;
+    }
+    
+    // 텍스트 클라이언트: in_buf에 보류한 앞부분은 미완성 줄로 이어서 처리된다
+    start_text_mode(state, conn);
+    return process_text(state, conn, data, len);
+}
+
+// 핸드셰이크 시간이 지나면 텍스트 모드로 시작
+void conn_check_negotiation(ServerState* state, Connection* conn, long long now_ms) {
+    if (conn->mode != CONN_MODE_NEGOTIATE || now_ms < conn->negotiate_deadline_ms) {
+        return;
+    }
+    start_text_mode(state, conn);
+}
+
+void conn_closed(ServerState* state, Connection* conn) {
+    if (conn->mode == CONN_MODE_NEGOTIATE) {
+        state->negotiating_count--;
+    }
+    if (conn->event_mask != 0) {
+        state->subscriber_count--;
+        conn->event_mask = 0;
+    }
+}
+
+// 구독 중인 디바이스의 이벤트 전달
+// 출력이 밀린 연결은 디바이스별로 최신 이벤트 하나만 보관했다가 출력이 빠지면 보낸다.
+// (상태 변화 이벤트이므로 최신 상태만 알면 되고, 합쳐진 개수는 coalesced로 알려 준다)
+void conn_deliver_event(Connection* conn, const DeviceEvent* event) {
+    EventDevice device = event_device(event->type);
+    unsigned int bit = 1u << device;
+    
+    if (!(conn->event_mask & bit)) {
+        return;
+    }
+    
+    if ((conn->events_held & bit) || conn_backlogged(conn)) {
+        if (conn->events_held & bit) {
+            conn->events_coalesced[device]++;
         } else {
-            pthread_mutex_unlock(&state->queue_mutex);
-            const char* timeout_msg = "[ERROR] Command timeout\n";
-            send(client_socket, timeout_msg, strlen(timeout_msg), 0);
+            conn->events_coalesced[device] = 0;
         }
+        conn->held_events[device] = *event;
+        conn->events_held |= bit;
+        return;
     }
     
-    // 연결 종료 처리
-    pthread_mutex_lock(&state->state_mutex);
-    state->client_connected = false;
-    close(client_socket);
-    state->client_socket = -1;
-    pthread_mutex_unlock(&state->state_mutex);
+    send_event(conn, event, 0);
+}
+
+// 보관 중인 이벤트 전송 (출력이 아직 밀려 있으면 다음 기회로)
+void conn_flush_events(Connection* conn) {
+    if (conn->events_held == 0 || conn_backlogged(conn)) {
+        return;
+    }
     
-    printf("[Comm Thread] Stopped\n");
-    return NULL;
+    for (int i = 0; i < EVENT_DEVICE_COUNT; i++) {
+        if (conn->events_held & (1u << i)) {
+            send_event(conn, &conn->held_events[i], conn->events_coalesced[i]);
+        }
+    }
+    conn->events_held = 0;
+}
+
+// Device lane이 보낸 응답을 해당 요청의 완료 슬롯으로 전달
+void conn_deliver_response(Connection* conn, const CommandResponse* response) {
+    InflightSlot* slot = inflight_slot(conn, response->request_id);
+    
+    // 이미 timeout 처리된 요청의 늦은 응답은 버린다
+    if (!slot->in_use || slot->request_id != response->request_id) {
+        printf("[Comm] Conn %u dropped stale response #%u\n",
+               conn->conn_id, response->request_id);
+        return;
+    }
+    
+    slot->in_use = false;
+    conn->inflight_count--;
+    conn->menu_pending = true;
+    
+    send_response(conn, response);
+}
+
+// 응답 시간이 지난 요청 정리
+void conn_expire_inflight(Connection* conn, long long now_ms) {
+    if (conn->inflight_count == 0) {
+        return;
+    }
+    
+    for (int i = 0; i < MAX_INFLIGHT; i++) {
+        InflightSlot* slot = &conn->inflight[i];
+        if (slot->in_use && now_ms >= slot->deadline_ms) {
+            slot->in_use = false;
+            conn->inflight_count--;
+            conn->menu_pending = true;
+            send_error(conn, slot->request_id, STATUS_TIMEOUT, "Command timeout");
+        }
+    }
+}
+
+// 처리 중인 명령이 없고 프롬프트 대기 중이 아닐 때만 메뉴 전송
+void conn_flush_menu(Connection* conn) {
+    if (conn->mode == CONN_MODE_TEXT &&
+        conn->menu_pending && conn->inflight_count == 0 &&
+        conn->state == CONN_STATE_COMMAND) {
+        send_menu(conn);
+        conn->menu_pending = false;
+    }
 }
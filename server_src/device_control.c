@@ -5,89 +5,161 @@
 #include <time.h>
 #include "server.h"
 
-// 카운트다운 완료 콜백
 static ServerState* g_state = NULL;
 
+static const char* LANE_NAMES[LANE_COUNT] = {
+    [LANE_LED] = "LED",
+    [LANE_BUZZER] = "Buzzer",
+    [LANE_SEGMENT] = "Segment",
+    [LANE_SENSOR] = "Sensor",
+    [LANE_BATCH] = "Batch"
+};
+
+// 다른 lane으로 내부 명령 전달 (응답 없음)
+static void submit_internal(ServerState* state, CommandType type, int param1) {
+    Command cmd = {0};
+    cmd.type = type;
+    cmd.param1 = param1;
+    cmd.conn_id = INTERNAL_CONN_ID;
+    
+    if (!device_submit(state, &cmd)) {
+        printf("[Device] Internal command %d dropped - queue full\n", type);
+    }
+}
+
+// 상태 변화 이벤트 발행 (Event Queue가 가득 차면 버린다 - 호출한 스레드는 기다리지 않음)
+static void emit_event(ServerState* state, EventType type, int value) {
+    DeviceEvent event;
+    event.type = type;
+    event.value = value;
+    event.timestamp_ms = realtime_ms();
+    
+    event_queue_push(&state->event_queue, &event);
+}
+
+// 카운트다운 완료 콜백
 void countdown_complete_callback(void) {
     if (g_state) {
-        pthread_mutex_lock(&g_state->state_mutex);
-        g_state->segment_counting = false;
+        device_state_begin_write(&g_state->device)->segment_counting = false;
+        device_state_end_write(&g_state->device);
         printf("[Device] Countdown completed - Playing school bell music\n");
-        pthread_mutex_unlock(&g_state->state_mutex);
+        
+        emit_event(g_state, EVENT_COUNTDOWN_FINISHED, 0);
+        
+        // 음악 재생은 Buzzer lane에서 처리
+        submit_internal(g_state, CMD_BUZZER_ON, MUSIC_SCHOOL_BELL);
+    }
+}
 
-        // 비동기 재생
-        play_music_async(MUSIC_SCHOOL_BELL);
+// 음악 재생 종료 콜백 (스케줄러 스레드에서 호출)
+static void music_finish_callback(int music_number, int completed) {
+    if (g_state) {
+        device_state_begin_write(&g_state->device)->buzzer_playing = false;
+        device_state_end_write(&g_state->device);
+        
+        emit_event(g_state, completed ? EVENT_MUSIC_FINISHED : EVENT_MUSIC_STOPPED, music_number);
+    }
+}
+
+// LED 명령의 응답 메시지 (실제 실행과 coalescing으로 생략된 명령이 함께 사용)
+static void led_response(const Command* cmd, bool ok, CommandResponse* response) {
+    response->status = ok ? 0 : -1;
+    
+    switch (cmd->type) {
+        case CMD_LED_ON:
+            strcpy(response->message, ok ? "LED turned ON" : "Failed to turn ON LED");
+            break;
+        case CMD_LED_OFF:
+            strcpy(response->message, ok ? "LED turned OFF" : "Failed to turn OFF LED");
+            break;
+        default:
+            if (ok) {
+                sprintf(response->message, "Brightness set to %d", cmd->param1);
+            } else {
+                strcpy(response->message, "Failed to set brightness");
+            }
+            break;
     }
 }
 
-static void process_led_on(ServerState* state, CommandResponse* response) {
-    if (led_on() == 0) {
-        pthread_mutex_lock(&state->state_mutex);
-        state->led_on = true;
-        pthread_mutex_unlock(&state->state_mutex);
+static bool led_command_valid(const Command* cmd) {
+    if (cmd->type == CMD_SET_BRIGHTNESS) {
+        return cmd->param1 >= LED_BRIGHTNESS_LOW && cmd->param1 <= LED_BRIGHTNESS_HIGH;
+    }
+    return true;
+}
+
+static void process_led_on(ServerState* state, Command* cmd, CommandResponse* response) {
+    bool ok = (led_on() == 0);
+    
+    if (ok) {
+        DeviceStatus* dev = device_state_begin_write(&state->device);
+        dev->led_on = true;
+        int brightness = dev->led_brightness;
+        device_state_end_write(&state->device);
         
-        response->status = 0;
-        strcpy(response->message, "LED turned ON");
-    } else {
-        response->status = -1;
-        strcpy(response->message, "Failed to turn ON LED");
+        emit_event(state, EVENT_LED_ON, brightness);
     }
+    led_response(cmd, ok, response);
 }
 
-static void process_led_off(ServerState* state, CommandResponse* response) {
-    if (led_off() == 0) {
-        pthread_mutex_lock(&state->state_mutex);
-        state->led_on = false;
-        pthread_mutex_unlock(&state->state_mutex);
+static void process_led_off(ServerState* state, Command* cmd, CommandResponse* response) {
+    bool ok = (led_off() == 0);
+    
+    if (ok) {
+        device_state_begin_write(&state->device)->led_on = false;
+        device_state_end_write(&state->device);
         
-        response->status = 0;
-        strcpy(response->message, "LED turned OFF");
-    } else {
-        response->status = -1;
-        strcpy(response->message, "Failed to turn OFF LED");
+        emit_event(state, EVENT_LED_OFF, 0);
     }
+    led_response(cmd, ok, response);
 }
 
 static void process_set_brightness(ServerState* state, Command* cmd, CommandResponse* response) {
-    if (cmd->param1 < LED_BRIGHTNESS_LOW || cmd->param1 > LED_BRIGHTNESS_HIGH) {
+    if (!led_command_valid(cmd)) {
         response->status = -1;
         sprintf(response->message, "Invalid brightness level: %d (use 1-3)", cmd->param1);
         return;
     }
     
-    if (led_set_brightness(cmd->param1) == 0) {
-        pthread_mutex_lock(&state->state_mutex);
-        state->led_brightness = cmd->param1;
-        pthread_mutex_unlock(&state->state_mutex);
+    bool ok = (led_set_brightness(cmd->param1) == 0);
+    
+    if (ok) {
+        device_state_begin_write(&state->device)->led_brightness = cmd->param1;
+        device_state_end_write(&state->device);
         
-        response->status = 0;
-        sprintf(response->message, "Brightness set to %d", cmd->param1);
-    } else {
-        response->status = -1;
-        strcpy(response->message, "Failed to set brightness");
+        emit_event(state, EVENT_LED_BRIGHTNESS, cmd->param1);
     }
+    led_response(cmd, ok, response);
 }
 
 static void process_buzzer_on(ServerState* state, Command* cmd, CommandResponse* response) {
     int music_num = cmd->param1;
-    if (music_num < MUSIC_SCHOOL_BELL || music_num > MUSIC_BUTTERFLY) {
-        music_num = MUSIC_SCHOOL_BELL;
+    MusicInfo info;
+    
+    if (music_get_info(music_num, &info) != 0) {
+        response->status = -1;
+        sprintf(response->message, "Unknown music %d (see 13 for the list)", music_num);
+        return;
     }
-
+    
     if (is_music_playing()) {
         response->status = -1;
         strcpy(response->message, "Music already playing");
         return;
     }
-
+    
     if (play_music_async(music_num) == 0) {
-        pthread_mutex_lock(&state->state_mutex);
-        state->buzzer_playing = true;
-        pthread_mutex_unlock(&state->state_mutex);
-
+        DeviceStatus* dev = device_state_begin_write(&state->device);
+        dev->buzzer_playing = true;
+        dev->music_number = music_num;
+        device_state_end_write(&state->device);
+        
         response->status = 0;
-        sprintf(response->message, "Playing music %d", music_num);
-        printf("[Device] Music %d started\n", music_num);
+        snprintf(response->message, sizeof(response->message), "Playing music %d (%s)",
+                 music_num, info.name);
+        printf("[Device] Music %d (%s) started\n", music_num, info.name);
+        emit_event(state, EVENT_MUSIC_STARTED, music_num);
     } else {
         response->status = -1;
         strcpy(response->message, "Failed to start music");
@@ -100,12 +172,11 @@ static void process_buzzer_off(ServerState* state, CommandResponse* response) {
         strcpy(response->message, "No music playing");
         return;
     }
-
+    
     if (stop_music() == 0) {
-        pthread_mutex_lock(&state->state_mutex);
-        state->buzzer_playing = false;
-        pthread_mutex_unlock(&state->state_mutex);
-
+        device_state_begin_write(&state->device)->buzzer_playing = false;
+        device_state_end_write(&state->device);
+        
         response->status = 0;
         strcpy(response->message, "Music stopped");
         printf("[Device] Music stopped\n");
@@ -115,52 +186,161 @@ static void process_buzzer_off(ServerState* state, CommandResponse* response) {
     }
 }
 
+// 밝기 변화 처리: 측정값 갱신과 이벤트, 감시 중이면 LED 자동 제어 (LED 제어는 LED lane에 맡긴다)
+// force: 값이 그대로여도 LED 자동 제어를 적용 (감시를 시작할 때)
+static void handle_light_level(ServerState* state, bool is_bright, bool force) {
+    DeviceStatus current;
+    device_state_read(&state->device, &current);
+    
+    bool changed = (current.sensor_value != (int)is_bright);
+    if (!changed && !force) {
+        return;
+    }
+    
+    if (changed) {
+        device_state_begin_write(&state->device)->sensor_value = (int)is_bright;
+        device_state_end_write(&state->device);
+        emit_event(state, is_bright ? EVENT_LIGHT_DETECTED : EVENT_DARK_DETECTED, 0);
+    }
+    
+    if (!current.sensor_monitoring) {
+        return;
+    }
+    
+    if (is_bright) {
+        // 밝으면 LED OFF
+        if (current.led_on) {
+            submit_internal(state, CMD_LED_OFF, 0);
+            printf("[Device] Light detected - LED OFF\n");
+        }
+    } else {
+        // 어두우면 LED ON
+        if (!current.led_on) {
+            submit_internal(state, CMD_LED_ON, 0);
+            printf("[Device] Dark detected - LED ON\n");
+        }
+    }
+}
+
+// 현재 밝기 (샘플러가 돌면 필터를 거친 상태)
+static bool current_light_level(ServerState* state) {
+    return state->sensor_sampling ? light_sampler_is_bright() : light_sensor_is_bright();
+}
+
+// 밝기 변화 콜백 (샘플러 스레드 또는 조도 센서 이벤트 스레드에서 호출)
+static void light_change_callback(bool is_bright) {
+    if (g_state) {
+        handle_light_level(g_state, is_bright, false);
+    }
+}
+
+// 샘플러의 샘플마다 시계열 저장소에 추가 (샘플러 스레드에서 호출)
+static void history_sample_callback(const LightSample* sample) {
+    if (g_state) {
+        sensor_history_append(&g_state->history, realtime_ms(), sample->raw, sample->filtered);
+    }
+}
+
+// 감시하는 동안만 샘플러를 돌린다 (Sensor lane에서만 호출). 샘플러가 도는 동안에는 필터를 거친
+// 상태만 반영하도록 에지 알림을 끄고, 샘플러를 시작하지 못하면 에지 알림을 그대로 쓴다.
+static void start_light_sampler(ServerState* state) {
+    if (!state->sensor_sampler || state->sensor_sampling) {
+        return;
+    }
+    
+    LightSamplerConfig config;
+    light_sampler_default_config(&config);
+    config.rate_hz = state->sensor_rate_hz;
+    
+    if (state->sensor_interrupts) {
+        light_sensor_set_callback(NULL);
+    }
+    state->sensor_sampling = (light_sampler_start(&config, light_change_callback) == 0);
+    if (!state->sensor_sampling && state->sensor_interrupts) {
+        light_sensor_set_callback(light_change_callback);
+    }
+}
+
+static void stop_light_sampler(ServerState* state) {
+    if (!state->sensor_sampling) {
+        return;
+    }
+    
+    LightSamplerStats stats;
+    light_sampler_stop();
+    light_sampler_get_stats(&stats);
+    state->sensor_sampling = false;
+    printf("[Device] Light sampler: samples %lu, raw transitions %lu, "
+           "filtered transitions %lu, duty cycle %.1f%%\n",
+           stats.samples, stats.raw_transitions, stats.transitions,
+           stats.duty_cycle * 100.0);
+    
+    if (state->sensor_interrupts) {
+        light_sensor_set_callback(light_change_callback);
+    }
+}
+
 static void process_sensor_on(ServerState* state, CommandResponse* response) {
-    pthread_mutex_lock(&state->state_mutex);
-    state->sensor_monitoring = true;
-    pthread_mutex_unlock(&state->state_mutex);
+    start_light_sampler(state);
+    
+    device_state_begin_write(&state->device)->sensor_monitoring = true;
+    device_state_end_write(&state->device);
     
     response->status = 0;
     strcpy(response->message, "Sensor monitoring started");
     printf("[Device] Sensor monitoring started\n");
+    emit_event(state, EVENT_SENSOR_MONITOR_ON, 0);
+    
+    // 이후에는 에지가 생길 때만 알림이 오므로 현재 밝기를 한 번 적용
+    handle_light_level(state, current_light_level(state), true);
 }
 
 static void process_sensor_off(ServerState* state, CommandResponse* response) {
-    pthread_mutex_lock(&state->state_mutex);
-    state->sensor_monitoring = false;
-    pthread_mutex_unlock(&state->state_mutex);
+    device_state_begin_write(&state->device)->sensor_monitoring = false;
+    device_state_end_write(&state->device);
     
     response->status = 0;
     strcpy(response->message, "Sensor monitoring stopped");
     printf("[Device] Sensor monitoring stopped\n");
+    emit_event(state, EVENT_SENSOR_MONITOR_OFF, 0);
+    
+    // 샘플러를 멈춘 뒤에는 원시 값을 따라가므로 측정값을 한 번 맞춘다
+    if (state->sensor_sampling) {
+        stop_light_sampler(state);
+        handle_light_level(state, light_sensor_is_bright(), false);
+    }
 }
 
 static void process_segment_display(ServerState* state, Command* cmd, CommandResponse* response) {
-    // 1-9 범위 체크
-    if (cmd->param1 < 1 || cmd->param1 > 9) {
+    // 디스플레이 자리 수로 표시할 수 있는 범위 체크
+    int max_seconds = seg7_max_count();
+    if (cmd->param1 < 1 || cmd->param1 > max_seconds) {
         response->status = -1;
-        sprintf(response->message, "Invalid countdown seconds: %d (use 1-9)", cmd->param1);
+        sprintf(response->message, "Invalid countdown seconds: %d (use 1-%d)", cmd->param1, max_seconds);
         return;
     }
     
-    pthread_mutex_lock(&state->state_mutex);
-    if (state->segment_counting) {
-        pthread_mutex_unlock(&state->state_mutex);
+    // 확인과 설정을 한 쓰기 구간에서 (writer끼리는 직렬화됨)
+    DeviceStatus* dev = device_state_begin_write(&state->device);
+    if (dev->segment_counting) {
+        device_state_end_write(&state->device);
         response->status = -1;
         strcpy(response->message, "Countdown already in progress");
         return;
     }
-    state->segment_counting = true;
-    pthread_mutex_unlock(&state->state_mutex);
+    dev->segment_counting = true;
+    dev->countdown_start = cmd->param1;
+    dev->countdown_started_ms = monotonic_ms();
+    device_state_end_write(&state->device);
     
     if (seg7_counting(cmd->param1, countdown_complete_callback) == 0) {
         response->status = 0;
         sprintf(response->message, "Countdown started from %d (will play music at 0)", cmd->param1);
         printf("[Device] Countdown started: %d seconds\n", cmd->param1);
+        emit_event(state, EVENT_COUNTDOWN_STARTED, cmd->param1);
     } else {
-        pthread_mutex_lock(&state->state_mutex);
-        state->segment_counting = false;
-        pthread_mutex_unlock(&state->state_mutex);
+        device_state_begin_write(&state->device)->segment_counting = false;
+        device_state_end_write(&state->device);
         
         response->status = -1;
         strcpy(response->message, "Failed to start countdown");
@@ -168,170 +348,463 @@ static void process_segment_display(ServerState* state, Command* cmd, CommandRes
 }
 
 static void process_segment_stop(ServerState* state, CommandResponse* response) {
-    pthread_mutex_lock(&state->state_mutex);
-    bool was_counting = state->segment_counting;
-    pthread_mutex_unlock(&state->state_mutex);
+    DeviceStatus current;
+    device_state_read(&state->device, &current);
     
-    if (!was_counting) {
+    if (!current.segment_counting) {
         response->status = -1;
         strcpy(response->message, "No countdown in progress");
         return;
     }
     
     if (seg7_stop_counting() == 0) {
-        pthread_mutex_lock(&state->state_mutex);
-        state->segment_counting = false;
-        pthread_mutex_unlock(&state->state_mutex);
+        device_state_begin_write(&state->device)->segment_counting = false;
+        device_state_end_write(&state->device);
         
         response->status = 0;
         strcpy(response->message, "Countdown stopped");
         printf("[Device] Countdown stopped\n");
+        emit_event(state, EVENT_COUNTDOWN_STOPPED, 0);
     } else {
         response->status = -1;
         strcpy(response->message, "Failed to stop countdown");
     }
 }
 
-static void handle_sensor_monitoring(ServerState* state) {
-    static bool last_bright_state = false;
-    bool is_bright = light_sensor_is_bright();
+// 센서 인터럽트를 쓸 수 없을 때만 Sensor lane이 주기적으로 호출
+static void poll_sensor(ServerState* state) {
+    DeviceStatus current;
+    device_state_read(&state->device, &current);
+    
+    if (current.sensor_monitoring && !state->sensor_sampling) {
+        handle_light_level(state, current_light_level(state), false);
+    }
+}
+
+// 명령 하나를 디바이스에서 실행하고 응답을 채운다 (호출자가 lane의 exec_mutex를 잡고 부름)
+void device_execute(ServerState* state, Command* cmd, CommandResponse* response) {
+    switch (cmd->type) {
+        case CMD_LED_ON:
+            process_led_on(state, cmd, response);
+            break;
+            
+        case CMD_LED_OFF:
+            process_led_off(state, cmd, response);
+            break;
+            
+        case CMD_SET_BRIGHTNESS:
+            process_set_brightness(state, cmd, response);
+            break;
+            
+        case CMD_BUZZER_ON:
+            process_buzzer_on(state, cmd, response);
+            break;
+            
+        case CMD_BUZZER_OFF:
+            process_buzzer_off(state, response);
+            break;
+            
+        case CMD_SENSOR_ON:
+            process_sensor_on(state, response);
+            break;
+            
+        case CMD_SENSOR_OFF:
+            process_sensor_off(state, response);
+            break;
+            
+        case CMD_SEGMENT_DISPLAY:
+            process_segment_display(state, cmd, response);
+            break;
+            
+        case CMD_SEGMENT_STOP:
+            process_segment_stop(state, response);
+            break;
+            
+        default:
+            response->status = -1;
+            strcpy(response->message, "Unknown command");
+            break;
+    }
+}
+
+// 요청 ID를 붙여 Response Queue로 보내면 reactor가 해당 요청에 연결한다
+static void post_response(ServerState* state, const Command* cmd, CommandResponse* response) {
+    if (cmd->conn_id == INTERNAL_CONN_ID) {
+        return;
+    }
+    response->request_id = cmd->request_id;
+    response->conn_id = cmd->conn_id;
+    response_queue_post(&state->resp_queue, response, &state->server_running);
+}
+
+// LED 하드웨어 쓰기만 한다 (상태 저장소와 이벤트는 호출자가 처리)
+static bool led_write(const Command* cmd) {
+    switch (cmd->type) {
+        case CMD_LED_ON:
+            return led_on() == 0;
+        case CMD_LED_OFF:
+            return led_off() == 0;
+        default:
+            return led_set_brightness(cmd->param1) == 0;
+    }
+}
+
+// LED lane에 연속으로 쌓인 명령을 최종 상태 하나로 합친다.
+// LED 명령은 모두 PWM 값을 통째로 덮어쓰므로 마지막 유효 명령만 하드웨어에 쓰고,
+// 상태 저장소에는 유효 명령을 순서대로 적용한 결과(켜짐 여부, 밝기)를 한 번에 쓴다.
+// 요청자마다 마지막 쓰기 결과를 기준으로 각자의 응답을 보낸다.
+static void run_led_coalesced(ServerState* state, DeviceLane* lane, const Command* first) {
+    Command run[LED_COALESCE_MAX];
+    int count = 0;
     
-    if (is_bright != last_bright_state) {
-        pthread_mutex_lock(&state->state_mutex);
+    run[count++] = *first;
+    while (count < LED_COALESCE_MAX && queue_pop(&lane->queue, &run[count])) {
+        count++;
+    }
+    
+    // 잘못된 밝기 값은 하드웨어를 건드리지 않으므로 최종 상태에서 제외
+    int valid = 0;
+    int last = -1;
+    for (int i = 0; i < count; i++) {
+        if (led_command_valid(&run[i])) {
+            valid++;
+            last = i;
+        }
+    }
+    
+    // 합칠 명령이 없으면 하나씩 실행한 것과 같다
+    if (valid <= 1) {
+        for (int i = 0; i < count; i++) {
+            CommandResponse response = {0};
+            device_execute(state, &run[i], &response);
+            post_response(state, &run[i], &response);
+        }
+        atomic_fetch_add_explicit(&state->led_commands, (unsigned long)count, memory_order_relaxed);
+        return;
+    }
+    
+    bool ok = led_write(&run[last]);
+    
+    if (ok) {
+        DeviceStatus* dev = device_state_begin_write(&state->device);
+        bool was_on = dev->led_on;
+        int was_brightness = dev->led_brightness;
         
-        if (is_bright) {
-            // 밝으면 LED OFF
-            if (state->led_on) {
-                led_off();
-                state->led_on = false;
-                printf("[Device] Light detected - LED OFF\n");
+        for (int i = 0; i < count; i++) {
+            if (!led_command_valid(&run[i])) {
+                continue;
             }
-        } else {
-            // 어두우면 LED ON
-            if (!state->led_on) {
-                led_on();
-                state->led_on = true;
-                printf("[Device] Dark detected - LED ON\n");
+            if (run[i].type == CMD_LED_ON) {
+                dev->led_on = true;
+            } else if (run[i].type == CMD_LED_OFF) {
+                dev->led_on = false;
+            } else {
+                dev->led_brightness = run[i].param1;
             }
         }
+        bool now_on = dev->led_on;
+        int brightness = dev->led_brightness;
+        device_state_end_write(&state->device);
+        
+        // 바뀐 값마다 이벤트 하나. 출력이 밀린 구독 연결은 디바이스별 마지막 이벤트만 받으므로
+        // 밝기를 먼저, 켜짐 / 꺼짐(켜짐은 밝기 포함)을 나중에 낸다
+        if (brightness != was_brightness) {
+            emit_event(state, EVENT_LED_BRIGHTNESS, brightness);
+        }
+        if (now_on != was_on) {
+            emit_event(state, now_on ? EVENT_LED_ON : EVENT_LED_OFF, now_on ? brightness : 0);
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        CommandResponse response = {0};
         
-        pthread_mutex_unlock(&state->state_mutex);
-        last_bright_state = is_bright;
+        if (led_command_valid(&run[i])) {
+            led_response(&run[i], ok, &response);
+        } else {
+            device_execute(state, &run[i], &response);
+        }
+        post_response(state, &run[i], &response);
     }
+    
+    atomic_fetch_add_explicit(&state->led_commands, (unsigned long)count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&state->led_writes_elided, (unsigned long)(valid - 1), memory_order_relaxed);
 }
 
-void* device_control_thread(void* arg) {
-    ServerState* state = (ServerState*)arg;
-    g_state = state;
+// batch 실행: 사용하는 디바이스 lane을 인덱스 순서대로 잠가 다른 명령과 섞이지 않게 한다
+static void run_batch(ServerState* state, const Command* cmd) {
+    CommandBatch* batch = &state->batches[cmd->param1];
+    bool uses_lane[LANE_BATCH] = {false};
     
-    printf("[Device Thread] Started\n");
+    for (int i = 0; i < batch->count; i++) {
+        uses_lane[command_lane(batch->commands[i].type)] = true;
+    }
+    
+    for (int i = 0; i < LANE_BATCH; i++) {
+        if (uses_lane[i]) {
+            pthread_mutex_lock(&state->lanes[i].exec_mutex);
+        }
+    }
+    
+    CommandResponse results[MAX_BATCH_COMMANDS];
+    int succeeded = 0;
+    
+    for (int i = 0; i < batch->count; i++) {
+        memset(&results[i], 0, sizeof(CommandResponse));
+        device_execute(state, &batch->commands[i], &results[i]);
+        if (results[i].status == 0) {
+            succeeded++;
+        }
+    }
+    
+    for (int i = LANE_BATCH - 1; i >= 0; i--) {
+        if (uses_lane[i]) {
+            pthread_mutex_unlock(&state->lanes[i].exec_mutex);
+        }
+    }
+    
+    // 응답 하나로 합치기: "batch 2/3 ok: LED turned ON; ...; Invalid ..."
+    CommandResponse response = {0};
+    response.status = (succeeded == batch->count) ? 0 : -1;
+    response.value = succeeded;
+    
+    size_t len = (size_t)snprintf(response.message, sizeof(response.message),
+                                  "batch %d/%d ok:", succeeded, batch->count);
+    for (int i = 0; i < batch->count && len < sizeof(response.message); i++) {
+        len += (size_t)snprintf(response.message + len, sizeof(response.message) - len,
+                                "%s %s", i == 0 ? "" : ";", results[i].message);
+    }
+    
+    atomic_store_explicit(&batch->in_use, false, memory_order_release);
+    post_response(state, cmd, &response);
+}
+
+static void* lane_thread(void* arg) {
+    DeviceLane* lane = (DeviceLane*)arg;
+    ServerState* state = lane->state;
+    // 명령이 없으면 깨어나지 않는다 (센서 인터럽트가 없을 때만 Sensor lane이 폴링, 샘플러가 돌면 건너뜀)
+    bool polling = (lane->id == LANE_SENSOR && !state->sensor_interrupts);
+    int wait_ms = polling ? SENSOR_POLL_INTERVAL_MS : -1;
+    
+    printf("[Device] %s lane started\n", lane->name);
     
     while (state->server_running) {
-        // Command 처리
-        pthread_mutex_lock(&state->queue_mutex);
+        Command cmd;
         
-        while (queue_is_empty(&state->cmd_queue) && state->server_running) {
-            struct timespec ts;
-            clock_gettime(CLOCK_REALTIME, &ts);
-            ts.tv_sec += 1; // 1초 timeout
-            
-            pthread_cond_timedwait(&state->queue_not_empty, &state->queue_mutex, &ts);
-            
-            // Timeout 발생 시 sensor monitoring 체크
-            pthread_mutex_lock(&state->state_mutex);
-            bool monitoring = state->sensor_monitoring;
-            pthread_mutex_unlock(&state->state_mutex);
+        if (!queue_pop(&lane->queue, &cmd)) {
+            // 큐가 비어 있으면 대기 (폴링 중인 Sensor lane은 timeout마다 센서 확인)
+            queue_wait(&lane->queue, wait_ms);
             
-            if (monitoring) {
-                pthread_mutex_unlock(&state->queue_mutex);
-                handle_sensor_monitoring(state);
-                pthread_mutex_lock(&state->queue_mutex);
+            if (polling) {
+                poll_sensor(state);
             }
+            continue;
         }
         
-        if (!state->server_running) {
-            pthread_mutex_unlock(&state->queue_mutex);
-            break;
+        if (lane->id == LANE_BATCH) {
+            run_batch(state, &cmd);
+            continue;
         }
         
-        Command* cmd = queue_pop(&state->cmd_queue);
-        pthread_mutex_unlock(&state->queue_mutex);
+        pthread_mutex_lock(&lane->exec_mutex);
         
-        if (!cmd) {
+        if (lane->id == LANE_LED && state->led_coalescing) {
+            run_led_coalesced(state, lane, &cmd);
+            pthread_mutex_unlock(&lane->exec_mutex);
             continue;
         }
         
-        // 명령 처리
         CommandResponse response = {0};
+        device_execute(state, &cmd, &response);
+        pthread_mutex_unlock(&lane->exec_mutex);
+        post_response(state, &cmd, &response);
         
-        switch (cmd->type) {
-            case CMD_LED_ON:
-                process_led_on(state, &response);
-                break;
-                
-            case CMD_LED_OFF:
-                process_led_off(state, &response);
-                break;
-                
-            case CMD_SET_BRIGHTNESS:
-                process_set_brightness(state, cmd, &response);
-                break;
-                
-            case CMD_BUZZER_ON:
-                process_buzzer_on(state, cmd, &response);
-                // 음악 재생은 내부에서 응답을 이미 보냈음
-                if (response.status == -2) {
-                    free(cmd);
-                    continue; // 응답 전달 생략
-                }
-                break;
-                
-            case CMD_BUZZER_OFF:
-                process_buzzer_off(state, &response);
-                break;
-                
-            case CMD_SENSOR_ON:
-                process_sensor_on(state, &response);
-                break;
-                
-            case CMD_SENSOR_OFF:
-                process_sensor_off(state, &response);
-                break;
-                
-            case CMD_SEGMENT_DISPLAY:
-                process_segment_display(state, cmd, &response);
-                break;
-                
-            case CMD_SEGMENT_STOP:
-                process_segment_stop(state, &response);
-                break;
-                
-            default:
-                response.status = -1;
-                strcpy(response.message, "Unknown command");
-                break;
+        if (lane->id == LANE_LED) {
+            atomic_fetch_add_explicit(&state->led_commands, 1, memory_order_relaxed);
         }
         
-        // 응답 전달 (BUZZER_ON의 경우 이미 전달됨)
-        if (response.status != -2) {
-            pthread_mutex_lock(&state->queue_mutex);
-            memcpy(&state->response, &response, sizeof(CommandResponse));
-            pthread_cond_signal(&state->response_ready);
-            pthread_mutex_unlock(&state->queue_mutex);
+        if (polling) {
+            poll_sensor(state);
         }
+    }
+    
+    if (lane->id == LANE_LED) {
+        printf("[Device] LED commands: %lu, hardware writes elided: %lu\n",
+               atomic_load(&state->led_commands), atomic_load(&state->led_writes_elided));
+    }
+    printf("[Device] %s lane stopped\n", lane->name);
+    return NULL;
+}
+
+// 명령 타입 -> 담당 lane (알 수 없는 명령이면 -1)
+int command_lane(CommandType type) {
+    switch (type) {
+        case CMD_LED_ON:
+        case CMD_LED_OFF:
+        case CMD_SET_BRIGHTNESS:
+            return LANE_LED;
+        case CMD_BUZZER_ON:
+        case CMD_BUZZER_OFF:
+            return LANE_BUZZER;
+        case CMD_SEGMENT_DISPLAY:
+        case CMD_SEGMENT_STOP:
+            return LANE_SEGMENT;
+        case CMD_SENSOR_ON:
+        case CMD_SENSOR_OFF:
+            return LANE_SENSOR;
+        default:
+            return -1;
+    }
+}
+
+// 중단 계열 명령은 같은 lane에 쌓인 일반 명령보다 먼저 처리
+CommandPriority command_priority(CommandType type) {
+    switch (type) {
+        case CMD_BUZZER_OFF:
+        case CMD_SEGMENT_STOP:
+        case CMD_SENSOR_OFF:
+            return PRIORITY_URGENT;
+        default:
+            return PRIORITY_NORMAL;
+    }
+}
+
+bool device_submit(ServerState* state, const Command* cmd) {
+    int lane = command_lane(cmd->type);
+    if (lane < 0) {
+        return false;
+    }
+    return queue_push_priority(&state->lanes[lane].queue, cmd, command_priority(cmd->type));
+}
+
+// batch pool에 명령을 복사하고 Batch lane에 넣는다 (명령 타입은 호출자가 검사)
+bool device_submit_batch(ServerState* state, const Command* commands, int count,
+                         uint32_t request_id, uint32_t conn_id) {
+    for (int i = 0; i < MAX_BATCHES; i++) {
+        CommandBatch* batch = &state->batches[i];
+        bool expected = false;
         
-        free(cmd);
+        if (!atomic_compare_exchange_strong(&batch->in_use, &expected, true)) {
+            continue;
+        }
         
-        // Sensor monitoring 체크 (명령 처리 후)
-        pthread_mutex_lock(&state->state_mutex);
-        bool monitoring = state->sensor_monitoring;
-        pthread_mutex_unlock(&state->state_mutex);
+        batch->count = count;
+        memcpy(batch->commands, commands, sizeof(Command) * (size_t)count);
         
-        if (monitoring) {
-            handle_sensor_monitoring(state);
+        Command cmd = {0};
+        cmd.type = CMD_BATCH;
+        cmd.param1 = i;
+        cmd.request_id = request_id;
+        cmd.conn_id = conn_id;
+        
+        if (!queue_push(&state->lanes[LANE_BATCH].queue, &cmd)) {
+            atomic_store(&batch->in_use, false);
+            return false;
         }
+        return true;
     }
     
-    printf("[Device Thread] Stopped\n");
-    return NULL;
+    return false;
+}
+
+int device_lanes_init(ServerState* state) {
+    for (int i = 0; i < LANE_COUNT; i++) {
+        DeviceLane* lane = &state->lanes[i];
+        
+        lane->id = (LaneId)i;
+        lane->name = LANE_NAMES[i];
+        lane->started = false;
+        lane->state = state;
+        
+        if (queue_init(&lane->queue) != 0) {
+            fprintf(stderr, "Failed to initialize %s command queue\n", lane->name);
+            for (int j = 0; j < i; j++) {
+                queue_cleanup(&state->lanes[j].queue);
+                pthread_mutex_destroy(&state->lanes[j].exec_mutex);
+            }
+            return -1;
+        }
+        pthread_mutex_init(&lane->exec_mutex, NULL);
+    }
+    
+    for (int i = 0; i < MAX_BATCHES; i++) {
+        atomic_init(&state->batches[i].in_use, false);
+    }
+    
+    device_state_init(&state->device);
+    sensor_history_init(&state->history);
+    
+    g_state = state;
+    music_set_finish_callback(music_finish_callback);
+    return 0;
+}
+
+int device_lanes_start(ServerState* state) {
+    // 멜로디 파일은 시작할 때 한 번만 읽는다 (디렉토리가 없으면 내장 곡만 사용)
+    if (state->melody_dir) {
+        int loaded = music_load_dir(state->melody_dir);
+        printf("[Device] Melodies: %d loaded from %s, %d available\n",
+               loaded > 0 ? loaded : 0, state->melody_dir, music_list(NULL, 0));
+    }
+    
+    // 센서: 감시하지 않을 때는 에지 인터럽트 (없으면 Sensor lane 폴링),
+    // 감시하는 동안에는 필터 샘플러 (SENSOR_ON / SENSOR_OFF에서 시작 / 정지)
+    state->sensor_interrupts = (light_sensor_set_callback(light_change_callback) == 0);
+    state->sensor_sampler = (state->sensor_rate_hz > 0);
+    if (state->sensor_sampler) {
+        light_sampler_set_sample_callback(history_sample_callback);
+    }
+    
+    if (state->sensor_sampler) {
+        printf("[Device] Light sensor: %s, sampler while monitoring (%d Hz, filtered)\n",
+               state->sensor_interrupts ? "edge interrupts" : "polling", state->sensor_rate_hz);
+    } else {
+        printf("[Device] Light sensor: %s\n",
+               state->sensor_interrupts ? "edge interrupts" : "polling");
+    }
+    
+    for (int i = 0; i < LANE_COUNT; i++) {
+        DeviceLane* lane = &state->lanes[i];
+        
+        if (pthread_create(&lane->thread, NULL, lane_thread, lane) != 0) {
+            fprintf(stderr, "Failed to create %s lane thread\n", lane->name);
+            return -1;
+        }
+        lane->started = true;
+    }
+    
+    return 0;
+}
+
+// server_running이 false가 된 뒤 호출
+void device_lanes_stop(ServerState* state) {
+    for (int i = 0; i < LANE_COUNT; i++) {
+        queue_close(&state->lanes[i].queue);
+    }
+    
+    for (int i = 0; i < LANE_COUNT; i++) {
+        DeviceLane* lane = &state->lanes[i];
+        if (lane->started) {
+            pthread_join(lane->thread, NULL);
+            lane->started = false;
+        }
+    }
+    
+    // 감시 중에 종료하면 샘플러가 아직 돈다 (lane이 모두 끝난 뒤라 sensor_sampling을 바꾸는 스레드가 없음)
+    stop_light_sampler(state);
+    if (state->sensor_sampler) {
+        light_sampler_set_sample_callback(NULL);
+    }
+    if (state->sensor_interrupts) {
+        light_sensor_set_callback(NULL);
+    }
+}
+
+void device_lanes_cleanup(ServerState* state) {
+    music_set_finish_callback(NULL);
+    
+    for (int i = 0; i < LANE_COUNT; i++) {
+        queue_cleanup(&state->lanes[i].queue);
+        pthread_mutex_destroy(&state->lanes[i].exec_mutex);
+    }
 }
@@ -0,0 +1,76 @@
+#include <string.h>
+#include <sched.h>
+#include "server.h"
+
+// 디바이스 상태 저장소 (seqlock)
+// - 쓰기: sequence를 짝수 -> 홀수로 바꾼(CAS) 스레드 하나만 상태를 고친 뒤 다시 짝수로 만든다.
+//         쓰기 구간은 필드 몇 개를 고치는 것뿐이라 다른 writer는 잠깐 돌며 기다린다.
+// - 읽기: 잠금 없이 상태를 복사한 뒤 sequence가 그대로인지 확인한다.
+//         읽는 쪽은 공유 메모리에 쓰지 않으므로 reader가 많아도 writer나 다른 reader를 밀어내지 않는다.
+
+#define WRITER_SPIN_LIMIT 64
+
+_Static_assert(sizeof(DeviceState) == CACHE_LINE_SIZE,
+               "DeviceState must fit in one cache line");
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+void device_state_init(DeviceState* ds) {
+    memset(&ds->current, 0, sizeof(ds->current));
+    ds->current.sensor_value = -1;
+    atomic_init(&ds->sequence, 0);
+}
+
+DeviceStatus* device_state_begin_write(DeviceState* ds) {
+    int spins = 0;
+    
+    for (;;) {
+        unsigned int seq = atomic_load_explicit(&ds->sequence, memory_order_relaxed);
+        
+        if (!(seq & 1) &&
+            atomic_compare_exchange_weak_explicit(&ds->sequence, &seq, seq + 1,
+                                                  memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            break;
+        }
+        
+        if (++spins < WRITER_SPIN_LIMIT) {
+            cpu_relax();
+        } else {
+            sched_yield();
+            spins = 0;
+        }
+    }
+    
+    // 홀수 sequence가 상태 변경보다 먼저 보이도록
+    atomic_thread_fence(memory_order_release);
+    return &ds->current;
+}
+
+void device_state_end_write(DeviceState* ds) {
+    atomic_fetch_add_explicit(&ds->sequence, 1, memory_order_release);
+}
+
+void device_state_read(DeviceState* ds, DeviceStatus* status) {
+    for (;;) {
+        unsigned int begin = atomic_load_explicit(&ds->sequence, memory_order_acquire);
+        
+        if (begin & 1) {
+            cpu_relax();
+            continue;
+        }
+        
+        memcpy(status, &ds->current, sizeof(*status));
+        atomic_thread_fence(memory_order_acquire);
+        
+        if (atomic_load_explicit(&ds->sequence, memory_order_relaxed) == begin) {
+            return;
+        }
+    }
+}
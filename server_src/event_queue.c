@@ -0,0 +1,99 @@
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "server.h"
+
+// 이벤트 큐 (디바이스 스레드들 -> reactor)
+// Response Queue와 같은 sequence 슬롯 방식의 링 버퍼.
+// 응답과 달리 이벤트는 가득 차면 기다리지 않고 버린다 (디바이스 스레드는 절대 막히지 않음).
+// 이벤트는 상태 변화 알림이므로 몇 개가 빠져도 다음 이벤트가 최신 상태를 알려 준다.
+
+#define EVENT_MASK (MAX_EVENT_QUEUE_SIZE - 1)
+
+_Static_assert((MAX_EVENT_QUEUE_SIZE & EVENT_MASK) == 0,
+               "MAX_EVENT_QUEUE_SIZE must be a power of two");
+
+int event_queue_init(EventQueue* queue) {
+    for (unsigned int i = 0; i < MAX_EVENT_QUEUE_SIZE; i++) {
+        atomic_init(&queue->slots[i].sequence, i);
+        memset(&queue->slots[i].event, 0, sizeof(DeviceEvent));
+    }
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->notify_pending, 0);
+    atomic_init(&queue->dropped, 0);
+
+    queue->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (queue->event_fd < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+bool event_queue_push(EventQueue* queue, const DeviceEvent* event) {
+    EventSlot* slot;
+    unsigned int pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    for (;;) {
+        slot = &queue->slots[pos & EVENT_MASK];
+        unsigned int seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int diff = (int)(seq - pos);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+
+    slot->event = *event;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+
+    if (atomic_exchange_explicit(&queue->notify_pending, 1, memory_order_acq_rel) == 0) {
+        uint64_t one = 1;
+        ssize_t ret = write(queue->event_fd, &one, sizeof(one));
+        (void)ret;
+    }
+
+    return true;
+}
+
+bool event_queue_pop(EventQueue* queue, DeviceEvent* event) {
+    unsigned int pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    EventSlot* slot = &queue->slots[pos & EVENT_MASK];
+    unsigned int seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+
+    if (seq != pos + 1) {
+        return false;
+    }
+
+    *event = slot->event;
+    atomic_store_explicit(&slot->sequence, pos + MAX_EVENT_QUEUE_SIZE, memory_order_release);
+    atomic_store_explicit(&queue->tail, pos + 1, memory_order_relaxed);
+
+    return true;
+}
+
+// response_queue_ack과 같은 규칙: 호출자는 ack 후 큐를 끝까지 비워야 한다
+void event_queue_ack(EventQueue* queue) {
+    uint64_t count;
+    ssize_t ret = read(queue->event_fd, &count, sizeof(count));
+    (void)ret;
+
+    atomic_exchange_explicit(&queue->notify_pending, 0, memory_order_acq_rel);
+}
+
+void event_queue_cleanup(EventQueue* queue) {
+    if (queue->event_fd >= 0) {
+        close(queue->event_fd);
+        queue->event_fd = -1;
+    }
+}
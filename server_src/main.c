@@ -98,6 +98,16 @@ void print_usage(const char* program_name) {
     printf("\n");
     printf("Options:\n");
     printf("  -d, --daemon     Run as daemon process\n");
+    printf("  -n, --no-coalesce  Disable LED command coalescing\n");
+    printf("  -r, --sample-rate <hz>  Light sensor sampling rate while monitoring\n"
+           "                   (default %d, 0 = raw edge interrupts)\n",
+           SENSOR_SAMPLE_RATE_HZ);
+    printf("  -m, --melody-dir <dir>  Melody files (*.mel) to load at startup (default %s)\n",
+           MELODY_DIR);
+    printf("  -s, --seg-digits <pins>[:colon]  Multiplexed 7-segment digit select pins, left to right\n");
+    printf("                   (default: single digit, e.g. 5,6,13,19:26)\n");
+    printf("  -f, --seg-refresh <hz>  7-segment refresh rate (default %d)\n", SEG7_DEFAULT_REFRESH_HZ);
+    printf("  -g, --gpio <backend>  GPIO backend: wiringpi, gpiod, sim (default $GPIO_BACKEND or build default)\n");
     printf("  -h, --help       Show this help message\n");
     printf("\n");
     printf("Examples:\n");
@@ -114,6 +124,11 @@ void print_usage(const char* program_name) {
 
 int main(int argc, char* argv[]) {
     bool daemon_mode = false;
+    bool led_coalescing = true;
+    int sensor_rate_hz = SENSOR_SAMPLE_RATE_HZ;
+    const char* melody_dir = MELODY_DIR;
+    const char* seg_digits = NULL;
+    int seg_refresh_hz = 0;
     
     // 현재 작업 디렉토리 저장
     if (getcwd(g_working_dir, sizeof(g_working_dir)) == NULL) {
@@ -125,6 +140,31 @@ int main(int argc, char* argv[]) {
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--daemon") == 0) {
             daemon_mode = true;
+        } else if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--no-coalesce") == 0) {
+            led_coalescing = false;
+        } else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--sample-rate") == 0) &&
+                   i + 1 < argc) {
+            sensor_rate_hz = atoi(argv[++i]);
+            if (sensor_rate_hz < 0 || sensor_rate_hz > 1000) {
+                fprintf(stderr, "Invalid sample rate: %s (use 0-1000)\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if ((strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--melody-dir") == 0) &&
+                   i + 1 < argc) {
+            melody_dir = argv[++i];
+        } else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--seg-digits") == 0) &&
+                   i + 1 < argc) {
+            seg_digits = argv[++i];
+        } else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--seg-refresh") == 0) &&
+                   i + 1 < argc) {
+            seg_refresh_hz = atoi(argv[++i]);
+            if (seg_refresh_hz < 1 || seg_refresh_hz > SEG7_MAX_REFRESH_HZ) {
+                fprintf(stderr, "Invalid refresh rate: %s (use 1-%d)\n", argv[i], SEG7_MAX_REFRESH_HZ);
+                return EXIT_FAILURE;
+            }
+        } else if ((strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--gpio") == 0) &&
+                   i + 1 < argc) {
+            server_set_gpio_backend(argv[++i]);
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return EXIT_SUCCESS;
@@ -135,6 +175,12 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (seg_digits && server_set_segment_digits(seg_digits, seg_refresh_hz) != 0) {
+        fprintf(stderr, "Invalid digit pins: %s (use pin,pin,...[:colon], up to %d digits)\n",
+                seg_digits, SEG7_MAX_DIGITS);
+        return EXIT_FAILURE;
+    }
+    
     // 데몬 모드로 실행
     if (daemon_mode) {
         printf("Starting IoT Server as daemon...\n");
@@ -183,6 +229,9 @@ int main(int argc, char* argv[]) {
         }
         return EXIT_FAILURE;
     }
+    g_server_state.led_coalescing = led_coalescing;
+    g_server_state.sensor_rate_hz = sensor_rate_hz;
+    g_server_state.melody_dir = melody_dir;
     
     // 웹 서버 시작
     log_message("INFO", "Starting web camera server...");
@@ -195,10 +244,9 @@ int main(int argc, char* argv[]) {
                    g_server_state.server_ip, WEB_SERVER_PORT);
     }
     
-    // Device Control Thread 생성
-    if (pthread_create(&g_server_state.device_thread, NULL, 
-                       device_control_thread, &g_server_state) != 0) {
-        log_message("ERROR", "Failed to create device control thread");
+    // 디바이스 lane worker 스레드 생성
+    if (device_lanes_start(&g_server_state) != 0) {
+        log_message("ERROR", "Failed to create device lane threads");
         if (g_server_state.web_server_pid > 0) {
             stop_web_server(g_server_state.web_server_pid);
         }
@@ -212,65 +260,9 @@ int main(int argc, char* argv[]) {
     log_message("INFO", "Server is running. Press Ctrl+C to stop.");
     log_message("INFO", "Listening on port %d", SERVER_PORT);
     
-    // 클라이언트 연결 대기 및 처리
-    while (g_running && g_server_state.server_running) {
-        struct sockaddr_in client_addr;
-        socklen_t client_len = sizeof(client_addr);
-        
-        int client_socket = accept(g_server_state.server_socket, 
-                                   (struct sockaddr*)&client_addr, 
-                                   &client_len);
-        
-        if (client_socket < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                usleep(500000);
-                continue;
-            } else if (errno == EINTR) {
-                continue;
-            } else if (g_running) {
-                log_message("ERROR", "accept failed: %s", strerror(errno));
-            }
-            break;
-        }
-        
-        pthread_mutex_lock(&g_server_state.state_mutex);
-        
-        if (g_server_state.client_connected) {
-            pthread_mutex_unlock(&g_server_state.state_mutex);
-            
-            const char* busy_msg = "Server busy - another client is connected\n";
-            send(client_socket, busy_msg, strlen(busy_msg), 0);
-            close(client_socket);
-            
-            log_message("WARN", "Rejected connection - server busy");
-            continue;
-        }
-        
-        g_server_state.client_socket = client_socket;
-        g_server_state.client_connected = true;
-        
-        pthread_mutex_unlock(&g_server_state.state_mutex);
-        
-        log_message("INFO", "Client connected from %s:%d", 
-                   inet_ntoa(client_addr.sin_addr), 
-                   ntohs(client_addr.sin_port));
-        
-        if (pthread_create(&g_server_state.comm_thread, NULL, 
-                          communication_thread, &g_server_state) != 0) {
-            log_message("ERROR", "Failed to create communication thread");
-            
-            pthread_mutex_lock(&g_server_state.state_mutex);
-            close(client_socket);
-            g_server_state.client_socket = -1;
-            g_server_state.client_connected = false;
-            pthread_mutex_unlock(&g_server_state.state_mutex);
-            
-            continue;
-        }
-        
-        pthread_join(g_server_state.comm_thread, NULL);
-        
-        log_message("INFO", "Client disconnected");
+    // 클라이언트 연결 처리 (epoll reactor, Ctrl+C까지 반환하지 않음)
+    if (reactor_run(&g_server_state, &g_running) != 0) {
+        log_message("ERROR", "Reactor failed");
     }
     
     // 서버 정리
@@ -0,0 +1,340 @@
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "server.h"
+
+// 통신 프로토콜 인코딩/디코딩
+// - 텍스트: "[@id] <type> <param1> <param2>\n" -> "[#id] [SUCCESS|ERROR] message\n"
+// - 바이너리: 접속 직후 BINARY_MAGIC을 보낸 연결만 사용. 모든 값은 little-endian
+//     명령 프레임 (16 bytes): u32 request_id, u8 type, u8 flags, u16 reserved, i32 param1, i32 param2
+//     응답 프레임 (12 bytes): u32 request_id, i32 status, i32 value
+//     이벤트 프레임 (20 bytes): u32 BINARY_EVENT_ID, i32 event type, i32 value, u64 timestamp_ms
+//       (앞 12 bytes는 응답 프레임과 같은 모양이므로 request_id로 구분해 8 bytes를 더 읽는다)
+// - 상태 조회 (텍스트): "[#id] [SUCCESS] led=on brightness=2 buzzer=off music=1 sensor=on light=dark countdown=on remaining=3"
+//   (바이너리): 응답 프레임의 value에 STATUS_BIT_* / STATUS_SHIFT_* 로 묶어서 전달
+// - 센서 기록 조회 (텍스트): "[#id] [SUCCESS] window=60s tier=second samples=6000 min=0 max=1 mean=0.524 duty=0.500"
+//   (바이너리): 응답 프레임의 value에 HISTORY_SHIFT_* 로 묶어서 전달
+// - 곡 목록 (텍스트): "[#id] [SUCCESS] melodies=5 1:school_bell 2:twinkle_star ... 5:ode_to_joy"
+//   (바이너리): 응답 프레임의 value = 곡 수 (바이너리 연결은 곡 번호로만 선택)
+// - 이벤트 (텍스트): "[EVENT] ts=<epoch ms> device=<name> event=<name> value=<n> [coalesced=<n>]\n"
+
+static const char* EVENT_DEVICE_NAMES[EVENT_DEVICE_COUNT] = {
+    [EVENT_DEVICE_LED] = "led",
+    [EVENT_DEVICE_BUZZER] = "buzzer",
+    [EVENT_DEVICE_SEGMENT] = "segment",
+    [EVENT_DEVICE_SENSOR] = "sensor"
+};
+
+static const char* EVENT_TYPE_NAMES[] = {
+    [EVENT_LED_ON] = "on",
+    [EVENT_LED_OFF] = "off",
+    [EVENT_LED_BRIGHTNESS] = "brightness",
+    [EVENT_MUSIC_STARTED] = "music_started",
+    [EVENT_MUSIC_FINISHED] = "music_finished",
+    [EVENT_MUSIC_STOPPED] = "music_stopped",
+    [EVENT_COUNTDOWN_STARTED] = "countdown_started",
+    [EVENT_COUNTDOWN_STOPPED] = "countdown_stopped",
+    [EVENT_COUNTDOWN_FINISHED] = "countdown_finished",
+    [EVENT_SENSOR_MONITOR_ON] = "monitor_on",
+    [EVENT_SENSOR_MONITOR_OFF] = "monitor_off",
+    [EVENT_LIGHT_DETECTED] = "light",
+    [EVENT_DARK_DETECTED] = "dark"
+};
+
+static uint32_t read_u32le(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void write_u32le(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static void write_u64le(uint8_t* p, uint64_t value) {
+    write_u32le(p, (uint32_t)value);
+    write_u32le(p + 4, (uint32_t)(value >> 32));
+}
+
+static const char* skip_blank(const char* p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+// 10진 정수 하나를 제자리에서 읽는다 (앞의 공백 무시, 숫자가 없으면 false)
+bool protocol_parse_int(const char** buffer, int* value) {
+    const char* p = skip_blank(*buffer);
+    bool negative = false;
+    long result = 0;
+    
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        p++;
+    }
+    
+    if (*p < '0' || *p > '9') {
+        return false;
+    }
+    
+    while (*p >= '0' && *p <= '9') {
+        if (result < 1000000000L) {
+            result = result * 10 + (*p - '0');
+        }
+        p++;
+    }
+    
+    *value = (int)(negative ? -result : result);
+    *buffer = p;
+    return true;
+}
+
+// 선택적 요청 ID: "@<id> ..." (없으면 has_id = false)
+bool protocol_parse_request_id(const char** buffer, uint32_t* request_id, bool* has_id) {
+    const char* p = skip_blank(*buffer);
+    
+    *has_id = false;
+    
+    if (*p == '@') {
+        uint32_t id = 0;
+        p++;
+        
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        while (*p >= '0' && *p <= '9') {
+            id = id * 10 + (uint32_t)(*p - '0');
+            p++;
+        }
+        *request_id = id;
+        *has_id = true;
+        
+        p = skip_blank(p);
+    }
+    
+    *buffer = p;
+    return true;
+}
+
+// 이름 토큰 하나 (영문자 또는 '_'로 시작, 영문자/숫자/'_'/'-'). 없거나 너무 길면 false
+bool protocol_parse_name(const char** buffer, char* name, size_t size) {
+    const char* p = skip_blank(*buffer);
+    size_t len = 0;
+    
+    if (!isalpha((unsigned char)*p) && *p != '_') {
+        return false;
+    }
+    
+    while (isalnum((unsigned char)p[len]) || p[len] == '_' || p[len] == '-') {
+        if (len + 1 >= size) {
+            return false;
+        }
+        name[len] = p[len];
+        len++;
+    }
+    name[len] = '\0';
+    
+    *buffer = p + len;
+    return true;
+}
+
+// "<type> [param1] [param2]" (없는 파라미터는 0)
+bool protocol_parse_command(const char* buffer, Command* cmd) {
+    int type, param1 = 0, param2 = 0;
+    
+    if (!protocol_parse_int(&buffer, &type)) {
+        return false;
+    }
+    if (protocol_parse_int(&buffer, &param1)) {
+        protocol_parse_int(&buffer, &param2);
+    }
+    
+    cmd->type = (CommandType)type;
+    cmd->param1 = param1;
+    cmd->param2 = param2;
+    cmd->request_id = 0;
+    cmd->conn_id = 0;
+    
+    return true;
+}
+
+int protocol_format_response(const CommandResponse* response, char* buffer, size_t size) {
+    int len = snprintf(buffer, size, "[#%u] [%s] %s\n", response->request_id,
+                       response->status == STATUS_OK ? "SUCCESS" : "ERROR",
+                       response->message);
+    
+    // 잘린 경우에도 개행으로 끝나도록
+    if (len >= (int)size) {
+        len = (int)size - 1;
+        buffer[len - 1] = '\n';
+    }
+    return len;
+}
+
+void protocol_decode_command(const uint8_t* frame, Command* cmd) {
+    cmd->request_id = read_u32le(frame);
+    cmd->type = (CommandType)frame[4];
+    cmd->param1 = (int32_t)read_u32le(frame + 8);
+    cmd->param2 = (int32_t)read_u32le(frame + 12);
+    cmd->conn_id = 0;
+}
+
+void protocol_encode_command(const Command* cmd, uint8_t* frame) {
+    write_u32le(frame, cmd->request_id);
+    frame[4] = (uint8_t)cmd->type;
+    frame[5] = 0;
+    frame[6] = 0;
+    frame[7] = 0;
+    write_u32le(frame + 8, (uint32_t)cmd->param1);
+    write_u32le(frame + 12, (uint32_t)cmd->param2);
+}
+
+void protocol_encode_response(const CommandResponse* response, uint8_t* frame) {
+    write_u32le(frame, response->request_id);
+    write_u32le(frame + 4, (uint32_t)response->status);
+    write_u32le(frame + 8, (uint32_t)response->value);
+}
+
+void protocol_decode_response(const uint8_t* frame, CommandResponse* response) {
+    response->request_id = read_u32le(frame);
+    response->status = (int32_t)read_u32le(frame + 4);
+    response->value = (int32_t)read_u32le(frame + 8);
+    response->message[0] = '\0';
+}
+
+// 카운트다운 남은 초 (시작 시각으로부터 계산)
+static int countdown_remaining(const DeviceStatus* status, long long now_ms) {
+    if (!status->segment_counting) {
+        return 0;
+    }
+    
+    long long elapsed = (now_ms - status->countdown_started_ms) / 1000;
+    int remaining = status->countdown_start - (int)elapsed;
+    return remaining > 0 ? remaining : 0;
+}
+
+int protocol_format_status(const DeviceStatus* status, long long now_ms,
+                           char* buffer, size_t size) {
+    const char* light = status->sensor_value < 0 ? "unknown"
+                      : status->sensor_value ? "bright" : "dark";
+    
+    return snprintf(buffer, size,
+                    "led=%s brightness=%d buzzer=%s music=%d sensor=%s light=%s "
+                    "countdown=%s remaining=%d",
+                    status->led_on ? "on" : "off", status->led_brightness,
+                    status->buzzer_playing ? "playing" : "off", status->music_number,
+                    status->sensor_monitoring ? "on" : "off", light,
+                    status->segment_counting ? "on" : "off",
+                    countdown_remaining(status, now_ms));
+}
+
+int protocol_status_value(const DeviceStatus* status, long long now_ms) {
+    int value = 0;
+    
+    if (status->led_on)            value |= STATUS_BIT_LED_ON;
+    if (status->buzzer_playing)    value |= STATUS_BIT_BUZZER_PLAYING;
+    if (status->sensor_monitoring) value |= STATUS_BIT_SENSOR_ON;
+    if (status->sensor_value > 0)  value |= STATUS_BIT_BRIGHT;
+    if (status->sensor_value >= 0) value |= STATUS_BIT_SENSOR_VALID;
+    if (status->segment_counting)  value |= STATUS_BIT_COUNTING;
+    
+    value |= (status->led_brightness & 0xF) << STATUS_SHIFT_BRIGHTNESS;
+    value |= (status->music_number & 0xF) << STATUS_SHIFT_MUSIC;
+    int remaining = countdown_remaining(status, now_ms);
+    if (remaining > STATUS_REMAINING_MAX) {
+        remaining = STATUS_REMAINING_MAX;
+    }
+    value |= (remaining & 0xF) << STATUS_SHIFT_REMAINING;
+    value |= ((status->music_number >> 4) & 0xF) << STATUS_SHIFT_MUSIC_HIGH;
+    value |= (int)((unsigned int)(remaining >> 4) << STATUS_SHIFT_REMAINING_HIGH);
+    return value;
+}
+
+static const char* HISTORY_TIER_NAMES[] = {
+    [HISTORY_TIER_RAW] = "raw",
+    [HISTORY_TIER_SECOND] = "second",
+    [HISTORY_TIER_MINUTE] = "minute"
+};
+
+int protocol_format_history(const HistoryStats* stats, int window_sec,
+                            char* buffer, size_t size) {
+    return snprintf(buffer, size,
+                    "window=%ds tier=%s samples=%lu min=%d max=%d mean=%.3f duty=%.3f",
+                    window_sec, HISTORY_TIER_NAMES[stats->tier], stats->samples,
+                    stats->min, stats->max, stats->mean, stats->duty_cycle);
+}
+
+int protocol_history_value(const HistoryStats* stats) {
+    int mean = (int)(stats->mean * 1000.0 + 0.5);
+    int duty = (int)(stats->duty_cycle * 1000.0 + 0.5);
+    int value = 0;
+    
+    value |= (mean & 0x3FF) << HISTORY_SHIFT_MEAN;
+    value |= (duty & 0x3FF) << HISTORY_SHIFT_DUTY;
+    value |= (stats->min & 0xF) << HISTORY_SHIFT_MIN;
+    value |= (stats->max & 0xF) << HISTORY_SHIFT_MAX;
+    value |= ((int)stats->tier & 0x3) << HISTORY_SHIFT_TIER;
+    return value;
+}
+
+int protocol_format_music_list(const MusicInfo* infos, int count, char* buffer, size_t size) {
+    int len = snprintf(buffer, size, "melodies=%d", count);
+    
+    for (int i = 0; i < count && len < (int)size; i++) {
+        len += snprintf(buffer + len, size - (size_t)len, " %d:%s", infos[i].id, infos[i].name);
+    }
+    return len < (int)size ? len : (int)size - 1;
+}
+
+EventDevice event_device(EventType type) {
+    switch (type) {
+        case EVENT_LED_ON:
+        case EVENT_LED_OFF:
+        case EVENT_LED_BRIGHTNESS:
+            return EVENT_DEVICE_LED;
+        case EVENT_MUSIC_STARTED:
+        case EVENT_MUSIC_FINISHED:
+        case EVENT_MUSIC_STOPPED:
+            return EVENT_DEVICE_BUZZER;
+        case EVENT_COUNTDOWN_STARTED:
+        case EVENT_COUNTDOWN_STOPPED:
+        case EVENT_COUNTDOWN_FINISHED:
+            return EVENT_DEVICE_SEGMENT;
+        default:
+            return EVENT_DEVICE_SENSOR;
+    }
+}
+
+const char* event_device_name(EventDevice device) {
+    return EVENT_DEVICE_NAMES[device];
+}
+
+const char* event_type_name(EventType type) {
+    return EVENT_TYPE_NAMES[type];
+}
+
+// coalesced: 이 이벤트로 대체된(전송하지 않은) 같은 디바이스의 이벤트 수
+int protocol_format_event(const DeviceEvent* event, unsigned int coalesced,
+                          char* buffer, size_t size) {
+    int len = snprintf(buffer, size, "[EVENT] ts=%lld device=%s event=%s value=%d",
+                       event->timestamp_ms, event_device_name(event_device(event->type)),
+                       event_type_name(event->type), event->value);
+    
+    if (coalesced > 0 && len < (int)size) {
+        len += snprintf(buffer + len, size - (size_t)len, " coalesced=%u", coalesced);
+    }
+    if (len >= (int)size - 1) {
+        len = (int)size - 2;
+    }
+    buffer[len++] = '\n';
+    buffer[len] = '\0';
+    return len;
+}
+
+void protocol_encode_event(const DeviceEvent* event, uint8_t* frame) {
+    write_u32le(frame, BINARY_EVENT_ID);
+    write_u32le(frame + 4, (uint32_t)event->type);
+    write_u32le(frame + 8, (uint32_t)event->value);
+    write_u64le(frame + 12, (uint64_t)event->timestamp_ms);
+}
@@ -0,0 +1,421 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "server.h"
+
+// epoll 기반 Reactor
+// 단일 스레드가 listen 소켓, 모든 클라이언트 소켓, Response / Event Queue의 eventfd를 감시한다.
+// 연결 테이블은 고정 크기이며 reactor 스레드만 접근하므로 잠금이 필요 없다.
+
+#define MAX_EVENTS 64
+#define CONN_INDEX_MASK ((1u << CONN_INDEX_BITS) - 1)
+#define EXPIRE_INTERVAL_MS 1000
+#define NEGOTIATE_CHECK_MS 20
+
+_Static_assert(MAX_CONNECTIONS <= (1 << CONN_INDEX_BITS),
+               "MAX_CONNECTIONS must fit in CONN_INDEX_BITS");
+
+// epoll 이벤트 데이터에서 listen 소켓과 eventfd를 구분하기 위한 값
+#define TOKEN_LISTEN   ((uint64_t)-1)
+#define TOKEN_RESPONSE ((uint64_t)-2)
+#define TOKEN_EVENT    ((uint64_t)-3)
+
+static Connection* g_connections = NULL;
+static uint32_t g_generation = 0;
+static int g_epoll_fd = -1;
+
+// 이번 루프에서 이벤트가 있었던 연결 (메뉴 전송/종료 처리 대상)
+static int g_dirty[MAX_CONNECTIONS];
+static int g_dirty_count = 0;
+
+static void mark_dirty(Connection* conn) {
+    if (!conn->dirty) {
+        conn->dirty = true;
+        g_dirty[g_dirty_count++] = (int)(conn->conn_id & CONN_INDEX_MASK);
+    }
+}
+
+static void update_interest(Connection* conn, bool want_write) {
+    if (conn->want_write == want_write) {
+        return;
+    }
+    
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP | (want_write ? EPOLLOUT : 0);
+    ev.data.u64 = conn->conn_id & CONN_INDEX_MASK;
+    
+    if (epoll_ctl(g_epoll_fd, EPOLL_CTL_MOD, conn->fd, &ev) == 0) {
+        conn->want_write = want_write;
+    }
+}
+
+static void flush_output(Connection* conn) {
+    while (conn->out_len > 0) {
+        ssize_t sent = send(conn->fd, conn->out_buf, conn->out_len, MSG_NOSIGNAL);
+        
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                conn->closing = true;
+            }
+            break;
+        }
+        
+        memmove(conn->out_buf, conn->out_buf + sent, conn->out_len - (size_t)sent);
+        conn->out_len -= (size_t)sent;
+    }
+    
+    update_interest(conn, conn->out_len > 0 && !conn->closing);
+}
+
+bool conn_send(Connection* conn, const char* data, size_t len) {
+    if (conn->closing) {
+        return false;
+    }
+    
+    // 버퍼가 모자라면 먼저 내보내 본다
+    if (conn->out_len + len > sizeof(conn->out_buf)) {
+        flush_output(conn);
+    }
+    
+    // 읽지 않는 클라이언트 때문에 출력이 한없이 쌓이지 않도록 연결을 끊는다
+    if (conn->out_len + len > sizeof(conn->out_buf)) {
+        printf("[Reactor] Conn %u output buffer overflow - closing\n", conn->conn_id);
+        conn->closing = true;
+        return false;
+    }
+    
+    // 실제 전송은 이벤트 루프 끝에서 한 번에 (응답 + 메뉴를 send 한 번으로)
+    memcpy(conn->out_buf + conn->out_len, data, len);
+    conn->out_len += len;
+    mark_dirty(conn);
+    
+    return true;
+}
+
+static Connection* lookup_connection(uint32_t conn_id) {
+    Connection* conn = &g_connections[conn_id & CONN_INDEX_MASK];
+    
+    if (conn->fd < 0 || conn->conn_id != conn_id) {
+        return NULL;
+    }
+    return conn;
+}
+
+static void close_connection(ServerState* state, Connection* conn) {
+    // 남은 출력(예: "Disconnecting...")은 가능한 만큼 보낸다
+    if (conn->out_len > 0) {
+        send(conn->fd, conn->out_buf, conn->out_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+    
+    epoll_ctl(g_epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    conn_closed(state, conn);
+    
+    printf("[Reactor] Conn %u closed (%d in flight dropped)\n",
+           conn->conn_id, conn->inflight_count);
+    
+    conn->fd = -1;
+    conn->out_len = 0;
+    state->connection_count--;
+}
+
+static void accept_connections(ServerState* state) {
+    for (;;) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        
+        int fd = accept4(state->server_socket, (struct sockaddr*)&client_addr,
+                         &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                printf("[Reactor] accept failed: %s\n", strerror(errno));
+            }
+            return;
+        }
+        
+        // 빈 슬롯 찾기
+        int index = -1;
+        for (int i = 0; i < MAX_CONNECTIONS; i++) {
+            if (g_connections[i].fd < 0) {
+                index = i;
+                break;
+            }
+        }
+        
+        if (index < 0) {
+            const char* busy_msg = "Server busy - too many connections\n";
+            send(fd, busy_msg, strlen(busy_msg), MSG_NOSIGNAL);
+            close(fd);
+            printf("[Reactor] Rejected connection - server busy\n");
+            continue;
+        }
+        
+        Connection* conn = &g_connections[index];
+        memset(conn, 0, sizeof(*conn));
+        conn->fd = fd;
+        conn->conn_id = (++g_generation << CONN_INDEX_BITS) | (uint32_t)index;
+        if (conn->conn_id == INTERNAL_CONN_ID) {
+            // 세대 값이 한 바퀴 돌아 내부 명령용 ID와 겹치는 경우
+            conn->conn_id = (++g_generation << CONN_INDEX_BITS) | (uint32_t)index;
+        }
+        
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = (uint64_t)index;
+        
+        if (epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            printf("[Reactor] epoll_ctl failed: %s\n", strerror(errno));
+            close(fd);
+            conn->fd = -1;
+            continue;
+        }
+        
+        state->connection_count++;
+        
+        printf("[Reactor] Conn %u connected from %s:%d (%d active)\n",
+               conn->conn_id, inet_ntoa(client_addr.sin_addr),
+               ntohs(client_addr.sin_port), state->connection_count);
+        
+        conn_open(state, conn);
+        mark_dirty(conn);
+    }
+}
+
+static void handle_readable(ServerState* state, Connection* conn) {
+    char buffer[BUFFER_SIZE];
+    
+    for (;;) {
+        ssize_t received = recv(conn->fd, buffer, sizeof(buffer) - 1, 0);
+        
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                printf("[Reactor] Conn %u receive error: %s\n", conn->conn_id, strerror(errno));
+                conn->closing = true;
+            }
+            return;
+        }
+        
+        if (received == 0) {
+            printf("[Reactor] Conn %u disconnected\n", conn->conn_id);
+            conn->closing = true;
+            return;
+        }
+        
+        if (!conn_process_input(state, conn, buffer, (size_t)received)) {
+            conn->closing = true;
+            return;
+        }
+    }
+}
+
+// Device lane이 보낸 응답을 요청한 연결로 전달
+static void dispatch_responses(ServerState* state) {
+    CommandResponse response;
+    
+    response_queue_ack(&state->resp_queue);
+    
+    while (response_queue_pop(&state->resp_queue, &response)) {
+        Connection* conn = lookup_connection(response.conn_id);
+        
+        // 이미 끊어진 연결의 응답은 버린다
+        if (!conn) {
+            continue;
+        }
+        
+        conn_deliver_response(conn, &response);
+        mark_dirty(conn);
+    }
+}
+
+// 디바이스 이벤트를 구독한 연결들로 전달
+static void dispatch_events(ServerState* state) {
+    DeviceEvent event;
+    
+    event_queue_ack(&state->event_queue);
+    
+    while (event_queue_pop(&state->event_queue, &event)) {
+        if (state->subscriber_count == 0) {
+            continue;
+        }
+        
+        for (int i = 0; i < MAX_CONNECTIONS; i++) {
+            Connection* conn = &g_connections[i];
+            if (conn->fd >= 0 && conn->event_mask != 0 && !conn->closing) {
+                conn_deliver_event(conn, &event);
+            }
+        }
+    }
+}
+
+// 핸드셰이크 시간이 지난 연결을 텍스트 모드로 시작
+static void check_negotiations(ServerState* state, long long now_ms) {
+    for (int i = 0; i < MAX_CONNECTIONS && state->negotiating_count > 0; i++) {
+        Connection* conn = &g_connections[i];
+        if (conn->fd >= 0 && conn->mode == CONN_MODE_NEGOTIATE) {
+            conn_check_negotiation(state, conn, now_ms);
+            mark_dirty(conn);
+        }
+    }
+}
+
+static void expire_connections(long long now_ms) {
+    for (int i = 0; i < MAX_CONNECTIONS; i++) {
+        Connection* conn = &g_connections[i];
+        if (conn->fd >= 0 && conn->inflight_count > 0) {
+            conn_expire_inflight(conn, now_ms);
+            mark_dirty(conn);
+        }
+    }
+}
+
+int reactor_run(ServerState* state, volatile sig_atomic_t* running) {
+    g_connections = (Connection*)calloc(MAX_CONNECTIONS, sizeof(Connection));
+    if (!g_connections) {
+        fprintf(stderr, "Failed to allocate connection table\n");
+        return -1;
+    }
+    for (int i = 0; i < MAX_CONNECTIONS; i++) {
+        g_connections[i].fd = -1;
+    }
+    
+    g_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (g_epoll_fd < 0) {
+        perror("epoll_create1");
+        free(g_connections);
+        g_connections = NULL;
+        return -1;
+    }
+    
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = TOKEN_LISTEN;
+    epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, state->server_socket, &ev);
+    
+    ev.events = EPOLLIN;
+    ev.data.u64 = TOKEN_RESPONSE;
+    epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, state->resp_queue.event_fd, &ev);
+    
+    ev.events = EPOLLIN;
+    ev.data.u64 = TOKEN_EVENT;
+    epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, state->event_queue.event_fd, &ev);
+    
+    printf("[Reactor] Started (max %d connections)\n", MAX_CONNECTIONS);
+    
+    struct epoll_event events[MAX_EVENTS];
+    long long next_expire = monotonic_ms() + EXPIRE_INTERVAL_MS;
+    
+    while (*running && state->server_running) {
+        // 핸드셰이크 대기 중인 연결이 있으면 짧은 간격으로 깨어난다
+        int timeout = state->negotiating_count > 0 ? NEGOTIATE_CHECK_MS : EXPIRE_INTERVAL_MS;
+        int n = epoll_wait(g_epoll_fd, events, MAX_EVENTS, timeout);
+        
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            printf("[Reactor] epoll_wait failed: %s\n", strerror(errno));
+            break;
+        }
+        
+        for (int i = 0; i < n; i++) {
+            uint64_t token = events[i].data.u64;
+            
+            if (token == TOKEN_LISTEN) {
+                accept_connections(state);
+                continue;
+            }
+            
+            if (token == TOKEN_RESPONSE) {
+                dispatch_responses(state);
+                continue;
+            }
+            
+            if (token == TOKEN_EVENT) {
+                dispatch_events(state);
+                continue;
+            }
+            
+            Connection* conn = &g_connections[token];
+            if (conn->fd < 0) {
+                continue;
+            }
+            mark_dirty(conn);
+            
+            if (events[i].events & EPOLLOUT) {
+                flush_output(conn);
+            }
+            
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                handle_readable(state, conn);
+            }
+        }
+        
+        long long now = monotonic_ms();
+        if (state->negotiating_count > 0) {
+            check_negotiations(state, now);
+        }
+        if (now >= next_expire) {
+            expire_connections(now);
+            next_expire = now + EXPIRE_INTERVAL_MS;
+        }
+        
+        // 메뉴 전송 및 종료 대상 연결 정리
+        for (int i = 0; i < g_dirty_count; i++) {
+            Connection* conn = &g_connections[g_dirty[i]];
+            conn->dirty = false;
+            if (conn->fd < 0) {
+                continue;
+            }
+            if (!conn->closing) {
+                conn_flush_menu(conn);
+                flush_output(conn);
+                
+                // 출력이 빠졌으면 보관해 둔 이벤트 전송
+                if (conn->events_held != 0 && !conn->want_write) {
+                    conn_flush_events(conn);
+                    flush_output(conn);
+                }
+            }
+            if (conn->closing) {
+                close_connection(state, conn);
+            }
+        }
+        g_dirty_count = 0;
+    }
+    
+    // 모든 연결 종료
+    for (int i = 0; i < MAX_CONNECTIONS; i++) {
+        if (g_connections[i].fd >= 0) {
+            close_connection(state, &g_connections[i]);
+        }
+    }
+    
+    close(g_epoll_fd);
+    g_epoll_fd = -1;
+    free(g_connections);
+    g_connections = NULL;
+    
+    unsigned long dropped = atomic_load(&state->event_queue.dropped);
+    if (dropped > 0) {
+        printf("[Reactor] %lu device events dropped (event queue full)\n", dropped);
+    }
+    printf("[Reactor] Stopped\n");
+    return 0;
+}
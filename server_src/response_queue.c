@@ -0,0 +1,110 @@
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include "server.h"
+
+// 응답 큐 (device lane들 -> reactor)
+// Command Queue와 같은 sequence 슬롯 방식의 링 버퍼이며,
+// 소비자는 eventfd를 poll 하다가 알림을 받으면 큐를 비운다.
+
+#define RESPONSE_MASK (MAX_RESPONSE_QUEUE_SIZE - 1)
+
+_Static_assert((MAX_RESPONSE_QUEUE_SIZE & RESPONSE_MASK) == 0,
+               "MAX_RESPONSE_QUEUE_SIZE must be a power of two");
+
+int response_queue_init(ResponseQueue* queue) {
+    for (unsigned int i = 0; i < MAX_RESPONSE_QUEUE_SIZE; i++) {
+        atomic_init(&queue->slots[i].sequence, i);
+        memset(&queue->slots[i].response, 0, sizeof(CommandResponse));
+    }
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->notify_pending, 0);
+
+    queue->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (queue->event_fd < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+bool response_queue_push(ResponseQueue* queue, const CommandResponse* response) {
+    ResponseSlot* slot;
+    unsigned int pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    for (;;) {
+        slot = &queue->slots[pos & RESPONSE_MASK];
+        unsigned int seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int diff = (int)(seq - pos);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+
+    slot->response = *response;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+
+    // 소비자가 아직 알림을 받지 않은 경우에만 eventfd에 기록
+    if (atomic_exchange_explicit(&queue->notify_pending, 1, memory_order_acq_rel) == 0) {
+        uint64_t one = 1;
+        ssize_t ret = write(queue->event_fd, &one, sizeof(one));
+        (void)ret;
+    }
+
+    return true;
+}
+
+void response_queue_post(ResponseQueue* queue, const CommandResponse* response,
+                         volatile bool* running) {
+    // 응답은 버리지 않는다. 큐가 가득 차면 소비자가 비울 때까지 양보
+    while (!response_queue_push(queue, response)) {
+        if (running && !*running) {
+            return;
+        }
+        sched_yield();
+    }
+}
+
+bool response_queue_pop(ResponseQueue* queue, CommandResponse* response) {
+    unsigned int pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    ResponseSlot* slot = &queue->slots[pos & RESPONSE_MASK];
+    unsigned int seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+
+    if (seq != pos + 1) {
+        return false;
+    }
+
+    *response = slot->response;
+    atomic_store_explicit(&slot->sequence, pos + MAX_RESPONSE_QUEUE_SIZE, memory_order_release);
+    atomic_store_explicit(&queue->tail, pos + 1, memory_order_relaxed);
+
+    return true;
+}
+
+void response_queue_ack(ResponseQueue* queue) {
+    uint64_t count;
+    ssize_t ret = read(queue->event_fd, &count, sizeof(count));
+    (void)ret;
+
+    // 이후 push는 다시 eventfd를 깨운다. 호출자는 ack 후 큐를 끝까지 비워야 한다
+    // (exchange로 마지막 생산자의 push 결과가 보이도록 동기화)
+    atomic_exchange_explicit(&queue->notify_pending, 0, memory_order_acq_rel);
+}
+
+void response_queue_cleanup(ResponseQueue* queue) {
+    if (queue->event_fd >= 0) {
+        close(queue->event_fd);
+        queue->event_fd = -1;
+    }
+}
@@ -0,0 +1,182 @@
+#include <string.h>
+#include "server.h"
+
+// 센서 시계열 저장소
+// - 원시 / 초 / 분 세 단계를 모두 고정 크기 배열로 두고, 추가는 단계마다 슬롯 하나만 고친다 (O(1)).
+// - 초 / 분 버킷은 "시각 / 버킷 길이"를 슬롯 수로 나눈 나머지 자리에 두고, 버킷 번호가 다르면
+//   오래된 버킷으로 보고 새로 시작한다. 그래서 샘플이 끊겼던 구간은 조회 시 그냥 건너뛴다.
+// - writer는 샘플러 스레드 하나뿐이라 sequence를 CAS 없이 올리고,
+//   reader(reactor)는 잠금 없이 계산한 뒤 sequence가 그대로인지 확인한다.
+
+#define RAW_MASK (HISTORY_RAW_SIZE - 1)
+#define SECOND_MS 1000LL
+#define MINUTE_MS 60000LL
+
+_Static_assert((HISTORY_RAW_SIZE & RAW_MASK) == 0,
+               "HISTORY_RAW_SIZE must be a power of two");
+
+static void bucket_reset(HistoryBucket* bucket) {
+    memset(bucket, 0, sizeof(*bucket));
+    bucket->index = -1;
+}
+
+static void bucket_add(HistoryBucket* bucket, long long index, int raw, int filtered) {
+    if (bucket->index != index) {
+        bucket->index = index;
+        bucket->count = 0;
+        bucket->sum = 0;
+        bucket->bright = 0;
+        bucket->min = (unsigned char)raw;
+        bucket->max = (unsigned char)raw;
+    }
+    
+    bucket->count++;
+    bucket->sum += (unsigned int)raw;
+    bucket->bright += filtered ? 1u : 0u;
+    if (raw < bucket->min) bucket->min = (unsigned char)raw;
+    if (raw > bucket->max) bucket->max = (unsigned char)raw;
+}
+
+void sensor_history_init(SensorHistory* history) {
+    atomic_init(&history->sequence, 0);
+    history->raw_head = 0;
+    memset(history->raw, 0, sizeof(history->raw));
+    
+    for (int i = 0; i < HISTORY_SECOND_SLOTS; i++) {
+        bucket_reset(&history->seconds[i]);
+    }
+    for (int i = 0; i < HISTORY_MINUTE_SLOTS; i++) {
+        bucket_reset(&history->minutes[i]);
+    }
+}
+
+void sensor_history_append(SensorHistory* history, long long now_ms, int raw, int filtered) {
+    long long second = now_ms / SECOND_MS;
+    long long minute = now_ms / MINUTE_MS;
+    unsigned int seq = atomic_load_explicit(&history->sequence, memory_order_relaxed);
+    
+    atomic_store_explicit(&history->sequence, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    
+    HistorySample* sample = &history->raw[history->raw_head & RAW_MASK];
+    sample->timestamp_ms = now_ms;
+    sample->raw = (unsigned char)raw;
+    sample->filtered = (unsigned char)filtered;
+    history->raw_head++;
+    
+    bucket_add(&history->seconds[second % HISTORY_SECOND_SLOTS], second, raw, filtered);
+    bucket_add(&history->minutes[minute % HISTORY_MINUTE_SLOTS], minute, raw, filtered);
+    
+    atomic_store_explicit(&history->sequence, seq + 2, memory_order_release);
+}
+
+typedef struct {
+    unsigned long count;
+    unsigned long sum;
+    unsigned long bright;
+    int min;
+    int max;
+} Accumulator;
+
+static void accumulate(Accumulator* acc, unsigned long count, unsigned long sum,
+                       unsigned long bright, int min, int max) {
+    if (acc->count == 0 || min < acc->min) acc->min = min;
+    if (acc->count == 0 || max > acc->max) acc->max = max;
+    acc->count += count;
+    acc->sum += sum;
+    acc->bright += bright;
+}
+
+// [from, to] 구간을 덮는 버킷만 합친다 (구간 양 끝의 버킷은 통째로 포함)
+static void accumulate_buckets(const HistoryBucket* buckets, int slots, long long bucket_ms,
+                               long long from_ms, long long to_ms, long long latest,
+                               Accumulator* acc) {
+    long long first = from_ms / bucket_ms;
+    long long last = to_ms / bucket_ms;
+    
+    if (first < latest - slots + 1) {
+        first = latest - slots + 1;
+    }
+    if (last > latest) {
+        last = latest;
+    }
+    
+    for (long long index = first; index <= last; index++) {
+        const HistoryBucket* bucket = &buckets[index % slots];
+        if (bucket->index == index && bucket->count > 0) {
+            accumulate(acc, bucket->count, bucket->sum, bucket->bright, bucket->min, bucket->max);
+        }
+    }
+}
+
+static HistoryTier query_once(SensorHistory* history, long long from_ms, long long to_ms,
+                              Accumulator* acc) {
+    unsigned long long head = history->raw_head;
+    unsigned long long stored = head < HISTORY_RAW_SIZE ? head : HISTORY_RAW_SIZE;
+    
+    memset(acc, 0, sizeof(*acc));
+    if (stored == 0) {
+        return HISTORY_TIER_RAW;
+    }
+    
+    long long latest_ms = history->raw[(head - 1) & RAW_MASK].timestamp_ms;
+    long long oldest_ms = history->raw[(head - stored) & RAW_MASK].timestamp_ms;
+    
+    // 원시 샘플이 구간 시작까지 남아 있으면 원시 단계에서 그대로 계산
+    if (from_ms >= oldest_ms) {
+        for (unsigned long long pos = head; pos > head - stored; pos--) {
+            const HistorySample* sample = &history->raw[(pos - 1) & RAW_MASK];
+            if (sample->timestamp_ms < from_ms) {
+                break;
+            }
+            if (sample->timestamp_ms <= to_ms) {
+                accumulate(acc, 1, sample->raw, sample->filtered, sample->raw, sample->raw);
+            }
+        }
+        return HISTORY_TIER_RAW;
+    }
+    
+    long long latest_second = latest_ms / SECOND_MS;
+    if (from_ms / SECOND_MS > latest_second - HISTORY_SECOND_SLOTS) {
+        accumulate_buckets(history->seconds, HISTORY_SECOND_SLOTS, SECOND_MS,
+                           from_ms, to_ms, latest_second, acc);
+        return HISTORY_TIER_SECOND;
+    }
+    
+    accumulate_buckets(history->minutes, HISTORY_MINUTE_SLOTS, MINUTE_MS,
+                       from_ms, to_ms, latest_ms / MINUTE_MS, acc);
+    return HISTORY_TIER_MINUTE;
+}
+
+bool sensor_history_query(SensorHistory* history, long long from_ms, long long to_ms,
+                          HistoryStats* stats) {
+    Accumulator acc;
+    HistoryTier tier;
+    
+    for (;;) {
+        unsigned int begin = atomic_load_explicit(&history->sequence, memory_order_acquire);
+        
+        if (begin & 1) {
+            continue;
+        }
+        
+        tier = query_once(history, from_ms, to_ms, &acc);
+        atomic_thread_fence(memory_order_acquire);
+        
+        if (atomic_load_explicit(&history->sequence, memory_order_relaxed) == begin) {
+            break;
+        }
+    }
+    
+    if (acc.count == 0) {
+        return false;
+    }
+    
+    stats->tier = tier;
+    stats->samples = acc.count;
+    stats->min = acc.min;
+    stats->max = acc.max;
+    stats->mean = (double)acc.sum / (double)acc.count;
+    stats->duty_cycle = (double)acc.bright / (double)acc.count;
+    return true;
+}
@@ -9,18 +9,38 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <ifaddrs.h>
-#include <wiringPi.h>
+#include <time.h>
+#include "gpio_hal.h"
 #include "server.h"
 
 static LedPin led_pin = {.pin = 12};
 static LightSensorPin sensor_pin = {.pin = 11}; 
-static Seg7Pins seg7_pins = {
-    .pin_a = 14,
-    .pin_b = 15,
-    .pin_c = 18,
-    .pin_d = 23 
+static Seg7Config seg7_config = {
+    .bcd = {
+        .pin_a = 14,
+        .pin_b = 15,
+        .pin_c = 18,
+        .pin_d = 23
+    },
+    .digit_count = 1,
+    .colon_pin = -1
 };
 static const int buzzer_pin = 21;
+static const char* gpio_backend_name = NULL;   // NULL = GPIO_BACKEND 환경 변수 또는 기본값
+
+// 단조 시계 (ms)
+long long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// 벽시계 (epoch ms, 이벤트 타임스탬프용)
+long long realtime_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
 
 // IP 주소 가져오기
 int get_server_ip(char* ip_buffer, size_t buffer_size) {
@@ -147,15 +167,54 @@ void stop_web_server(pid_t pid) {
     }
 }
 
+// "pin,pin,...[:colon]" (왼쪽 자리부터). server_init 전에 호출
+int server_set_segment_digits(const char* spec, int refresh_hz) {
+    Seg7Config config = seg7_config;
+    const char* p = spec;
+    char* end;
+    
+    config.digit_count = 0;
+    config.colon_pin = -1;
+    config.refresh_hz = refresh_hz;
+    
+    while (*p != '\0' && *p != ':') {
+        long pin = strtol(p, &end, 10);
+        if (end == p || pin < 0 || pin > 63 || config.digit_count == SEG7_MAX_DIGITS) {
+            return -1;
+        }
+        config.digit_pins[config.digit_count++] = (int)pin;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    
+    if (*p == ':') {
+        long pin = strtol(p + 1, &end, 10);
+        if (end == p + 1 || *end != '\0' || pin < 0 || pin > 63) {
+            return -1;
+        }
+        config.colon_pin = (int)pin;
+    }
+    
+    if (config.digit_count < 1) {
+        return -1;
+    }
+    
+    seg7_config = config;
+    return 0;
+}
+
+void server_set_gpio_backend(const char* name) {
+    gpio_backend_name = name;
+}
+
 int server_init(ServerState* state) {
     memset(state, 0, sizeof(ServerState));
     
-    // wiringPi 초기화 (GPIO 모드)
-    if (wiringPiSetupGpio() == -1) {
-        fprintf(stderr, "Failed to initialize wiringPi\n");
+    // GPIO 초기화 (BCM 번호)
+    if (gpio_init(gpio_backend_name) != 0) {
+        fprintf(stderr, "Failed to initialize GPIO\n");
         return -1;
     }
-    printf("✓ wiringPi initialized\n");
+    printf("✓ GPIO initialized (backend: %s)\n", gpio_backend());
     
     // IP 주소 가져오기
     if (get_server_ip(state->server_ip, sizeof(state->server_ip)) == 0) {
@@ -165,34 +224,24 @@ int server_init(ServerState* state) {
         strcpy(state->server_ip, "localhost");
     }
     
-    // Queue 초기화
-    queue_init(&state->cmd_queue);
-    
-    // Mutex 초기화
-    if (pthread_mutex_init(&state->queue_mutex, NULL) != 0) {
-        fprintf(stderr, "Failed to initialize queue mutex\n");
-        return -1;
-    }
-    
-    if (pthread_mutex_init(&state->state_mutex, NULL) != 0) {
-        fprintf(stderr, "Failed to initialize state mutex\n");
-        pthread_mutex_destroy(&state->queue_mutex);
+    // Queue 초기화 (디바이스 lane별 Command Queue + 공용 Response / Event Queue)
+    if (device_lanes_init(state) != 0) {
+        gpio_cleanup();
         return -1;
     }
     
-    // Condition Variable 초기화
-    if (pthread_cond_init(&state->queue_not_empty, NULL) != 0) {
-        fprintf(stderr, "Failed to initialize queue_not_empty condition\n");
-        pthread_mutex_destroy(&state->queue_mutex);
-        pthread_mutex_destroy(&state->state_mutex);
+    if (response_queue_init(&state->resp_queue) != 0) {
+        fprintf(stderr, "Failed to initialize response queue\n");
+        device_lanes_cleanup(state);
+        gpio_cleanup();
         return -1;
     }
     
-    if (pthread_cond_init(&state->response_ready, NULL) != 0) {
-        fprintf(stderr, "Failed to initialize response_ready condition\n");
-        pthread_cond_destroy(&state->queue_not_empty);
-        pthread_mutex_destroy(&state->queue_mutex);
-        pthread_mutex_destroy(&state->state_mutex);
+    if (event_queue_init(&state->event_queue) != 0) {
+        fprintf(stderr, "Failed to initialize event queue\n");
+        response_queue_cleanup(&state->resp_queue);
+        device_lanes_cleanup(state);
+        gpio_cleanup();
         return -1;
     }
     
@@ -200,12 +249,13 @@ int server_init(ServerState* state) {
     printf("Initializing devices...\n");
     
     // 7-Segment 초기화
-    if (seg7_init(&seg7_pins) != 0) {
+    if (seg7_init_multi(&seg7_config) != 0) {
         fprintf(stderr, "Failed to initialize 7-segment\n");
         goto cleanup_sync;
     }
-    printf("✓ 7-Segment initialized (pins: A=%d, B=%d, C=%d, D=%d)\n",
-           seg7_pins.pin_a, seg7_pins.pin_b, seg7_pins.pin_c, seg7_pins.pin_d);
+    printf("✓ 7-Segment initialized (pins: A=%d, B=%d, C=%d, D=%d, digits: %d, max countdown: %ds)\n",
+           seg7_config.bcd.pin_a, seg7_config.bcd.pin_b, seg7_config.bcd.pin_c,
+           seg7_config.bcd.pin_d, seg7_config.digit_count, seg7_max_count());
     
     // Buzzer 초기화
     if (music_init(buzzer_pin) != 0) {
@@ -279,15 +329,14 @@ int server_init(ServerState* state) {
     }
     
     // 리슨
-    if (listen(state->server_socket, 1) < 0) {
+    if (listen(state->server_socket, SOMAXCONN) < 0) {
         perror("listen");
         close(state->server_socket);
         goto cleanup_devices;
     }
     
     state->server_running = true;
-    state->client_socket = -1;
-    state->client_connected = false;
+    state->connection_count = 0;
     state->web_server_pid = -1;
     
     printf("\n=== Server initialized successfully ===\n");
@@ -303,10 +352,10 @@ cleanup_devices:
     seg7_cleanup();
     
 cleanup_sync:
-    pthread_cond_destroy(&state->response_ready);
-    pthread_cond_destroy(&state->queue_not_empty);
-    pthread_mutex_destroy(&state->state_mutex);
-    pthread_mutex_destroy(&state->queue_mutex);
+    response_queue_cleanup(&state->resp_queue);
+    device_lanes_cleanup(state);
+    event_queue_cleanup(&state->event_queue);
+    gpio_cleanup();
     
     return -1;
 }
@@ -316,16 +365,8 @@ void server_cleanup(ServerState* state) {
     
     state->server_running = false;
     
-    // 스레드 종료 대기
-    if (state->client_connected) {
-        pthread_cond_signal(&state->queue_not_empty);
-        pthread_cond_signal(&state->response_ready);
-        
-        pthread_join(state->comm_thread, NULL);
-    }
-    
-    pthread_cond_signal(&state->queue_not_empty);
-    pthread_join(state->device_thread, NULL);
+    // 스레드 종료 대기 (클라이언트 연결은 reactor가 종료 시 모두 닫는다)
+    device_lanes_stop(state);
     
     // 웹 서버 종료
     if (state->web_server_pid > 0) {
@@ -333,15 +374,14 @@ void server_cleanup(ServerState* state) {
     }
     
     // 소켓 종료
-    if (state->client_socket >= 0) {
-        close(state->client_socket);
-    }
     if (state->server_socket >= 0) {
         close(state->server_socket);
     }
     
-    // Command Queue 정리
-    queue_cleanup(&state->cmd_queue);
+    // Command Queue / Response Queue / Event Queue 정리
+    device_lanes_cleanup(state);
+    response_queue_cleanup(&state->resp_queue);
+    event_queue_cleanup(&state->event_queue);
     
     // 디바이스 정리
     printf("Cleaning up devices...\n");
@@ -349,12 +389,7 @@ void server_cleanup(ServerState* state) {
     led_cleanup();
     music_cleanup();
     seg7_cleanup();
-    
-    // 동기화 객체 정리
-    pthread_cond_destroy(&state->response_ready);
-    pthread_cond_destroy(&state->queue_not_empty);
-    pthread_mutex_destroy(&state->state_mutex);
-    pthread_mutex_destroy(&state->queue_mutex);
+    gpio_cleanup();
     
     printf("Server cleanup completed\n");
 }
@@ -3,16 +3,39 @@
 
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <signal.h>
 #include <sys/types.h>
 #include "led.h"
 #include "buzzer.h"
 #include "light_sensor.h"
+#include "light_sampler.h"
 #include "7segment.h"
 
 #define SERVER_PORT 8080
 #define WEB_SERVER_PORT 8000
-#define MAX_QUEUE_SIZE 100
+#define MAX_QUEUE_SIZE 1024         // 2의 거듭제곱이어야 함
+#define PRIORITY_STARVATION_LIMIT 8 // 긴급 명령 연속 처리 후 일반 명령 하나 처리
+#define MAX_RESPONSE_QUEUE_SIZE 1024
+#define MAX_INFLIGHT 64             // 연결당 동시에 처리 중인 명령 수
+#define COMMAND_TIMEOUT_MS 5000
+#define MAX_CONNECTIONS 512
+#define CONN_INDEX_BITS 10          // conn_id 하위 비트 = 연결 테이블 인덱스
+#define OUTPUT_BUFFER_SIZE 8192
+#define CACHE_LINE_SIZE 64
+#define INTERNAL_CONN_ID 0          // 서버 내부에서 만든 명령 (응답을 보내지 않음)
+#define SENSOR_POLL_INTERVAL_MS 1000 // 센서 인터럽트를 쓸 수 없을 때만 폴링
+#define SENSOR_SAMPLE_RATE_HZ LIGHT_SAMPLER_DEFAULT_RATE_HZ // 0이면 샘플러 없이 에지 인터럽트 사용
+#define MELODY_DIR "../buzzer/melodies"  // 시작할 때 읽는 멜로디 파일 디렉토리 (*.mel)
+#define LED_COALESCE_MAX 32         // LED lane에서 한 번에 합치는 최대 명령 수
+#define MAX_BATCHES 64              // 동시에 대기/실행 중인 batch 수
+#define MAX_BATCH_COMMANDS 8        // batch 하나에 담을 수 있는 명령 수
 #define BUFFER_SIZE 1024
+#define INPUT_BUFFER_SIZE 1024      // 연결별 미처리 입력 (완성되지 않은 줄 / 바이너리 프레임), 최대 줄 길이
+#define HANDSHAKE_WINDOW_MS 100     // 접속 후 바이너리 모드 핸드셰이크를 기다리는 시간
+#define MAX_EVENT_QUEUE_SIZE 256    // 2의 거듭제곱이어야 함
+#define EVENT_BACKLOG_BYTES (OUTPUT_BUFFER_SIZE / 2)   // 출력이 이만큼 밀리면 이벤트를 합친다
 #define WEB_SERVER_SCRIPT_PATH "./web_server/web_server.py"
 #define DAEMON_PID_FILE "/var/run/iot_server.pid"
 #define DAEMON_LOG_FILE "/var/log/iot_server.log"
@@ -28,7 +51,12 @@ typedef enum {
     CMD_SENSOR_OFF = 7,
     CMD_SEGMENT_DISPLAY = 8,
     CMD_SEGMENT_STOP = 9,
-    CMD_EXIT = 0
+    CMD_SUBSCRIBE = 10,         // param1 = 구독할 디바이스 마스크 (EVENT_MASK_*, 0이면 해제)
+    CMD_STATUS = 11,            // 디바이스 상태 조회 (큐를 거치지 않고 reactor가 바로 응답)
+    CMD_SENSOR_HISTORY = 12,    // param1 = 조회 구간 길이 (초), param2 = 구간 끝이 몇 초 전인지 (0 = 지금)
+    CMD_MUSIC_LIST = 13,        // 재생할 수 있는 곡 목록 (reactor가 바로 응답)
+    CMD_EXIT = 0,
+    CMD_BATCH = 100             // 내부용: param1 = batch pool 인덱스
 } CommandType;
 
 // 명령 구조체
@@ -36,65 +64,417 @@ typedef struct {
     CommandType type;
     int param1;
     int param2;
+    uint32_t request_id;    // 요청 ID (응답과 짝을 맞추기 위함)
+    uint32_t conn_id;       // 요청한 연결
 } Command;
 
+// 응답 상태 코드 (바이너리 응답 프레임에 그대로 실린다)
+typedef enum {
+    STATUS_OK = 0,
+    STATUS_FAILED = -1,         // 디바이스 실행 실패 / 잘못된 값
+    STATUS_TIMEOUT = -2,
+    STATUS_BUSY = -3,           // 같은 완료 슬롯의 요청이 처리 중
+    STATUS_QUEUE_FULL = -4,
+    STATUS_INVALID = -5         // 알 수 없는 명령 / 형식 오류
+} ResponseStatus;
+
+// 바이너리 프로토콜
+#define BINARY_MAGIC "RSVPBIN1"
+#define BINARY_MAGIC_LEN 8
+#define BINARY_VERSION 1
+#define BINARY_COMMAND_FRAME_SIZE 16
+#define BINARY_RESPONSE_FRAME_SIZE 12
+#define BINARY_EVENT_ID 0xFFFFFFFFu     // 이벤트 프레임 표시 (요청 ID로 사용하지 않음)
+#define BINARY_EVENT_FRAME_SIZE 20
+
 // 응답 구조체
 typedef struct {
+    uint32_t request_id;
+    uint32_t conn_id;
     int status;
     char message[256];
     int value;
 } CommandResponse;
 
-// Command Queue
+// 디바이스 상태 변화 이벤트 (구독한 연결로 비동기 전송)
+typedef enum {
+    EVENT_DEVICE_LED,
+    EVENT_DEVICE_BUZZER,
+    EVENT_DEVICE_SEGMENT,
+    EVENT_DEVICE_SENSOR,
+    EVENT_DEVICE_COUNT
+} EventDevice;
+
+#define EVENT_MASK_ALL ((1 << EVENT_DEVICE_COUNT) - 1)
+
+typedef enum {
+    EVENT_LED_ON = 1,           // value = 밝기
+    EVENT_LED_OFF,
+    EVENT_LED_BRIGHTNESS,       // value = 밝기
+    EVENT_MUSIC_STARTED,        // value = 곡 번호
+    EVENT_MUSIC_FINISHED,       // value = 곡 번호
+    EVENT_MUSIC_STOPPED,        // value = 곡 번호
+    EVENT_COUNTDOWN_STARTED,    // value = 시작 초
+    EVENT_COUNTDOWN_STOPPED,
+    EVENT_COUNTDOWN_FINISHED,
+    EVENT_SENSOR_MONITOR_ON,
+    EVENT_SENSOR_MONITOR_OFF,
+    EVENT_LIGHT_DETECTED,
+    EVENT_DARK_DETECTED
+} EventType;
+
 typedef struct {
-    Command* commands[MAX_QUEUE_SIZE];
-    int front;
-    int rear;
-    int count;
-} CommandQueue;
+    EventType type;
+    int value;
+    long long timestamp_ms;     // 발생 시각 (CLOCK_REALTIME, epoch ms)
+} DeviceEvent;
 
-// 서버 상태
+// 디바이스 상태
 typedef struct {
-    // Command Queue
-    CommandQueue cmd_queue;
-    
-    // 동기화 객체
-    pthread_mutex_t queue_mutex;
-    pthread_mutex_t state_mutex;
-    pthread_cond_t queue_not_empty;
-    pthread_cond_t response_ready;
-    
-    // 디바이스 상태
     bool led_on;
     int led_brightness;
     bool buzzer_playing;
+    int music_number;               // 재생 중이거나 마지막으로 재생한 곡
     bool sensor_monitoring;
+    int sensor_value;               // 마지막 측정값 (1 = 밝음, 0 = 어두움, -1 = 측정 전)
     bool segment_counting;
+    int countdown_start;            // 카운트다운 시작 초
+    long long countdown_started_ms; // 카운트다운 시작 시각 (monotonic)
+} DeviceStatus;
+
+// 바이너리 STATUS 응답의 value 비트 구성
+#define STATUS_BIT_LED_ON         (1 << 0)
+#define STATUS_BIT_BUZZER_PLAYING (1 << 1)
+#define STATUS_BIT_SENSOR_ON      (1 << 2)
+#define STATUS_BIT_BRIGHT         (1 << 3)
+#define STATUS_BIT_SENSOR_VALID   (1 << 4)
+#define STATUS_BIT_COUNTING       (1 << 5)
+#define STATUS_SHIFT_BRIGHTNESS   8     // 4 bits
+#define STATUS_SHIFT_MUSIC        12    // 4 bits (곡 번호 하위 4비트)
+#define STATUS_SHIFT_REMAINING    16    // 4 bits (남은 초 하위 4비트)
+#define STATUS_SHIFT_MUSIC_HIGH   20    // 4 bits (곡 번호 상위 4비트, 16번 이상의 곡)
+#define STATUS_SHIFT_REMAINING_HIGH 24  // 8 bits (남은 초 상위 8비트, 4095초를 넘으면 4095)
+#define STATUS_REMAINING_MAX      0xFFF
+
+// 디바이스 상태 저장소 (seqlock: 홀수 sequence = 쓰는 중)
+// writer는 device_state_begin_write / end_write 사이에서만 고치고,
+// reader는 device_state_read로 잠금 없이 일관된 복사본을 얻는다.
+// 캐시 라인 하나를 통째로 차지해 주변 필드와 false sharing이 생기지 않는다.
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_uint sequence;
+    DeviceStatus current;
+} DeviceState;
+
+// 센서 시계열 저장소 (고정 크기: 가동 시간이 길어져도 메모리가 늘지 않는다)
+#define HISTORY_RAW_SIZE        4096    // 원시 샘플 (2의 거듭제곱, 100Hz에서 약 40초)
+#define HISTORY_SECOND_SLOTS    3600    // 초 단위 버킷 (1시간)
+#define HISTORY_MINUTE_SLOTS    10080   // 분 단위 버킷 (7일)
+#define HISTORY_MAX_WINDOW_SEC  (HISTORY_MINUTE_SLOTS * 60)
+
+typedef struct {
+    long long timestamp_ms;         // CLOCK_REALTIME (epoch ms)
+    unsigned char raw;              // 원시 값 (1 = 밝음)
+    unsigned char filtered;         // 필터를 거친 상태 (1 = 밝음)
+} HistorySample;
+
+typedef struct {
+    long long index;                // 버킷 번호 (epoch ms / 버킷 길이). 다르면 빈 버킷
+    unsigned int count;
+    unsigned int sum;               // 원시 값 합
+    unsigned int bright;            // 필터 상태가 밝음이었던 샘플 수
+    unsigned char min;
+    unsigned char max;
+} HistoryBucket;
+
+typedef enum {
+    HISTORY_TIER_RAW = 0,
+    HISTORY_TIER_SECOND,
+    HISTORY_TIER_MINUTE
+} HistoryTier;
+
+// 구간 조회 결과
+typedef struct {
+    HistoryTier tier;               // 구간을 덮는 가장 촘촘한 단계
+    unsigned long samples;
+    int min;
+    int max;
+    double mean;                    // 원시 값 평균
+    double duty_cycle;              // 필터 상태가 밝음이었던 비율
+} HistoryStats;
+
+// writer는 샘플러 스레드 하나, reader는 sequence로 일관성을 확인한다 (seqlock)
+typedef struct {
+    atomic_uint sequence;
+    unsigned long long raw_head;    // 누적 원시 샘플 수
+    HistorySample raw[HISTORY_RAW_SIZE];
+    HistoryBucket seconds[HISTORY_SECOND_SLOTS];
+    HistoryBucket minutes[HISTORY_MINUTE_SLOTS];
+} SensorHistory;
+
+// 바이너리 SENSOR_HISTORY 응답의 value 비트 구성
+#define HISTORY_SHIFT_MEAN      0       // 10 bits (평균 x 1000)
+#define HISTORY_SHIFT_DUTY      10      // 10 bits (duty cycle x 1000)
+#define HISTORY_SHIFT_MIN       20      // 4 bits
+#define HISTORY_SHIFT_MAX       24      // 4 bits
+#define HISTORY_SHIFT_TIER      28      // 2 bits (HistoryTier)
+
+// Command Queue 슬롯
+typedef struct {
+    atomic_uint sequence;
+    Command command;
+} QueueSlot;
+
+// 명령 우선순위 (stop/abort 명령은 일반 명령보다 먼저 처리)
+typedef enum {
+    PRIORITY_URGENT,
+    PRIORITY_NORMAL,
+    PRIORITY_COUNT
+} CommandPriority;
+
+// lock-free 링 버퍼 (다중 생산자 / 단일 소비자)
+typedef struct {
+    QueueSlot slots[MAX_QUEUE_SIZE];
+    _Alignas(CACHE_LINE_SIZE) atomic_uint head;     // 생산자 위치
+    _Alignas(CACHE_LINE_SIZE) atomic_uint tail;     // 소비자 위치
+} CommandRing;
+
+// Command Queue (우선순위별 링 버퍼)
+typedef struct {
+    CommandRing rings[PRIORITY_COUNT];
+    int urgent_streak;          // 연속으로 처리한 긴급 명령 수 (소비자만 접근)
     
-    // 응답 데이터
+    // 소비자 대기용 (큐가 비었을 때만 사용)
+    _Alignas(CACHE_LINE_SIZE) atomic_int waiting;
+    pthread_mutex_t wait_mutex;
+    pthread_cond_t not_empty;
+    bool closed;                // queue_close 이후 (wait_mutex로 보호)
+} CommandQueue;
+
+// Response Queue 슬롯
+typedef struct {
+    atomic_uint sequence;
     CommandResponse response;
+} ResponseSlot;
+
+// Response Queue (device lane -> reactor, eventfd로 알림)
+typedef struct {
+    ResponseSlot slots[MAX_RESPONSE_QUEUE_SIZE];
+    _Alignas(CACHE_LINE_SIZE) atomic_uint head;
+    _Alignas(CACHE_LINE_SIZE) atomic_uint tail;
+    _Alignas(CACHE_LINE_SIZE) atomic_int notify_pending;
+    int event_fd;
+} ResponseQueue;
+
+// Event Queue 슬롯
+typedef struct {
+    atomic_uint sequence;
+    DeviceEvent event;
+} EventSlot;
+
+// Event Queue (디바이스 스레드 -> reactor, eventfd로 알림)
+// 디바이스 스레드가 막히지 않도록 가득 차면 기다리지 않고 버린다.
+typedef struct {
+    EventSlot slots[MAX_EVENT_QUEUE_SIZE];
+    _Alignas(CACHE_LINE_SIZE) atomic_uint head;
+    _Alignas(CACHE_LINE_SIZE) atomic_uint tail;
+    _Alignas(CACHE_LINE_SIZE) atomic_int notify_pending;
+    atomic_ulong dropped;
+    int event_fd;
+} EventQueue;
+
+// 디바이스 실행 lane
+// 디바이스마다 큐와 worker 스레드를 따로 두어 느린 디바이스가 다른 디바이스를 막지 않는다.
+// 명령 순서는 같은 lane(디바이스) 안에서만 보장된다.
+// Batch lane은 batch가 사용하는 디바이스 lane의 exec_mutex를 모두 잡고 명령을 순서대로 실행한다.
+typedef enum {
+    LANE_LED,
+    LANE_BUZZER,
+    LANE_SEGMENT,
+    LANE_SENSOR,
+    LANE_BATCH,
+    LANE_COUNT
+} LaneId;
+
+// 여러 명령을 한 번에 실행하는 batch (고정 크기 pool)
+typedef struct {
+    atomic_bool in_use;
+    int count;
+    Command commands[MAX_BATCH_COMMANDS];
+} CommandBatch;
+
+struct ServerState;
+
+typedef struct {
+    LaneId id;
+    const char* name;
+    CommandQueue queue;
+    pthread_mutex_t exec_mutex;     // 디바이스 실행 중 보유 (batch와의 상호 배제)
+    pthread_t thread;
+    bool started;
+    struct ServerState* state;
+} DeviceLane;
+
+// 처리 중인 요청 (완료 슬롯)
+typedef struct {
+    bool in_use;
+    uint32_t request_id;
+    long long deadline_ms;
+} InflightSlot;
+
+// 연결 프로토콜 모드
+typedef enum {
+    CONN_MODE_NEGOTIATE,        // 접속 직후 핸드셰이크 대기
+    CONN_MODE_TEXT,
+    CONN_MODE_BINARY
+} ConnMode;
+
+// 연결 상태 (대화형 프롬프트 응답 대기 포함)
+typedef enum {
+    CONN_STATE_COMMAND,
+    CONN_STATE_AWAIT_BRIGHTNESS,
+    CONN_STATE_AWAIT_MUSIC,
+    CONN_STATE_AWAIT_COUNTDOWN
+} ConnState;
+
+// 클라이언트 연결 (reactor 스레드만 접근)
+typedef struct {
+    int fd;
+    uint32_t conn_id;           // (세대 << CONN_INDEX_BITS) | 테이블 인덱스
+    ConnMode mode;
+    long long negotiate_deadline_ms;
+    ConnState state;
+    Command pending_cmd;        // 프롬프트 응답을 기다리는 명령
+    bool closing;
+    bool want_write;            // EPOLLOUT 등록 여부
+    bool dirty;                 // 이번 이벤트 루프에서 처리 대상
+    
+    uint32_t next_request_id;
+    int inflight_count;
+    bool menu_pending;
+    InflightSlot inflight[MAX_INFLIGHT];
+    
+    // 아직 처리하지 못한 입력
+    char in_buf[INPUT_BUFFER_SIZE];
+    size_t in_len;
+    bool discarding;            // 너무 긴 줄을 다음 개행까지 버리는 중
+    
+    // 이벤트 구독 (출력이 밀린 동안은 디바이스별 최신 이벤트만 보관)
+    unsigned int event_mask;
+    unsigned int events_held;
+    DeviceEvent held_events[EVENT_DEVICE_COUNT];
+    unsigned int events_coalesced[EVENT_DEVICE_COUNT];
+    
+    // 아직 보내지 못한 출력
+    char out_buf[OUTPUT_BUFFER_SIZE];
+    size_t out_len;
+} Connection;
+
+// 서버 상태
+typedef struct ServerState {
+    // 디바이스별 Command Queue / 공용 Response Queue
+    DeviceLane lanes[LANE_COUNT];
+    CommandBatch batches[MAX_BATCHES];
+    ResponseQueue resp_queue;
+    EventQueue event_queue;
+    
+    // 디바이스 상태 (device_state_* 함수로만 접근)
+    DeviceState device;
+    
+    // 센서 시계열 (감시 중에 샘플러가 돌 때만 쌓인다)
+    SensorHistory history;
+    
+    bool led_coalescing;                // LED 명령 coalescing 사용 여부
+    atomic_ulong led_commands;          // LED lane이 처리한 명령 수
+    atomic_ulong led_writes_elided;     // coalescing으로 생략된 하드웨어 쓰기 수
+    int sensor_rate_hz;                 // 감시 중 센서 샘플링 주기 (0이면 샘플러 사용 안 함)
+    const char* melody_dir;             // 멜로디 파일 디렉토리 (없으면 내장 곡만)
+    bool sensor_sampler;                // 감시하는 동안 샘플러의 필터 상태로 LED 제어
+    bool sensor_sampling;               // 샘플러가 도는 중 (Sensor lane만 바꾼다)
+    bool sensor_interrupts;             // 센서 에지 인터럽트 사용 여부 (false면 Sensor lane이 폴링)
     
     // 서버 상태
     bool server_running;
     int server_socket;
-    int client_socket;
-    bool client_connected;
+    int connection_count;
+    int negotiating_count;      // 핸드셰이크 대기 중인 연결 수 (reactor만 접근)
+    int subscriber_count;       // 이벤트를 구독 중인 연결 수 (reactor만 접근)
     
     // 웹 서버
     pid_t web_server_pid;
     char server_ip[64];
     
-    // 스레드
-    pthread_t comm_thread;
-    pthread_t device_thread;
-    
 } ServerState;
 
 // 함수 선언
+int server_set_segment_digits(const char* spec, int refresh_hz);
+void server_set_gpio_backend(const char* name);
 int server_init(ServerState* state);
 void server_cleanup(ServerState* state);
-void* communication_thread(void* arg);
-void* device_control_thread(void* arg);
+long long monotonic_ms(void);
+long long realtime_ms(void);
+
+// 디바이스 lane
+int device_lanes_init(ServerState* state);
+int device_lanes_start(ServerState* state);
+void device_lanes_stop(ServerState* state);
+void device_lanes_cleanup(ServerState* state);
+int command_lane(CommandType type);
+CommandPriority command_priority(CommandType type);
+void device_execute(ServerState* state, Command* cmd, CommandResponse* response);
+bool device_submit(ServerState* state, const Command* cmd);
+bool device_submit_batch(ServerState* state, const Command* commands, int count,
+                         uint32_t request_id, uint32_t conn_id);
+
+// 디바이스 상태 저장소
+void device_state_init(DeviceState* ds);
+DeviceStatus* device_state_begin_write(DeviceState* ds);
+void device_state_end_write(DeviceState* ds);
+void device_state_read(DeviceState* ds, DeviceStatus* status);
+
+// 센서 시계열 저장소
+void sensor_history_init(SensorHistory* history);
+void sensor_history_append(SensorHistory* history, long long now_ms, int raw, int filtered);
+bool sensor_history_query(SensorHistory* history, long long from_ms, long long to_ms,
+                          HistoryStats* stats);
+
+// Reactor (epoll 이벤트 루프)
+int reactor_run(ServerState* state, volatile sig_atomic_t* running);
+bool conn_send(Connection* conn, const char* data, size_t len);
+
+// 연결별 프로토콜 처리
+void conn_open(ServerState* state, Connection* conn);
+bool conn_process_input(ServerState* state, Connection* conn, char* data, size_t len);
+void conn_deliver_response(Connection* conn, const CommandResponse* response);
+void conn_expire_inflight(Connection* conn, long long now_ms);
+void conn_flush_menu(Connection* conn);
+void conn_check_negotiation(ServerState* state, Connection* conn, long long now_ms);
+void conn_closed(ServerState* state, Connection* conn);
+void conn_deliver_event(Connection* conn, const DeviceEvent* event);
+void conn_flush_events(Connection* conn);
+
+// 프로토콜 인코딩/디코딩
+bool protocol_parse_int(const char** buffer, int* value);
+bool protocol_parse_request_id(const char** buffer, uint32_t* request_id, bool* has_id);
+bool protocol_parse_command(const char* buffer, Command* cmd);
+bool protocol_parse_name(const char** buffer, char* name, size_t size);
+int protocol_format_response(const CommandResponse* response, char* buffer, size_t size);
+void protocol_decode_command(const uint8_t* frame, Command* cmd);
+void protocol_encode_command(const Command* cmd, uint8_t* frame);
+void protocol_encode_response(const CommandResponse* response, uint8_t* frame);
+void protocol_decode_response(const uint8_t* frame, CommandResponse* response);
+int protocol_format_status(const DeviceStatus* status, long long now_ms,
+                           char* buffer, size_t size);
+int protocol_status_value(const DeviceStatus* status, long long now_ms);
+int protocol_format_history(const HistoryStats* stats, int window_sec,
+                            char* buffer, size_t size);
+int protocol_history_value(const HistoryStats* stats);
+int protocol_format_music_list(const MusicInfo* infos, int count, char* buffer, size_t size);
+EventDevice event_device(EventType type);
+const char* event_device_name(EventDevice device);
+const char* event_type_name(EventType type);
+int protocol_format_event(const DeviceEvent* event, unsigned int coalesced,
+                          char* buffer, size_t size);
+void protocol_encode_event(const DeviceEvent* event, uint8_t* frame);
 
 // 웹 서버 관련
 pid_t start_web_server(int port);
@@ -108,10 +488,30 @@ int remove_pid_file(const char* pidfile);
 void redirect_output_to_log(const char* logfile);
 
 // Command Queue 함수
-void queue_init(CommandQueue* queue);
-bool queue_push(CommandQueue* queue, Command* cmd);
-Command* queue_pop(CommandQueue* queue);
+int queue_init(CommandQueue* queue);
+bool queue_push(CommandQueue* queue, const Command* cmd);
+bool queue_push_priority(CommandQueue* queue, const Command* cmd, CommandPriority priority);
+bool queue_pop(CommandQueue* queue, Command* cmd);
 bool queue_is_empty(CommandQueue* queue);
+bool queue_wait(CommandQueue* queue, int timeout_ms);
+void queue_wakeup(CommandQueue* queue);
+void queue_close(CommandQueue* queue);
 void queue_cleanup(CommandQueue* queue);
 
+// Response Queue 함수
+int response_queue_init(ResponseQueue* queue);
+bool response_queue_push(ResponseQueue* queue, const CommandResponse* response);
+void response_queue_post(ResponseQueue* queue, const CommandResponse* response,
+                         volatile bool* running);
+bool response_queue_pop(ResponseQueue* queue, CommandResponse* response);
+void response_queue_ack(ResponseQueue* queue);
+void response_queue_cleanup(ResponseQueue* queue);
+
+// Event Queue 함수
+int event_queue_init(EventQueue* queue);
+bool event_queue_push(EventQueue* queue, const DeviceEvent* event);
+bool event_queue_pop(EventQueue* queue, DeviceEvent* event);
+void event_queue_ack(EventQueue* queue);
+void event_queue_cleanup(EventQueue* queue);
+
 #endif // SERVER_H